@@ -544,6 +544,20 @@ MapReadWriteHandle( vtyFileHandle _hFile, uint64_t * _pu64SizeMapping = 0, uint6
 int
 UnmapHandle( vtyMappedMemoryHandle const & _rhmm ) noexcept;
 
+#ifdef __linux__
+// Resize the mapping _rhmm of a file mapped read/write from its start to _stSize bytes - the file must be at least that size.
+// mremap() keeps the pages that have already been faulted in and may move the mapping.
+// On failure a null handle is returned and _rhmm is still mapped.
+inline vtyMappedMemoryHandle
+RemapReadWriteHandle( vtyMappedMemoryHandle const & _rhmm, size_t _stSize ) noexcept
+{
+  void * pvFile = ::mremap( _rhmm.Pv(), _rhmm.length(), _stSize, MREMAP_MAYMOVE );
+  if ( MAP_FAILED == pvFile )
+    return vtyMappedMemoryHandle();
+  return vtyMappedMemoryHandle( pvFile, _stSize );
+}
+#endif //__linux__
+
 // This provides a general usage method that returns a void* and closes all other files and handles, etc. Clean and is a major usage scenario.
 // Return the size of the mapping in _rstSizeMapping.
 // We don't throw here and we don't log - this is meant as a utility method and a black box.
@@ -764,6 +778,40 @@ FileSetSize( vtyFileHandle _hFile, uint64_t _u64Size ) noexcept
 #endif
 }
 
+// Allocate storage for the _u64Len bytes at _u64Offset, at or beyond the end of the file, and grow the file to include them.
+// Writes to that range then won't fail for lack of space. Under Linux this is posix_fallocate(), elsewhere we just set the file size.
+inline int
+FileAllocate( vtyFileHandle _hFile, uint64_t _u64Offset, uint64_t _u64Len ) noexcept
+{
+#ifdef __linux__
+  int iResult = ::posix_fallocate( _hFile, _u64Offset, _u64Len );
+  if ( !!iResult )
+  {
+    errno = iResult; // posix_fallocate() returns the error rather than setting errno.
+    return -1;
+  }
+  return 0;
+#else
+  return FileSetSize( _hFile, _u64Offset + _u64Len );
+#endif
+}
+
+// Flush the file's data (and if !_fDataOnly its metadata) to the storage device.
+// _fDataOnly uses fdatasync() where available - under Mac and Windows there is no distinction and we flush everything.
+inline int
+FileSync( vtyFileHandle _hFile, bool _fDataOnly = false ) noexcept
+{
+#ifdef WIN32
+  (void)_fDataOnly;
+  return FlushFileBuffers( _hFile ) ? 0 : -1;
+#elif defined( __APPLE__ )
+  (void)_fDataOnly;
+  return ::fsync( _hFile );
+#elif defined( __linux__ )
+  return _fDataOnly ? ::fdatasync( _hFile ) : ::fsync( _hFile );
+#endif
+}
+
 // Delete a file.
 inline int
 FileDelete( const char * _pszFileName ) noexcept
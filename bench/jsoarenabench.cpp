@@ -0,0 +1,109 @@
+//          Copyright David Lawrence Bien 1997 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt).
+
+// jsoarenabench.cpp
+// This times parsing and destroying a synthetic ~100MB JSON document into JsoValue trees with std::allocator and with JsoArenaAllocator,
+//  for both the map and the flat object storage policies - and then times destruction alone.
+// Include this in your project after your DBG_NEW/_compat.inl prelude, as for obj_opt.cpp - main() is defined in this module.
+
+#include <chrono>
+#include <random>
+#include "jsonobjs.h"
+
+__BIENUTIL_USING_NAMESPACE
+
+std::string g_strProgramName;
+
+int _TryMain( int _argc, char ** _argv );
+
+int main( int _argc, char ** _argv )
+{
+#define USAGE "Usage: %s [<document MB> - default 100]"
+  g_strProgramName = _argv[0];
+  n_SysLog::InitSysLog( g_strProgramName.c_str(), LOG_PERROR, LOG_USER );
+
+  if ( _argc > 2 )
+  {
+    LOGSYSLOG( eslmtError, USAGE, g_strProgramName.c_str() );
+    return EXIT_FAILURE;
+  }
+
+  try
+  {
+    return _TryMain( _argc - 1, _argv + 1 );
+  }
+  catch ( std::exception const & _rexc )
+  {
+    LOGEXCEPTION( _rexc, "Caught exception running benchmark." );
+    return EXIT_FAILURE;
+  }
+  catch ( ... )
+  {
+    LOGSYSLOG( eslmtError, "Unknown exception caught." );
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+// An array of small objects - numbers, short and long strings, booleans and a nested object - of at least _nbyDoc bytes.
+std::string
+StrGenerateDocument( size_t _nbyDoc )
+{
+  std::mt19937_64 rng( 18 );
+  std::string strDoc = "[";
+  while ( strDoc.length() < _nbyDoc )
+  {
+    if ( strDoc.length() > 1 )
+      strDoc += ",";
+    strDoc += "{\"id\":" + std::to_string( rng() % 1000000 ) + ",\"name\":\"user" + std::to_string( rng() % 100000 ) + "\",\"score\":" +
+              std::to_string( rng() % 1000 ) + "." + std::to_string( rng() % 100 ) +
+              ",\"tags\":[\"alpha\",\"beta\",\"a much longer tag string than the reserve\"],\"active\":" + ( ( rng() & 1 ) ? "true" : "false" ) +
+              ",\"nested\":{\"x\":1,\"y\":2,\"label\":\"some label text here\"}}";
+  }
+  strDoc += "]";
+  return strDoc;
+}
+
+// Print the best of three runs of _rrf.
+template < class t_tyF >
+void
+TimeBestOf3( const char * _pszName, size_t _nbyDoc, t_tyF && _rrf )
+{
+  double dblBest = ( std::numeric_limits< double >::max )();
+  for ( int n = 0; n < 3; ++n )
+  {
+    std::chrono::steady_clock::time_point tpStart = std::chrono::steady_clock::now();
+    _rrf();
+    dblBest = ( std::min )( dblBest, std::chrono::duration< double >( std::chrono::steady_clock::now() - tpStart ).count() );
+  }
+  printf( "%-36s %.3fs %.0fMB/s\n", _pszName, dblBest, ( _nbyDoc / 1048576.0 ) / dblBest );
+}
+
+int _TryMain( int _argc, char ** _argv )
+{
+  size_t nMB = !_argc ? 100 : size_t( strtoull( _argv[0], nullptr, 10 ) );
+  std::string strDoc = StrGenerateDocument( nMB << 20 );
+  printf( "Document: %zuMB\n", strDoc.length() >> 20 );
+  TimeBestOf3( "map, std::allocator parse+destroy", strDoc.length(), [&strDoc]() { JsoValue< char > jv; jv.FromString( strDoc ); } );
+  TimeBestOf3( "map, arena parse+destroy", strDoc.length(), [&strDoc]() { JsoArenaDocument< char > jad; jad.FromString( strDoc ); } );
+  TimeBestOf3( "flat, std::allocator parse+destroy", strDoc.length(), [&strDoc]() { JsoValue< char, JsoObjectStorageFlat<> > jv; jv.FromString( strDoc ); } );
+  TimeBestOf3( "flat, arena parse+destroy", strDoc.length(), [&strDoc]() { JsoArenaDocument< char, JsoObjectStorageFlat<> > jad; jad.FromString( strDoc ); } );
+  { // B
+    std::unique_ptr< JsoValue< char > > pjv = std::make_unique< JsoValue< char > >();
+    pjv->FromString( strDoc );
+    std::chrono::steady_clock::time_point tpStart = std::chrono::steady_clock::now();
+    pjv.reset();
+    printf( "%-36s %.3fs\n", "map, std::allocator destroy", std::chrono::duration< double >( std::chrono::steady_clock::now() - tpStart ).count() );
+  } // EB
+  { // B
+    std::unique_ptr< JsoArenaDocument< char > > pjad = std::make_unique< JsoArenaDocument< char > >();
+    pjad->FromString( strDoc );
+    printf( "Arena reserved: %zuMB\n", pjad->RArenaGet().StReserved() >> 20 );
+    std::chrono::steady_clock::time_point tpStart = std::chrono::steady_clock::now();
+    pjad.reset();
+    printf( "%-36s %.3fs\n", "map, arena destroy", std::chrono::duration< double >( std::chrono::steady_clock::now() - tpStart ).count() );
+  } // EB
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,116 @@
+//          Copyright David Lawrence Bien 1997 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt).
+
+// jsonmmapbench.cpp
+// This times writing the same stream of records through JsonMemMappedOutputStream - with and without preallocation - JsonFileOutputStream
+//  and JsonFileOutputMemStream, and then checks that the files written are identical.
+// Include this in your project after your DBG_NEW/_compat.inl prelude, as for obj_opt.cpp - main() is defined in this module.
+
+#include <chrono>
+#include "jsonstrm.h"
+
+__BIENUTIL_USING_NAMESPACE
+
+std::string g_strProgramName;
+
+int _TryMain( int _argc, char ** _argv );
+
+int main( int _argc, char ** _argv )
+{
+#define USAGE "Usage: %s <output directory> [<total bytes> - default 1GB]"
+  g_strProgramName = _argv[0];
+  n_SysLog::InitSysLog( g_strProgramName.c_str(), LOG_PERROR, LOG_USER );
+
+  if ( ( 2 != _argc ) && ( 3 != _argc ) )
+  {
+    LOGSYSLOG( eslmtError, USAGE, g_strProgramName.c_str() );
+    return EXIT_FAILURE;
+  }
+
+  try
+  {
+    return _TryMain( _argc - 1, _argv + 1 );
+  }
+  catch ( std::exception const & _rexc )
+  {
+    LOGEXCEPTION( _rexc, "Caught exception running benchmark." );
+    return EXIT_FAILURE;
+  }
+  catch ( ... )
+  {
+    LOGSYSLOG( eslmtError, "Unknown exception caught." );
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+// Write _nbyTotal bytes of 1001 byte records to _strFile and return the elapsed seconds - including the close.
+template < class t_tyOutputStream >
+double
+DblTimeWrite( std::string const & _strFile, uint64_t _nbyTotal, bool _fPreallocate = false )
+{
+  std::chrono::steady_clock::time_point tpStart = std::chrono::steady_clock::now();
+  {
+    t_tyOutputStream os;
+    if constexpr ( requires { os.SetGrowthPolicy( 1, 2, false ); } )
+    {
+      if ( _fPreallocate )
+        os.SetGrowthPolicy( 1ull << 20, 1ull << 30, true );
+    }
+    os.Open( _strFile.c_str() );
+    std::string strRecord( 1000, 'x' );
+    strRecord += "\n";
+    for ( uint64_t nby = 0; nby < _nbyTotal; nby += strRecord.length() )
+      os.WriteRawChars( strRecord.c_str(), strRecord.length() );
+    if constexpr ( requires { os.Close( true ); } )
+      os.Close( true );
+    else
+      os.Close();
+  }
+  return std::chrono::duration< double >( std::chrono::steady_clock::now() - tpStart ).count();
+}
+
+// Return whether the two files have the same contents.
+bool
+FSameFile( std::string const & _strFileA, std::string const & _strFileB )
+{
+  FileObj foA( OpenReadOnlyFile( _strFileA.c_str() ) );
+  FileObj foB( OpenReadOnlyFile( _strFileB.c_str() ) );
+  VerifyThrowSz( foA.FIsOpen() && foB.FIsOpen(), "Unable to open [%s] or [%s].", _strFileA.c_str(), _strFileB.c_str() );
+  const size_t knBuf = 1 << 20;
+  std::unique_ptr< char[] > rgcA( new char[ knBuf ] );
+  std::unique_ptr< char[] > rgcB( new char[ knBuf ] );
+  for ( ;; )
+  {
+    uint64_t nbyA = 0;
+    uint64_t nbyB = 0;
+    VerifyThrowSz( !FileRead( foA.HFileGet(), rgcA.get(), knBuf, &nbyA ), "FileRead() failed for [%s].", _strFileA.c_str() );
+    VerifyThrowSz( !FileRead( foB.HFileGet(), rgcB.get(), knBuf, &nbyB ), "FileRead() failed for [%s].", _strFileB.c_str() );
+    if ( ( nbyA != nbyB ) || !!memcmp( rgcA.get(), rgcB.get(), nbyA ) )
+      return false;
+    if ( !nbyA )
+      return true;
+  }
+}
+
+int _TryMain( int _argc, char ** _argv )
+{
+  std::string strDir = _argv[0];
+  uint64_t nbyTotal = ( 2 == _argc ) ? strtoull( _argv[1], nullptr, 10 ) : ( 1ull << 30 );
+  typedef JsonCharTraits< char > _tyCharTraits;
+  std::string strMemMapped = strDir + "/jsonmmapbench.mmap.out";
+  std::string strPrealloc = strDir + "/jsonmmapbench.prealloc.out";
+  std::string strFile = strDir + "/jsonmmapbench.file.out";
+  std::string strFileMem = strDir + "/jsonmmapbench.filemem.out";
+  printf( "JsonMemMappedOutputStream:               %.3fs\n", DblTimeWrite< JsonMemMappedOutputStream< _tyCharTraits > >( strMemMapped, nbyTotal ) );
+  printf( "JsonMemMappedOutputStream + preallocate: %.3fs\n", DblTimeWrite< JsonMemMappedOutputStream< _tyCharTraits > >( strPrealloc, nbyTotal, true ) );
+  printf( "JsonFileOutputStream:                    %.3fs\n", DblTimeWrite< JsonFileOutputStream< _tyCharTraits > >( strFile, nbyTotal ) );
+  printf( "JsonFileOutputMemStream:                 %.3fs\n", DblTimeWrite< JsonFileOutputMemStream< _tyCharTraits > >( strFileMem, nbyTotal ) );
+  bool fSame = FSameFile( strMemMapped, strFile ) && FSameFile( strPrealloc, strFile ) && FSameFile( strFileMem, strFile );
+  printf( "Outputs %s.\n", fSame ? "identical" : "DIFFER" );
+  for ( std::string const * pstr : { &strMemMapped, &strPrealloc, &strFile, &strFileMem } )
+    (void)FileDelete( pstr->c_str() );
+  return fSame ? EXIT_SUCCESS : EXIT_FAILURE;
+}
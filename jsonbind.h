@@ -0,0 +1,543 @@
+#pragma once
+
+//          Copyright David Lawrence Bien 1997 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt).
+
+// jsonbind.h
+// Compile-time binding of the members of plain structs to JSON (key,value) pairs.
+// A struct declares its bound members once and JsonBinder<> then writes it directly to a JsonValueLife and reads it directly from
+//  a JsonReadCursor - no JsoValue tree is built. On read the key of each element is looked up in a perfect hash table built at compile
+//  time - one hash and one verifying compare per key, then a jump to the reader for that member.
+// Usage:
+//  struct Rec
+//  {
+//    int64_t m_nId;
+//    std::string m_strName;
+//    std::vector< double > m_rgdblValues;
+//    JSONBIND_FIELDS( Rec, JSONBIND_FIELD_KEY( "id", m_nId ), JSONBIND_FIELD_KEY( "name", m_strName ), JSONBIND_FIELD( m_rgdblValues ) )
+//  };
+//  JsonBindToJSONStream( jvlObject, rec ); JsonBindFromJSONStream( jrc, rec );
+// Types that can't be modified may instead specialize JsonBindTraits<> with a static constexpr GetFields().
+// Bound members may be: bool, arithmetic and enum types, std::basic_string<> of any character type, other bound structs,
+//  std::vector<> and std::optional<> of any of these. A null value resets an optional and is otherwise ignored.
+// Keys must be ASCII - they are hashed as code units so the same table serves all character types of JSON stream.
+
+#include <tuple>
+#include <array>
+#include <bit>
+#include <optional>
+#include <vector>
+#include <type_traits>
+#include "jsonstrm.h"
+
+__BIENUTIL_BEGIN_NAMESPACE
+
+// JsonBindField:
+// The key for and the member pointer of a single bound member.
+template < class t_tyStruct, class t_tyMember >
+struct JsonBindField
+{
+  typedef t_tyStruct _tyStruct;
+  typedef t_tyMember _tyMember;
+
+  constexpr JsonBindField( const char * _pszKey, t_tyMember t_tyStruct::*_pmMember )
+      : m_pszKey( _pszKey ),
+        m_stLenKey( std::char_traits< char >::length( _pszKey ) ),
+        m_pmMember( _pmMember )
+  {
+  }
+  const char * m_pszKey;
+  size_t m_stLenKey;
+  t_tyMember t_tyStruct::*m_pmMember;
+};
+
+// Hash the code units of a key - FNV-1a mixed with the seed found for the table.
+template < class t_tyChar >
+constexpr uint32_t UJsonBindHash( uint32_t _uSeed, const t_tyChar * _pc, size_t _stLen )
+{
+  uint32_t u = 2166136261u ^ ( _uSeed * 0x9e3779b9u );
+  for ( const t_tyChar * const pcEnd = _pc + _stLen; pcEnd != _pc; ++_pc )
+  {
+    u ^= uint32_t( std::make_unsigned_t< t_tyChar >( *_pc ) );
+    u *= 16777619u;
+  }
+  return u ^ ( u >> 15 );
+}
+
+// JsonBindTable:
+// The fields bound for a struct and a perfect hash of their keys. Constructed only in constant expressions (see JsonBindFields()).
+// The slot table is sized to the smallest power of two for which a seed is found that places each key in its own slot.
+template < class... t_tysFields >
+class JsonBindTable
+{
+  typedef JsonBindTable _tyThis;
+
+public:
+  static constexpr size_t s_kstNFields = sizeof...( t_tysFields );
+  static_assert( ( s_kstNFields > 0 ) && ( s_kstNFields < 128 ), "JsonBindTable supports from 1 to 127 fields." );
+  static constexpr size_t s_kstMaxSlots = std::bit_ceil( (std::max)( size_t( 8 ), s_kstNFields * s_kstNFields / 2 ) );
+  static constexpr uint8_t s_kbyEmptySlot = 0xff;
+  static constexpr uint32_t s_kuSeedsPerSize = 256;
+
+  constexpr JsonBindTable( t_tysFields const &... _rfields )
+      : m_tplFields( _rfields... ),
+        m_rgpszKeys{ _rfields.m_pszKey... },
+        m_rgstLenKeys{ _rfields.m_stLenKey... }
+  {
+    for ( size_t nField = 0; nField < s_kstNFields; ++nField )
+    {
+      for ( size_t nChar = 0; nChar < m_rgstLenKeys[ nField ]; ++nChar )
+        if ( uint8_t( m_rgpszKeys[ nField ][ nChar ] ) >= 128 )
+          throw std::logic_error( "JsonBindTable: Keys must be ASCII." );
+      for ( size_t nFieldPrev = 0; nFieldPrev < nField; ++nFieldPrev )
+        if ( _FKeysEqual( nFieldPrev, nField ) )
+          throw std::logic_error( "JsonBindTable: Duplicate key." );
+    }
+    for ( size_t stSlots = std::bit_ceil( (std::max)( size_t( 4 ), 2 * s_kstNFields ) ); stSlots <= s_kstMaxSlots; stSlots *= 2 )
+    {
+      for ( uint32_t uSeed = 0; uSeed < s_kuSeedsPerSize; ++uSeed )
+      {
+        if ( _FTrySeed( uSeed, stSlots ) )
+          return;
+      }
+    }
+    throw std::logic_error( "JsonBindTable: Unable to find a perfect hash for the keys." );
+  }
+
+  // Return the index of the field with the given key or -1 if there is no such field.
+  template < class t_tyChar >
+  int IFind( const t_tyChar * _pcKey, size_t _stLenKey ) const
+  {
+    uint8_t byField = m_rgbySlots[ UJsonBindHash( m_uSeed, _pcKey, _stLenKey ) & m_uMaskSlots ];
+    if ( ( s_kbyEmptySlot == byField ) || ( m_rgstLenKeys[ byField ] != _stLenKey ) )
+      return -1;
+    const char * pcField = m_rgpszKeys[ byField ];
+    if constexpr ( sizeof( t_tyChar ) == sizeof( char ) )
+      return !memcmp( pcField, _pcKey, _stLenKey ) ? int( byField ) : -1;
+    else
+    {
+      for ( const t_tyChar * const pcEnd = _pcKey + _stLenKey; pcEnd != _pcKey; ++_pcKey, ++pcField )
+        if ( std::make_unsigned_t< t_tyChar >( *_pcKey ) != uint8_t( *pcField ) )
+          return -1;
+      return int( byField );
+    }
+  }
+  // The total number of characters in the keys including a null terminator for each.
+  constexpr size_t StTotalKeyChars() const
+  {
+    size_t st = 0;
+    for ( size_t nField = 0; nField < s_kstNFields; ++nField )
+      st += m_rgstLenKeys[ nField ] + 1;
+    return st;
+  }
+  // The keys converted to t_tyChar, null terminated and end to end in field order.
+  template < class t_tyChar, size_t t_kstTotalKeyChars >
+  constexpr std::array< t_tyChar, t_kstTotalKeyChars > RgKeysConvert() const
+  {
+    std::array< t_tyChar, t_kstTotalKeyChars > rgc{};
+    size_t nCur = 0;
+    for ( size_t nField = 0; nField < s_kstNFields; ++nField, ++nCur )
+    {
+      for ( size_t nChar = 0; nChar < m_rgstLenKeys[ nField ]; ++nChar )
+        rgc[ nCur++ ] = t_tyChar( m_rgpszKeys[ nField ][ nChar ] );
+    }
+    return rgc;
+  }
+
+  std::tuple< t_tysFields... > m_tplFields;
+  const char * m_rgpszKeys[ s_kstNFields ];
+  size_t m_rgstLenKeys[ s_kstNFields ];
+  uint32_t m_uSeed{ 0 };
+  uint32_t m_uMaskSlots{ 0 };
+  uint8_t m_rgbySlots[ s_kstMaxSlots ]{};
+
+protected:
+  constexpr bool _FKeysEqual( size_t _nFieldA, size_t _nFieldB ) const
+  {
+    if ( m_rgstLenKeys[ _nFieldA ] != m_rgstLenKeys[ _nFieldB ] )
+      return false;
+    for ( size_t nChar = 0; nChar < m_rgstLenKeys[ _nFieldA ]; ++nChar )
+      if ( m_rgpszKeys[ _nFieldA ][ nChar ] != m_rgpszKeys[ _nFieldB ][ nChar ] )
+        return false;
+    return true;
+  }
+  constexpr bool _FTrySeed( uint32_t _uSeed, size_t _stSlots )
+  {
+    for ( size_t nSlot = 0; nSlot < _stSlots; ++nSlot )
+      m_rgbySlots[ nSlot ] = s_kbyEmptySlot;
+    for ( size_t nField = 0; nField < s_kstNFields; ++nField )
+    {
+      uint8_t & rbySlot = m_rgbySlots[ UJsonBindHash( _uSeed, m_rgpszKeys[ nField ], m_rgstLenKeys[ nField ] ) & ( _stSlots - 1 ) ];
+      if ( s_kbyEmptySlot != rbySlot )
+        return false;
+      rbySlot = uint8_t( nField );
+    }
+    m_uSeed = _uSeed;
+    m_uMaskSlots = uint32_t( _stSlots - 1 );
+    return true;
+  }
+};
+
+// Create the JsonBindTable for a set of JsonBindFields.
+template < class... t_tysFields >
+constexpr JsonBindTable< t_tysFields... > JsonBindFields( t_tysFields const &... _rfields )
+{
+  return JsonBindTable< t_tysFields... >( _rfields... );
+}
+
+// Declare the bound members within the struct. The key of JSONBIND_FIELD() is the name of the member.
+#define JSONBIND_FIELDS( TYPE, ... )                       \
+  static constexpr auto JsonBindGetFields()                \
+  {                                                        \
+    typedef TYPE _tyJsonBindStruct;                        \
+    return __BIENUTIL_NAMESPACE JsonBindFields( __VA_ARGS__ ); \
+  }
+#define JSONBIND_FIELD( MEMBER ) __BIENUTIL_NAMESPACE JsonBindField( #MEMBER, &_tyJsonBindStruct::MEMBER )
+#define JSONBIND_FIELD_KEY( KEY, MEMBER ) __BIENUTIL_NAMESPACE JsonBindField( KEY, &_tyJsonBindStruct::MEMBER )
+
+// JsonBindTraits:
+// Supplies the bound fields for t_ty. By default these come from t_ty::JsonBindGetFields() - specialize this for types that can't be modified.
+template < class t_ty >
+struct JsonBindTraits
+{
+};
+template < class t_ty >
+  requires requires { t_ty::JsonBindGetFields(); }
+struct JsonBindTraits< t_ty >
+{
+  static constexpr auto GetFields() { return t_ty::JsonBindGetFields(); }
+};
+template < class t_ty >
+inline constexpr bool TIsJsonBound_v = requires { JsonBindTraits< t_ty >::GetFields(); };
+
+// TIsJsonBindVector, TIsJsonBindOptional: The containers supported as members.
+template < class t_ty >
+struct TIsJsonBindVector
+{
+  static constexpr bool value = false;
+};
+template < class t_tyEl, class t_tyAllocator >
+struct TIsJsonBindVector< std::vector< t_tyEl, t_tyAllocator > >
+{
+  static constexpr bool value = true;
+};
+template < class t_ty >
+struct TIsJsonBindOptional
+{
+  static constexpr bool value = false;
+};
+template < class t_tyEl >
+struct TIsJsonBindOptional< std::optional< t_tyEl > >
+{
+  static constexpr bool value = true;
+};
+template < class t_ty >
+struct TIsJsonBindString
+{
+  static constexpr bool value = false;
+};
+template < class t_tyChar, class t_tyCharTraits, class t_tyAllocator >
+struct TIsJsonBindString< std::basic_string< t_tyChar, t_tyCharTraits, t_tyAllocator > >
+{
+  static constexpr bool value = true;
+};
+
+// The fixed size type that an integral member is read and written as - JsonReadCursor::GetValue() and JsonValueLife::WriteValue()
+//  have overloads only for these.
+template < class t_tyInt >
+using TJsonBindFixedInt = std::conditional_t< std::is_signed_v< t_tyInt >,
+                                              std::conditional_t< sizeof( t_tyInt ) == 1, int8_t, std::conditional_t< sizeof( t_tyInt ) == 2, int16_t, std::conditional_t< sizeof( t_tyInt ) == 4, int32_t, int64_t > > >,
+                                              std::conditional_t< sizeof( t_tyInt ) == 1, uint8_t, std::conditional_t< sizeof( t_tyInt ) == 2, uint16_t, std::conditional_t< sizeof( t_tyInt ) == 4, uint32_t, uint64_t > > > >;
+
+// The bound tables and their keys converted to each character type, evaluated once per type.
+template < class t_ty >
+inline constexpr auto s_kjbtJsonBind = JsonBindTraits< t_ty >::GetFields();
+template < class t_ty, class t_tyChar >
+inline constexpr auto s_krgcJsonBindKeys = s_kjbtJsonBind< t_ty >.template RgKeysConvert< t_tyChar, s_kjbtJsonBind< t_ty >.StTotalKeyChars() >();
+
+template < class t_tyJsonOutputStream, class t_tyValue >
+void JsonBindWriteValue( JsonValueLife< t_tyJsonOutputStream > & _jvl, const typename t_tyJsonOutputStream::_tyChar * _pcKey, size_t _stLenKey, t_tyValue const & _rv );
+template < class t_tyJsonInputStream, class t_tyValue >
+void JsonBindReadValue( JsonReadCursor< t_tyJsonInputStream > & _jrc, t_tyValue & _rv );
+
+// JsonBinder:
+// Reads and writes a bound struct t_ty.
+template < class t_ty >
+class JsonBinder
+{
+  typedef JsonBinder _tyThis;
+
+public:
+  typedef std::remove_cvref_t< decltype( s_kjbtJsonBind< t_ty > ) > _tyTable;
+  static constexpr size_t s_kstNFields = _tyTable::s_kstNFields;
+
+  // Write the members of _rt into the object at _jvl.
+  template < class t_tyJsonOutputStream >
+  static void ToJSONStream( JsonValueLife< t_tyJsonOutputStream > & _jvl, t_ty const & _rt )
+  {
+    typedef typename t_tyJsonOutputStream::_tyCharTraits _tyCharTraits; // Used by THROWBADJSONSEMANTICUSE.
+    if ( !_jvl.FAtObjectValue() )
+      THROWBADJSONSEMANTICUSE( "Not at an object." );
+    _WriteFields( _jvl, _rt, std::make_index_sequence< s_kstNFields >() );
+  }
+  // Read the object at _jrc into _rt. Members whose keys are not present are left as they are and unknown keys are skipped.
+  template < class t_tyJsonInputStream >
+  static void FromJSONStream( JsonReadCursor< t_tyJsonInputStream > & _jrc, t_ty & _rt )
+  {
+    typedef typename t_tyJsonInputStream::_tyCharTraits _tyCharTraits; // Used by THROWBADJSONSEMANTICUSE.
+    if ( !_jrc.FAtObjectValue() )
+      THROWBADJSONSEMANTICUSE( "Not at an object." );
+    JsonRestoreContext< t_tyJsonInputStream > jrx( _jrc );
+    if ( _jrc.FMoveDown() )
+    {
+      for ( ; !_jrc.FAtEndOfAggregate(); (void)_jrc.FNextElement() )
+      {
+        EJsonValueType jvt;
+        typename JsonReadCursor< t_tyJsonInputStream >::_tyStringView svKey = _jrc.SvKey( &jvt );
+        int iField = s_kjbtJsonBind< t_ty >.IFind( svKey.data(), svKey.length() );
+        if ( iField >= 0 )
+          _ReadField( _jrc, _rt, size_t( iField ), std::make_index_sequence< s_kstNFields >() );
+      }
+    }
+  }
+
+protected:
+  template < class t_tyJsonOutputStream, size_t... t_knFields >
+  static void _WriteFields( JsonValueLife< t_tyJsonOutputStream > & _jvl, t_ty const & _rt, std::index_sequence< t_knFields... > )
+  {
+    ( _WriteField< t_knFields >( _jvl, _rt ), ... );
+  }
+  template < size_t t_knField, class t_tyJsonOutputStream >
+  static void _WriteField( JsonValueLife< t_tyJsonOutputStream > & _jvl, t_ty const & _rt )
+  {
+    typedef typename t_tyJsonOutputStream::_tyChar _tyChar;
+    constexpr auto & rjbf = std::get< t_knField >( s_kjbtJsonBind< t_ty >.m_tplFields );
+    const _tyChar * pcKey;
+    if constexpr ( std::is_same_v< _tyChar, char > )
+      pcKey = rjbf.m_pszKey;
+    else
+    {
+      constexpr size_t kstOffset = _StKeyOffset( t_knField );
+      pcKey = &s_krgcJsonBindKeys< t_ty, _tyChar >[ kstOffset ];
+    }
+    JsonBindWriteValue( _jvl, pcKey, rjbf.m_stLenKey, _rt.*rjbf.m_pmMember );
+  }
+  static constexpr size_t _StKeyOffset( size_t _nField )
+  {
+    size_t st = 0;
+    for ( size_t nField = 0; nField < _nField; ++nField )
+      st += s_kjbtJsonBind< t_ty >.m_rgstLenKeys[ nField ] + 1;
+    return st;
+  }
+  // Dispatch to the reader for the field via a table of function pointers.
+  template < class t_tyJsonInputStream, size_t... t_knFields >
+  static void _ReadField( JsonReadCursor< t_tyJsonInputStream > & _jrc, t_ty & _rt, size_t _nField, std::index_sequence< t_knFields... > )
+  {
+    typedef void ( *_tyPfnRead )( JsonReadCursor< t_tyJsonInputStream > &, t_ty & );
+    static constexpr _tyPfnRead s_krgpfnRead[] = { &_ReadFieldN< t_knFields, t_tyJsonInputStream >... };
+    s_krgpfnRead[ _nField ]( _jrc, _rt );
+  }
+  template < size_t t_knField, class t_tyJsonInputStream >
+  static void _ReadFieldN( JsonReadCursor< t_tyJsonInputStream > & _jrc, t_ty & _rt )
+  {
+    constexpr auto & rjbf = std::get< t_knField >( s_kjbtJsonBind< t_ty >.m_tplFields );
+    JsonBindReadValue( _jrc, _rt.*rjbf.m_pmMember );
+  }
+};
+
+// Write the bound struct _rt to the object at _jvl.
+template < class t_tyJsonOutputStream, class t_ty >
+void JsonBindToJSONStream( JsonValueLife< t_tyJsonOutputStream > & _jvl, t_ty const & _rt )
+  requires TIsJsonBound_v< t_ty >
+{
+  JsonBinder< t_ty >::ToJSONStream( _jvl, _rt );
+}
+// Read the bound struct _rt from the object at _jrc.
+template < class t_tyJsonInputStream, class t_ty >
+void JsonBindFromJSONStream( JsonReadCursor< t_tyJsonInputStream > & _jrc, t_ty & _rt )
+  requires TIsJsonBound_v< t_ty >
+{
+  JsonBinder< t_ty >::FromJSONStream( _jrc, _rt );
+}
+
+// JsonBindWriteValue:
+// Write a single member value. When _pcKey is null we are writing an array element.
+template < class t_tyJsonOutputStream, class t_tyValue >
+void JsonBindWriteValue( JsonValueLife< t_tyJsonOutputStream > & _jvl, const typename t_tyJsonOutputStream::_tyChar * _pcKey, size_t _stLenKey, t_tyValue const & _rv )
+{
+  typedef JsonValueLife< t_tyJsonOutputStream > _tyJsonValueLife;
+  if constexpr ( TIsJsonBindOptional< t_tyValue >::value )
+  {
+    if ( !_rv.has_value() )
+    {
+      if ( _pcKey )
+        _jvl.WriteNullValue( _pcKey );
+      else
+        _jvl.WriteNullValue();
+    }
+    else
+      JsonBindWriteValue( _jvl, _pcKey, _stLenKey, *_rv );
+  }
+  else if constexpr ( TIsJsonBindVector< t_tyValue >::value )
+  {
+    auto lambdaWriteEls = [&_rv]( _tyJsonValueLife & _rjvlArray )
+    {
+      for ( auto const & rvEl : _rv )
+      {
+        if constexpr ( std::is_same_v< typename t_tyValue::value_type, bool > )
+          JsonBindWriteValue( _rjvlArray, nullptr, 0, bool( rvEl ) ); // std::vector< bool > gives a proxy.
+        else
+          JsonBindWriteValue( _rjvlArray, nullptr, 0, rvEl );
+      }
+    };
+    if ( _pcKey )
+    {
+      _tyJsonValueLife jvlArray( _jvl, _pcKey, ssize_t( _stLenKey ), ejvtArray );
+      lambdaWriteEls( jvlArray );
+    }
+    else
+    {
+      _tyJsonValueLife jvlArray( _jvl, ejvtArray );
+      lambdaWriteEls( jvlArray );
+    }
+  }
+  else if constexpr ( TIsJsonBound_v< t_tyValue > )
+  {
+    if ( _pcKey )
+    {
+      _tyJsonValueLife jvlObject( _jvl, _pcKey, ssize_t( _stLenKey ), ejvtObject );
+      JsonBinder< t_tyValue >::ToJSONStream( jvlObject, _rv );
+    }
+    else
+    {
+      _tyJsonValueLife jvlObject( _jvl, ejvtObject );
+      JsonBinder< t_tyValue >::ToJSONStream( jvlObject, _rv );
+    }
+  }
+  else if constexpr ( TIsJsonBindString< t_tyValue >::value )
+  {
+    if ( _pcKey )
+      _jvl.WriteStringValue( _pcKey, ssize_t( _stLenKey ), &_rv[0], _rv.length() );
+    else
+      _jvl.WriteStringValue( &_rv[0], _rv.length() );
+  }
+  else if constexpr ( std::is_same_v< t_tyValue, bool > )
+  {
+    if ( _pcKey )
+      _jvl.WriteBoolValue( _pcKey, _rv );
+    else
+      _jvl.WriteBoolValue( _rv );
+  }
+  else if constexpr ( std::is_enum_v< t_tyValue > )
+    JsonBindWriteValue( _jvl, _pcKey, _stLenKey, std::underlying_type_t< t_tyValue >( _rv ) );
+  else if constexpr ( std::is_integral_v< t_tyValue > )
+  {
+    if ( _pcKey )
+      _jvl.WriteValue( _pcKey, TJsonBindFixedInt< t_tyValue >( _rv ) );
+    else
+      _jvl.WriteValue( TJsonBindFixedInt< t_tyValue >( _rv ) );
+  }
+  else if constexpr ( std::is_floating_point_v< t_tyValue > )
+  {
+    typedef std::conditional_t< std::is_same_v< t_tyValue, long double >, long double, double > _tyFloat;
+    if ( _pcKey )
+      _jvl.WriteValue( _pcKey, _tyFloat( _rv ) );
+    else
+      _jvl.WriteValue( _tyFloat( _rv ) );
+  }
+  else
+    static_assert( TIsJsonBindString< t_tyValue >::value, "JsonBindWriteValue: Unsupported member type." );
+}
+
+// JsonBindReadValue:
+// Read a single member value from the current position of _jrc.
+template < class t_tyJsonInputStream, class t_tyValue >
+void JsonBindReadValue( JsonReadCursor< t_tyJsonInputStream > & _jrc, t_tyValue & _rv )
+{
+  typedef typename t_tyJsonInputStream::_tyCharTraits _tyCharTraits;
+  typedef typename _tyCharTraits::_tyChar _tyChar;
+  if constexpr ( TIsJsonBindOptional< t_tyValue >::value )
+  {
+    if ( _jrc.FIsValueNull() )
+      _rv.reset();
+    else
+      JsonBindReadValue( _jrc, _rv.emplace() );
+  }
+  else if ( _jrc.FIsValueNull() )
+    return;
+  else if constexpr ( TIsJsonBindVector< t_tyValue >::value )
+  {
+    if ( !_jrc.FAtArrayValue() )
+      THROWBADJSONSEMANTICUSE( "Not at an array." );
+    _rv.clear();
+    JsonRestoreContext< t_tyJsonInputStream > jrx( _jrc );
+    if ( _jrc.FMoveDown() )
+    {
+      for ( ; !_jrc.FAtEndOfAggregate(); (void)_jrc.FNextElement() )
+      {
+        if constexpr ( std::is_same_v< typename t_tyValue::value_type, bool > )
+        { // std::vector< bool > has no bool & to read into.
+          bool f = false; // As emplace_back() would be for a null element.
+          JsonBindReadValue( _jrc, f );
+          _rv.push_back( f );
+        }
+        else
+          JsonBindReadValue( _jrc, _rv.emplace_back() );
+      }
+    }
+  }
+  else if constexpr ( TIsJsonBound_v< t_tyValue > )
+    JsonBinder< t_tyValue >::FromJSONStream( _jrc, _rv );
+  else if constexpr ( TIsJsonBindString< t_tyValue >::value )
+  {
+    typedef typename JsonReadCursor< t_tyJsonInputStream >::_tyStringView _tyStringView;
+    auto lambdaAssign = [&_rv]( _tyStringView const & _rsv )
+    {
+      if constexpr ( sizeof( typename t_tyValue::value_type ) == sizeof( _tyChar ) )
+        _rv.assign( (const typename t_tyValue::value_type *)_rsv.data(), _rsv.length() );
+      else
+        ConvertString( _rv, &_rsv[0], _rsv.length() );
+    };
+    // Numbers and booleans are read as their text. Assign within each case - str_array_cast<>() returns a temporary.
+    switch ( _jrc.JvtGetValueType() )
+    {
+    case ejvtString:
+      lambdaAssign( _jrc.SvGetStringValue() );
+      break;
+    case ejvtNumber:
+      lambdaAssign( _jrc.SvGetNumberValue() );
+      break;
+    case ejvtTrue:
+      lambdaAssign( _tyStringView( str_array_cast< _tyChar >( "true" ), 4 ) );
+      break;
+    case ejvtFalse:
+      lambdaAssign( _tyStringView( str_array_cast< _tyChar >( "false" ), 5 ) );
+      break;
+    default:
+      THROWBADJSONSEMANTICUSE( "At an aggregate value - object or array." );
+      break;
+    }
+  }
+  else if constexpr ( std::is_same_v< t_tyValue, bool > )
+    _jrc.GetValue( _rv );
+  else if constexpr ( std::is_enum_v< t_tyValue > )
+  {
+    std::underlying_type_t< t_tyValue > v;
+    JsonBindReadValue( _jrc, v );
+    _rv = t_tyValue( v );
+  }
+  else if constexpr ( std::is_integral_v< t_tyValue > )
+  {
+    TJsonBindFixedInt< t_tyValue > v;
+    _jrc.GetValue( v );
+    _rv = t_tyValue( v );
+  }
+  else if constexpr ( std::is_floating_point_v< t_tyValue > )
+    _jrc.GetValue( _rv );
+  else
+    static_assert( TIsJsonBindString< t_tyValue >::value, "JsonBindReadValue: Unsupported member type." );
+}
+
+__BIENUTIL_END_NAMESPACE
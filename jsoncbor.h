@@ -0,0 +1,779 @@
+#pragma once
+
+//          Copyright David Lawrence Bien 1997 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt).
+
+// jsoncbor.h
+// CBOR (RFC 8949) streams for the JsonValueLife writer and the JsonReadCursor reader.
+// CborOutputStream encodes what is written through JsonValueLife - objects and arrays are written as indefinite length maps
+//  and arrays so nothing needs to be known up front, numbers written with WriteValue() are encoded natively without any text conversion.
+// CborInputStream decodes CBOR and presents it to JsonReadCursor as the equivalent JSON text, so any FromJSONStream() code reads it
+//  unchanged. This also gives the conversion to JSON text for humans:
+//    n_JSONStream::StreamJSON< CborInputStream< _tyCharTraits >, JsonFileOutputStream< _tyCharTraits, char > >::Stream( ... )
+//  and the reverse conversion with the input and output swapped.
+// CBOR that has no JSON equivalent is converted as RFC 8949 section 6.1 suggests: byte strings become base64url strings, tags are
+//  ignored, NaN, infinities and undefined become null and integer map keys become strings. Other map keys are an error.
+
+#include <cstdint>
+#include <cmath>
+#include <cfloat>
+#include <string>
+#include <vector>
+#include <memory>
+#include "jsonstrm.h"
+
+__BIENUTIL_BEGIN_NAMESPACE
+
+// CBOR major types - the top three bits of the initial byte of each data item.
+enum ECborMajorType : uint8_t
+{
+  ecmtUnsigned,
+  ecmtNegative,
+  ecmtBytes,
+  ecmtText,
+  ecmtArray,
+  ecmtMap,
+  ecmtTag,
+  ecmtSimple, // Also floating point and the "break" stop code.
+  ecmtCborMajorTypeCount
+};
+// The low five bits of the initial byte:
+static const uint8_t vkbyCborAddl1Byte = 24;
+static const uint8_t vkbyCborAddl2Bytes = 25;
+static const uint8_t vkbyCborAddl4Bytes = 26;
+static const uint8_t vkbyCborAddl8Bytes = 27;
+static const uint8_t vkbyCborAddlIndefinite = 31;
+// Full initial bytes for major type 7:
+static const uint8_t vkbyCborFalse = 0xf4;
+static const uint8_t vkbyCborTrue = 0xf5;
+static const uint8_t vkbyCborNull = 0xf6;
+static const uint8_t vkbyCborUndefined = 0xf7;
+static const uint8_t vkbyCborFloat16 = 0xf9;
+static const uint8_t vkbyCborFloat32 = 0xfa;
+static const uint8_t vkbyCborFloat64 = 0xfb;
+static const uint8_t vkbyCborBreak = 0xff;
+
+// CborOutputStream:
+// Encode CBOR to the byte output stream t_tyByteOutputStream - any of the JSON output streams with a single byte character type.
+// We derive from it so that Open(), AttachFd(), Flush(), Close(), etc. are those of the byte stream.
+// Strings are encoded as UTF-8 whatever t_tyCharTraits is. JsonFormatSpec doesn't apply.
+template <class t_tyCharTraits, class t_tyByteOutputStream = JsonFileOutputStream<JsonCharTraits<char>, char>>
+class CborOutputStream : public t_tyByteOutputStream
+{
+  typedef CborOutputStream _tyThis;
+  typedef t_tyByteOutputStream _tyBase;
+  static_assert(sizeof(typename _tyBase::_tyCharTraits::_tyChar) == 1);
+public:
+  typedef t_tyCharTraits _tyCharTraits;
+  typedef typename _tyCharTraits::_tyChar _tyChar;
+  typedef typename _tyCharTraits::_tyLPCSTR _tyLPCSTR;
+  typedef typename _tyBase::_tyFilePos _tyFilePos;
+  typedef JsonFormatSpec<_tyCharTraits> _tyJsonFormatSpec;
+  static constexpr bool s_kfBinaryEncoding = true; // JsonValueLife calls the methods below instead of writing JSON text.
+
+  using _tyBase::_tyBase;
+
+  // The JSON text methods of the byte stream make no sense for us:
+  void WriteChar(_tyChar _tc) = delete;
+  void WriteRawChars(_tyLPCSTR _psz, ssize_t _sstLen = -1) = delete;
+  void WriteString(bool _fEscape, _tyLPCSTR _psz, ssize_t _sstLen = -1, const _tyJsonFormatSpec *_pjfs = 0) = delete;
+
+  void WriteBeginAggregate(EJsonValueType _jvt)
+  {
+    Assert((ejvtObject == _jvt) || (ejvtArray == _jvt));
+    _WriteByte(uint8_t(((ejvtObject == _jvt) ? ecmtMap : ecmtArray) << 5) | vkbyCborAddlIndefinite);
+  }
+  void WriteEndAggregate(EJsonValueType _jvt)
+  {
+    Assert((ejvtObject == _jvt) || (ejvtArray == _jvt));
+    _WriteByte(vkbyCborBreak);
+  }
+  void WriteKey(_tyLPCSTR _pcKey, size_t _stLen)
+  {
+    _WriteText(_pcKey, _stLen);
+  }
+  // Strings and numbers are passed as JSON text, numbers are converted to their native encoding.
+  void WriteSimpleValue(EJsonValueType _jvt, _tyLPCSTR _pcValue = 0, size_t _stLen = 0)
+  {
+    switch (_jvt)
+    {
+    case ejvtString:
+      _WriteText(_pcValue, _stLen);
+      break;
+    case ejvtNumber:
+      _WriteNumberText(_pcValue, _stLen);
+      break;
+    case ejvtTrue:
+      _WriteByte(vkbyCborTrue);
+      break;
+    case ejvtFalse:
+      _WriteByte(vkbyCborFalse);
+      break;
+    case ejvtNull:
+      _WriteByte(vkbyCborNull);
+      break;
+    default:
+      THROWBADJSONSEMANTICUSE("Unexpected value type [%d].", int(_jvt));
+      break;
+    }
+  }
+  template <class t_tyNum>
+  void WriteNumber(t_tyNum _num)
+  {
+    if constexpr (std::is_integral_v<t_tyNum>)
+    {
+      if (std::is_signed_v<t_tyNum> && (_num < 0))
+        _WriteHead(ecmtNegative, uint64_t(-(int64_t(_num) + 1)));
+      else
+        _WriteHead(ecmtUnsigned, uint64_t(_num));
+    }
+    else
+      _WriteDouble(double(_num)); // long double is narrowed to double.
+  }
+
+protected:
+  void _WriteByte(uint8_t _by)
+  {
+    _tyBase::WriteRawChars((const char *)&_by, 1);
+  }
+  void _WriteBytes(const void *_pv, size_t _stLen)
+  {
+    if (!!_stLen)
+      _tyBase::WriteRawChars((const char *)_pv, _stLen);
+  }
+  // Write the initial byte and argument in the shortest form.
+  void _WriteHead(ECborMajorType _ecmt, uint64_t _u)
+  {
+    uint8_t rgby[9];
+    size_t stLen;
+    rgby[0] = uint8_t(_ecmt << 5);
+    if (_u < vkbyCborAddl1Byte)
+    {
+      rgby[0] |= uint8_t(_u);
+      stLen = 1;
+    }
+    else if (_u <= UINT8_MAX)
+    {
+      rgby[0] |= vkbyCborAddl1Byte;
+      stLen = 2;
+    }
+    else if (_u <= UINT16_MAX)
+    {
+      rgby[0] |= vkbyCborAddl2Bytes;
+      stLen = 3;
+    }
+    else if (_u <= UINT32_MAX)
+    {
+      rgby[0] |= vkbyCborAddl4Bytes;
+      stLen = 5;
+    }
+    else
+    {
+      rgby[0] |= vkbyCborAddl8Bytes;
+      stLen = 9;
+    }
+    for (size_t st = stLen - 1; st > 0; --st, _u >>= 8) // big endian.
+      rgby[st] = uint8_t(_u);
+    _WriteBytes(rgby, stLen);
+  }
+  void _WriteText(_tyLPCSTR _pc, size_t _stLen)
+  {
+    if constexpr (sizeof(_tyChar) == 1)
+    {
+      _WriteHead(ecmtText, _stLen);
+      _WriteBytes(_pc, _stLen);
+    }
+    else
+    {
+      std::string strUtf8;
+      ConvertString(strUtf8, _pc, _stLen);
+      _WriteHead(ecmtText, strUtf8.length());
+      _WriteBytes(strUtf8.c_str(), strUtf8.length());
+    }
+  }
+  // Use single precision when it represents the value exactly - and half precision for negative zero so its sign survives a round trip.
+  void _WriteDouble(double _dbl)
+  {
+    uint8_t rgby[9];
+    size_t stLen;
+    if (!_dbl && std::signbit(_dbl))
+    {
+      rgby[0] = vkbyCborFloat16;
+      rgby[1] = 0x80;
+      rgby[2] = 0x00;
+      _WriteBytes(rgby, 3);
+      return;
+    }
+    bool fFloat = std::isnan(_dbl) || std::isinf(_dbl) || ((std::fabs(_dbl) <= FLT_MAX) && (double(float(_dbl)) == _dbl));
+    if (fFloat)
+    {
+      float flt = float(_dbl);
+      uint32_t u32;
+      memcpy(&u32, &flt, sizeof u32);
+      rgby[0] = vkbyCborFloat32;
+      for (size_t st = 4; st > 0; --st, u32 >>= 8)
+        rgby[st] = uint8_t(u32);
+      stLen = 5;
+    }
+    else
+    {
+      uint64_t u64;
+      memcpy(&u64, &_dbl, sizeof u64);
+      rgby[0] = vkbyCborFloat64;
+      for (size_t st = 8; st > 0; --st, u64 >>= 8)
+        rgby[st] = uint8_t(u64);
+      stLen = 9;
+    }
+    _WriteBytes(rgby, stLen);
+  }
+  // A JSON number as text - e.g. from JsonValue or WriteStrOrNumValue(). Integers that fit in 64 bits (plus sign) are encoded as
+  //  integers, anything else as floating point.
+  void _WriteNumberText(_tyLPCSTR _pc, size_t _stLen)
+  {
+    if (!_stLen)
+      THROWBADJSONSEMANTICUSE("Empty number.");
+    _tyLPCSTR pcCur = _pc;
+    _tyLPCSTR pcEnd = _pc + _stLen;
+    bool fNegative = (_tyCharTraits::s_tcMinus == *pcCur);
+    if (fNegative)
+      ++pcCur;
+    uint64_t u64Value = 0;
+    bool fOverflow = false;
+    for (; (pcEnd != pcCur) && (*pcCur >= _tyCharTraits::s_tc0) && (*pcCur <= _tyCharTraits::s_tc9); ++pcCur)
+    {
+      uint64_t u64Digit = uint64_t(*pcCur - _tyCharTraits::s_tc0);
+      fOverflow = fOverflow || (u64Value > ((UINT64_MAX - u64Digit) / 10));
+      u64Value = u64Value * 10 + u64Digit;
+    }
+    if ((pcEnd == pcCur) && !fOverflow && (pcCur != _pc + fNegative) && (!fNegative || !!u64Value)) // "-0" is written as floating point.
+    {
+      if (!fNegative)
+        _WriteHead(ecmtUnsigned, u64Value);
+      else
+        _WriteHead(ecmtNegative, u64Value - 1);
+      return;
+    }
+    double dbl;
+    JsonParseNumber<_tyCharTraits>(_pc, pcEnd, dbl);
+    _WriteDouble(dbl);
+  }
+};
+
+// CborInputStream:
+// Read CBOR from a file, a file descriptor or memory and present it to JsonReadCursor as JSON text.
+// Successive top-level data items are presented as a sequence of JSON documents separated by linefeeds.
+// ByPosGet() is the position within the JSON text presented - not within the CBOR.
+template <class t_tyCharTraits>
+class CborInputStream : public JsonInputStreamBase<t_tyCharTraits, size_t>
+{
+  typedef CborInputStream _tyThis;
+
+public:
+  typedef t_tyCharTraits _tyCharTraits;
+  typedef typename _tyCharTraits::_tyChar _tyChar;
+  typedef std::basic_string<_tyChar> _tyStdStrText;
+  typedef size_t _tyFilePos;
+  typedef JsonReadCursor<_tyThis> _tyJsonReadCursor;
+  static const size_t s_kstDefaultBlockSize = 65536;
+
+  CborInputStream() = default;
+  CborInputStream(CborInputStream const &) = delete;
+  CborInputStream &operator=(CborInputStream const &) = delete;
+
+  bool FOpened() const
+  {
+    return m_foFile.FIsOpen() || m_fMemory;
+  }
+  // Throws on open failure. This object owns the lifetime of the file descriptor.
+  void Open(const char *_szFilename)
+  {
+    (void)Close();
+    m_foFile.SetHFile(OpenReadOnlyFile(_szFilename));
+    if (!m_foFile.FIsOpen())
+      THROWBADJSONSTREAMERRNO(GetLastErrNo(), "Unable to OpenReadOnlyFile() file [%s]", _szFilename);
+    m_szFilename = _szFilename;
+  }
+  // Attach to an FD whose lifetime we do not own by default - e.g. stdin.
+  void AttachFd(vtyFileHandle _hFile, bool _fOwnFileLifetime = false)
+  {
+    Assert(_hFile != vkhInvalidFileHandle);
+    (void)Close();
+    m_foFile.SetHFile(_hFile, _fOwnFileLifetime);
+  }
+  // Read from memory that must remain valid while we are open.
+  void AttachMemory(const void *_pv, size_t _stLen)
+  {
+    (void)Close();
+    m_pbyCur = (const uint8_t *)_pv;
+    m_pbyEnd = m_pbyCur + _stLen;
+    m_fMemory = true;
+  }
+  int Close()
+  {
+    m_szFilename.clear();
+    m_pbyCur = m_pbyEnd = nullptr;
+    m_fMemory = false;
+    m_strText.clear();
+    m_stTextCur = 0;
+    m_rgContainers.clear();
+    m_fRootWritten = false;
+    m_pos = 0;
+    m_fHasLookahead = false;
+    return m_foFile.Close();
+  }
+  void SetBlockSize(size_t _stBlockSize)
+  {
+    Assert(!FOpened());
+    if (FOpened())
+      THROWBADJSONSEMANTICUSE("SetBlockSize() must be called before the stream is opened.");
+    m_stBlockSize = (std::max)(_stBlockSize, size_t(16));
+    m_rgbyBuffer.reset();
+  }
+  void AttachReadCursor(_tyJsonReadCursor &_rjrc)
+  {
+    Assert(!_rjrc.FAttached());
+    Assert(FOpened());
+    _rjrc.AttachRoot(*this);
+  }
+
+  // The JsonReadCursor interface - as JsonFileInputStream:
+  void SkipWhitespace()
+  {
+    Assert(FOpened());
+    if (m_fHasLookahead && !_tyCharTraits::FIsWhitespace(m_tcLookahead))
+      return;
+    for (;;)
+    {
+      if (!_FReadTextChar(m_tcLookahead))
+      {
+        m_fHasLookahead = false;
+        return;
+      }
+      if (!_tyCharTraits::FIsWhitespace(m_tcLookahead))
+      {
+        m_fHasLookahead = true;
+        return;
+      }
+    }
+  }
+  _tyFilePos ByPosGet() const
+  {
+    Assert(FOpened());
+    return m_pos - (m_fHasLookahead ? sizeof(_tyChar) : 0);
+  }
+  _tyChar ReadChar(const char *_pcEOFMessage)
+  {
+    Assert(FOpened());
+    if (m_fHasLookahead)
+    {
+      m_fHasLookahead = false;
+      return m_tcLookahead;
+    }
+    if (!_FReadTextChar(m_tcLookahead))
+      THROWBADJSONSTREAM("[%s]: %s", m_szFilename.c_str(), _pcEOFMessage);
+    return m_tcLookahead;
+  }
+  bool FReadChar(_tyChar &_rtch, bool _fThrowOnEOF, const char *_pcEOFMessage)
+  {
+    Assert(FOpened());
+    if (m_fHasLookahead)
+    {
+      _rtch = m_tcLookahead;
+      m_fHasLookahead = false;
+      return true;
+    }
+    if (!_FReadTextChar(m_tcLookahead))
+    {
+      if (_fThrowOnEOF)
+        THROWBADJSONSTREAM("[%s]: %s", m_szFilename.c_str(), _pcEOFMessage);
+      return false;
+    }
+    _rtch = m_tcLookahead;
+    return true;
+  }
+  void PushBackLastChar(bool _fMightBeWhitespace = false)
+  {
+    Assert(!m_fHasLookahead); // support single character lookahead only.
+    Assert(_fMightBeWhitespace || !_tyCharTraits::FIsWhitespace(m_tcLookahead));
+    if (!_tyCharTraits::FIsWhitespace(m_tcLookahead))
+      m_fHasLookahead = true;
+  }
+
+protected:
+  // An open map or array.
+  struct _CborContainer
+  {
+    uint64_t m_nRemaining; // Data items remaining when !m_fIndefinite - a map has two per entry.
+    uint64_t m_nItems{0};  // Data items begun so far.
+    bool m_fMap;
+    bool m_fIndefinite;
+  };
+
+  bool _FReadTextChar(_tyChar &_rtc)
+  {
+    if ((m_stTextCur == m_strText.length()) && !_FDecodeNext())
+      return false;
+    _rtc = m_strText[m_stTextCur++];
+    m_pos += sizeof(_tyChar);
+    return true;
+  }
+  // Decode CBOR until we have some JSON text in m_strText. Returns false at EOF between top-level data items.
+  bool _FDecodeNext()
+  {
+    m_strText.clear();
+    m_stTextCur = 0;
+    do
+    {
+      if (!m_rgContainers.empty() && !m_rgContainers.back().m_fIndefinite && !m_rgContainers.back().m_nRemaining)
+      {
+        _CloseContainer();
+        continue;
+      }
+      uint8_t byInitial;
+      if (!_FReadByte(byInitial))
+      {
+        if (!m_rgContainers.empty())
+          THROWBADJSONSTREAM("[%s]: EOF within a CBOR map or array.", m_szFilename.c_str());
+        return false;
+      }
+      while ((byInitial >> 5) == ecmtTag) // Tags are ignored.
+      {
+        (void)_U64ReadArgument(byInitial);
+        byInitial = _ByReadByte();
+      }
+      if (vkbyCborBreak == byInitial)
+      {
+        if (m_rgContainers.empty() || !m_rgContainers.back().m_fIndefinite)
+          THROWBADJSONSTREAM("[%s]: Unexpected CBOR break.", m_szFilename.c_str());
+        if (m_rgContainers.back().m_fMap && (m_rgContainers.back().m_nItems % 2))
+          THROWBADJSONSTREAM("[%s]: CBOR map key without a value.", m_szFilename.c_str());
+        _CloseContainer();
+        continue;
+      }
+      bool fKey = _FBeginItem();
+      _DecodeItem(byInitial, fKey);
+    } while (m_strText.empty());
+    return true;
+  }
+  // Write the separator before a data item, return if it is a map key.
+  bool _FBeginItem()
+  {
+    if (m_rgContainers.empty())
+    {
+      if (m_fRootWritten)
+        m_strText.push_back(_tyCharTraits::s_tcNewline);
+      return false;
+    }
+    _CborContainer &rcc = m_rgContainers.back();
+    bool fKey = rcc.m_fMap && !(rcc.m_nItems % 2);
+    if (rcc.m_fMap && !fKey)
+      m_strText.push_back(_tyCharTraits::s_tcColon);
+    else if (!!rcc.m_nItems)
+      m_strText.push_back(_tyCharTraits::s_tcComma);
+    ++rcc.m_nItems;
+    return fKey;
+  }
+  void _EndItem()
+  {
+    if (m_rgContainers.empty())
+      m_fRootWritten = true;
+    else if (!m_rgContainers.back().m_fIndefinite)
+      --m_rgContainers.back().m_nRemaining;
+  }
+  void _CloseContainer()
+  {
+    m_strText.push_back(m_rgContainers.back().m_fMap ? _tyCharTraits::s_tcRightCurlyBr : _tyCharTraits::s_tcRightSquareBr);
+    m_rgContainers.pop_back();
+    _EndItem();
+  }
+  void _DecodeItem(uint8_t _byInitial, bool _fKey)
+  {
+    ECborMajorType ecmt = ECborMajorType(_byInitial >> 5);
+    if (_fKey && (ecmtText != ecmt) && (ecmtUnsigned != ecmt) && (ecmtNegative != ecmt))
+      THROWBADJSONSTREAM("[%s]: CBOR map key of major type [%d] has no JSON equivalent.", m_szFilename.c_str(), int(ecmt));
+    switch (ecmt)
+    {
+    case ecmtUnsigned:
+    case ecmtNegative:
+    {
+      uint64_t u64 = _U64ReadArgument(_byInitial);
+      if (_fKey)
+        m_strText.push_back(_tyCharTraits::s_tcDoubleQuote);
+      if (ecmtUnsigned == ecmt)
+        _AppendNumber(u64);
+      else if (u64 < uint64_t(INT64_MAX))
+        _AppendNumber(-int64_t(u64) - 1);
+      else
+      { // Beyond int64_t - write the magnitude u64 + 1.
+        m_strText.push_back(_tyCharTraits::s_tcMinus);
+        if (UINT64_MAX == u64)
+          _AppendAscii("18446744073709551616");
+        else
+          _AppendNumber(u64 + 1);
+      }
+      if (_fKey)
+        m_strText.push_back(_tyCharTraits::s_tcDoubleQuote);
+    }
+    break;
+    case ecmtBytes:
+    {
+      std::string strBytes;
+      _ReadString(_byInitial, strBytes);
+      m_strText.push_back(_tyCharTraits::s_tcDoubleQuote);
+      _AppendBase64Url(strBytes);
+      m_strText.push_back(_tyCharTraits::s_tcDoubleQuote);
+    }
+    break;
+    case ecmtText:
+    {
+      std::string strUtf8;
+      _ReadString(_byInitial, strUtf8);
+      _AppendJsonString(strUtf8);
+    }
+    break;
+    case ecmtArray:
+    case ecmtMap:
+    {
+      _CborContainer cc;
+      cc.m_fMap = (ecmtMap == ecmt);
+      cc.m_fIndefinite = (vkbyCborAddlIndefinite == (_byInitial & 0x1f));
+      cc.m_nRemaining = 0;
+      if (!cc.m_fIndefinite)
+      {
+        uint64_t u64Count = _U64ReadArgument(_byInitial);
+        if (cc.m_fMap && (u64Count > (UINT64_MAX / 2)))
+          THROWBADJSONSTREAM("[%s]: CBOR map count [%llu] is invalid.", m_szFilename.c_str(), (unsigned long long)u64Count);
+        cc.m_nRemaining = cc.m_fMap ? (u64Count * 2) : u64Count;
+      }
+      m_strText.push_back(cc.m_fMap ? _tyCharTraits::s_tcLeftCurlyBr : _tyCharTraits::s_tcLeftSquareBr);
+      m_rgContainers.push_back(cc);
+    }
+    return; // _EndItem() is called when the map or array is closed.
+    case ecmtSimple:
+      _DecodeSimple(_byInitial);
+      break;
+    default:
+      Assert(0);
+      break;
+    }
+    _EndItem();
+  }
+  void _DecodeSimple(uint8_t _byInitial)
+  {
+    double dbl;
+    switch (_byInitial)
+    {
+    case vkbyCborFalse:
+      _AppendAscii("false");
+      return;
+    case vkbyCborTrue:
+      _AppendAscii("true");
+      return;
+    case vkbyCborNull:
+    case vkbyCborUndefined:
+      _AppendAscii("null");
+      return;
+    case vkbyCborFloat16:
+    {
+      uint16_t u16 = uint16_t(_U64ReadBigEndian(2));
+      int nExp = (u16 >> 10) & 0x1f;
+      double dblMant = u16 & 0x3ff;
+      if (!nExp)
+        dbl = std::ldexp(dblMant, -24);
+      else if (31 == nExp)
+        dbl = !dblMant ? INFINITY : NAN;
+      else
+        dbl = std::ldexp(dblMant + 1024, nExp - 25);
+      if (u16 & 0x8000)
+        dbl = -dbl;
+    }
+    break;
+    case vkbyCborFloat32:
+    {
+      uint32_t u32 = uint32_t(_U64ReadBigEndian(4));
+      float flt;
+      memcpy(&flt, &u32, sizeof flt);
+      dbl = flt;
+    }
+    break;
+    case vkbyCborFloat64:
+    {
+      uint64_t u64 = _U64ReadBigEndian(8);
+      memcpy(&dbl, &u64, sizeof dbl);
+    }
+    break;
+    default:
+      THROWBADJSONSTREAM("[%s]: CBOR simple value [0x%02x] has no JSON equivalent.", m_szFilename.c_str(), unsigned(_byInitial));
+      break;
+    }
+    if (!std::isfinite(dbl))
+      _AppendAscii("null");
+    else
+      _AppendNumber(dbl);
+  }
+  template <class t_tyNum>
+  void _AppendNumber(t_tyNum _num)
+  {
+    _tyChar rgcNum[64];
+    size_t stLen = JsonNumber_StFormat<_tyCharTraits>(_num, rgcNum, sizeof rgcNum / sizeof rgcNum[0]);
+    m_strText.append(rgcNum, stLen);
+  }
+  void _AppendAscii(const char *_psz)
+  {
+    for (; !!*_psz; ++_psz)
+      m_strText.push_back(_tyChar(*_psz));
+  }
+  void _AppendJsonString(std::string const &_rstrUtf8)
+  {
+    static const char s_rgcHex[] = "0123456789abcdef";
+    _tyStdStrText strConvert;
+    const _tyChar *pcCur;
+    const _tyChar *pcEnd;
+    if constexpr (sizeof(_tyChar) == 1)
+    {
+      pcCur = (const _tyChar *)_rstrUtf8.c_str();
+      pcEnd = pcCur + _rstrUtf8.length();
+    }
+    else
+    {
+      ConvertString(strConvert, _rstrUtf8.c_str(), _rstrUtf8.length());
+      pcCur = strConvert.c_str();
+      pcEnd = pcCur + strConvert.length();
+    }
+    m_strText.push_back(_tyCharTraits::s_tcDoubleQuote);
+    for (; pcEnd != pcCur; ++pcCur)
+    {
+      _tyChar tc = *pcCur;
+      if ((_tyCharTraits::s_tcDoubleQuote == tc) || (_tyCharTraits::s_tcBackSlash == tc))
+      {
+        m_strText.push_back(_tyCharTraits::s_tcBackSlash);
+        m_strText.push_back(tc);
+      }
+      else if (std::make_unsigned_t<_tyChar>(tc) < 0x20)
+      {
+        m_strText.push_back(_tyCharTraits::s_tcBackSlash);
+        m_strText.push_back(_tyCharTraits::s_tcu);
+        _AppendAscii("00");
+        m_strText.push_back(_tyChar(s_rgcHex[tc >> 4]));
+        m_strText.push_back(_tyChar(s_rgcHex[tc & 0xf]));
+      }
+      else
+        m_strText.push_back(tc);
+    }
+    m_strText.push_back(_tyCharTraits::s_tcDoubleQuote);
+  }
+  void _AppendBase64Url(std::string const &_rstrBytes)
+  {
+    static const char s_rgcBase64Url[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+    const uint8_t *pbyCur = (const uint8_t *)_rstrBytes.c_str();
+    size_t stLeft = _rstrBytes.length();
+    for (; stLeft >= 3; stLeft -= 3, pbyCur += 3)
+    {
+      uint32_t u = (uint32_t(pbyCur[0]) << 16) | (uint32_t(pbyCur[1]) << 8) | pbyCur[2];
+      for (int nShift = 18; nShift >= 0; nShift -= 6)
+        m_strText.push_back(_tyChar(s_rgcBase64Url[(u >> nShift) & 0x3f]));
+    }
+    if (!!stLeft) // No padding.
+    {
+      uint32_t u = (uint32_t(pbyCur[0]) << 16) | ((2 == stLeft) ? (uint32_t(pbyCur[1]) << 8) : 0);
+      for (int nShift = 18, nChars = int(stLeft) + 1; nChars--; nShift -= 6)
+        m_strText.push_back(_tyChar(s_rgcBase64Url[(u >> nShift) & 0x3f]));
+    }
+  }
+
+  // Read the argument of the initial byte.
+  uint64_t _U64ReadArgument(uint8_t _byInitial)
+  {
+    uint8_t byAddl = _byInitial & 0x1f;
+    if (byAddl < vkbyCborAddl1Byte)
+      return byAddl;
+    if (byAddl > vkbyCborAddl8Bytes)
+      THROWBADJSONSTREAM("[%s]: Invalid CBOR initial byte [0x%02x].", m_szFilename.c_str(), unsigned(_byInitial));
+    return _U64ReadBigEndian(size_t(1) << (byAddl - vkbyCborAddl1Byte));
+  }
+  uint64_t _U64ReadBigEndian(size_t _stBytes)
+  {
+    uint64_t u64 = 0;
+    for (; _stBytes--;)
+      u64 = (u64 << 8) | _ByReadByte();
+    return u64;
+  }
+  // Read a byte or text string of major type (_byInitial >> 5), including indefinite length strings made of chunks.
+  void _ReadString(uint8_t _byInitial, std::string &_rstr)
+  {
+    if (vkbyCborAddlIndefinite != (_byInitial & 0x1f))
+    {
+      _ReadBytes(_U64ReadArgument(_byInitial), _rstr);
+      return;
+    }
+    for (;;)
+    {
+      uint8_t byChunk = _ByReadByte();
+      if (vkbyCborBreak == byChunk)
+        return;
+      if (((byChunk >> 5) != (_byInitial >> 5)) || (vkbyCborAddlIndefinite == (byChunk & 0x1f)))
+        THROWBADJSONSTREAM("[%s]: Invalid CBOR string chunk [0x%02x].", m_szFilename.c_str(), unsigned(byChunk));
+      _ReadBytes(_U64ReadArgument(byChunk), _rstr);
+    }
+  }
+  void _ReadBytes(uint64_t _u64Len, std::string &_rstr)
+  {
+    while (!!_u64Len)
+    {
+      if ((m_pbyCur == m_pbyEnd) && !_FFillBuffer())
+        THROWBADJSONSTREAM("[%s]: EOF within a CBOR string.", m_szFilename.c_str());
+      size_t stCopy = size_t((std::min)(_u64Len, uint64_t(m_pbyEnd - m_pbyCur)));
+      _rstr.append((const char *)m_pbyCur, stCopy);
+      m_pbyCur += stCopy;
+      _u64Len -= stCopy;
+    }
+  }
+  uint8_t _ByReadByte()
+  {
+    uint8_t by;
+    if (!_FReadByte(by))
+      THROWBADJSONSTREAM("[%s]: EOF within a CBOR data item.", m_szFilename.c_str());
+    return by;
+  }
+  bool _FReadByte(uint8_t &_rby)
+  {
+    if ((m_pbyCur == m_pbyEnd) && !_FFillBuffer())
+      return false;
+    _rby = *m_pbyCur++;
+    return true;
+  }
+  bool _FFillBuffer()
+  {
+    if (m_fMemory)
+      return false;
+    Assert(m_foFile.FIsOpen());
+    if (!m_rgbyBuffer)
+      m_rgbyBuffer = std::make_unique<uint8_t[]>(m_stBlockSize);
+    uint64_t u64Read;
+    int iReadResult = FileRead(m_foFile.HFileGet(), m_rgbyBuffer.get(), m_stBlockSize, &u64Read);
+    if (-1 == iReadResult)
+      THROWBADJSONSTREAMERRNO(GetLastErrNo(), "FileRead() failed for file [%s]", m_szFilename.c_str());
+    m_pbyCur = m_rgbyBuffer.get();
+    m_pbyEnd = m_pbyCur + u64Read;
+    return !!u64Read;
+  }
+
+  std::string m_szFilename;
+  FileObj m_foFile;
+  std::unique_ptr<uint8_t[]> m_rgbyBuffer; // Allocated upon first read from a file.
+  size_t m_stBlockSize{s_kstDefaultBlockSize};
+  const uint8_t *m_pbyCur{nullptr}; // The CBOR yet to be decoded - within m_rgbyBuffer or the attached memory.
+  const uint8_t *m_pbyEnd{nullptr};
+  bool m_fMemory{false};
+  std::vector<_CborContainer> m_rgContainers;
+  bool m_fRootWritten{false}; // A top-level data item has been completed.
+  _tyStdStrText m_strText;    // JSON text decoded and not yet read.
+  size_t m_stTextCur{0};
+  _tyFilePos m_pos{0}; // The number of bytes of JSON text read.
+  _tyChar m_tcLookahead{0};
+  bool m_fHasLookahead{false};
+};
+
+__BIENUTIL_END_NAMESPACE
@@ -0,0 +1,290 @@
+#pragma once
+
+//          Copyright David Lawrence Bien 1997 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt).
+
+// jsondocs.h
+// Read a file (or memory) containing a sequence of top-level JSON documents - JSON Lines or just concatenated documents.
+// The calling thread finds the document boundaries and a pool of worker threads reads the documents, each with its own JsonReadCursor.
+
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <vector>
+#include <exception>
+#include <type_traits>
+#include "jsonstrm.h"
+
+__BIENUTIL_BEGIN_NAMESPACE
+
+// How documents are separated in the input:
+enum EJsonDocumentBoundary : uint8_t
+{
+  ejdbNewline,      // JSON Lines - each non-blank line is a document.
+  ejdbConcatenated, // Documents follow one another, separated by optional whitespace. Objects and arrays are bracket-balanced to find their end.
+  ejdbJsonDocumentBoundaryCount
+};
+
+// JsonDocumentReader:
+// Hand each document in the input to a callback on a pool of worker threads.
+// NReadDocuments() calls the callback in no particular order.
+// NReadDocumentsOrdered() runs a process callback concurrently and then passes its result to a deliver callback in document order.
+// The first exception thrown by a callback or while reading a document stops the read and is rethrown on the calling thread.
+template <class t_tyCharTraits>
+class JsonDocumentReader
+{
+  typedef JsonDocumentReader _tyThis;
+public:
+  typedef t_tyCharTraits _tyCharTraits;
+  typedef typename _tyCharTraits::_tyChar _tyChar;
+  static_assert(std::is_same_v<_tyChar, typename _tyCharTraits::_tyPersistAsChar>, "JsonDocumentReader reads documents in place and requires that characters persist as themselves.");
+  typedef JsonFixedMemInputStream<_tyCharTraits> _tyJsonInputStream;
+  typedef JsonReadCursor<_tyJsonInputStream> _tyJsonReadCursor;
+  typedef JsonMemMappedInputStream<_tyCharTraits> _tyJsonMemMappedInputStream;
+  static const size_t s_knDocumentsInFlightPerThread = 16; // Limit how far the calling thread gets ahead of the workers.
+
+  JsonDocumentReader() = default;
+  JsonDocumentReader(JsonDocumentReader const &) = delete;
+  JsonDocumentReader &operator=(JsonDocumentReader const &) = delete;
+
+  bool FOpened() const
+  {
+    return !!m_pcBegin;
+  }
+  // Map the file _szFilename. Throws on failure.
+  void Open(const char *_szFilename, EJsonDocumentBoundary _ejdb = ejdbNewline)
+  {
+    Close();
+    m_jmmis.Open(_szFilename);
+    m_pcBegin = m_jmmis.PcpxBegin();
+    m_pcEnd = m_jmmis.PcpxEnd();
+    m_ejdb = _ejdb;
+  }
+  // Read documents from memory owned by the caller.
+  void Open(const _tyChar *_pcBegin, size_t _nChars, EJsonDocumentBoundary _ejdb = ejdbNewline)
+  {
+    Close();
+    m_pcBegin = _pcBegin;
+    m_pcEnd = _pcBegin + _nChars;
+    m_ejdb = _ejdb;
+  }
+  void Close()
+  {
+    if (m_jmmis.FOpened())
+      (void)m_jmmis.Close();
+    m_pcBegin = m_pcEnd = nullptr;
+  }
+  // The number of worker threads - zero means use as many as there are hardware threads.
+  void SetThreads(size_t _nThreads)
+  {
+    m_nThreads = _nThreads;
+  }
+  size_t NGetThreads() const
+  {
+    return !m_nThreads ? (std::max)(std::thread::hardware_concurrency(), 1u) : m_nThreads;
+  }
+
+  // Call _rrfnProcess( _tyJsonReadCursor & _jrc, size_t _nDocument ) for each document concurrently, in no particular order.
+  // Returns the number of documents read.
+  template <class t_tyFnProcess>
+  size_t NReadDocuments(t_tyFnProcess &&_rrfnProcess)
+  {
+    auto fnDeliverNone = [](size_t, int) {};
+    return _NReadDocuments<false>(_rrfnProcess, fnDeliverNone);
+  }
+  // Call _rrfnProcess( _tyJsonReadCursor & _jrc, size_t _nDocument ) for each document concurrently and then
+  //  call _rrfnDeliver( size_t _nDocument, _tyResult && _rrResult ) with its result in document order. Calls to _rrfnDeliver() are serialized.
+  // Returns the number of documents read.
+  template <class t_tyFnProcess, class t_tyFnDeliver>
+  size_t NReadDocumentsOrdered(t_tyFnProcess &&_rrfnProcess, t_tyFnDeliver &&_rrfnDeliver)
+  {
+    return _NReadDocuments<true>(_rrfnProcess, _rrfnDeliver);
+  }
+
+  // Find the end of the document starting at _pcCur, or return null if there are no more documents.
+  // _rpcDocBegin is set to the first character of the document.
+  const _tyChar *PcFindDocumentEnd(const _tyChar *_pcCur, const _tyChar *&_rpcDocBegin) const
+  {
+    Assert(FOpened());
+    _pcCur = n_JsonScan::PcScan(n_JsonScan::eskNonWhitespace, _pcCur, m_pcEnd); // This also skips blank lines.
+    if (m_pcEnd == _pcCur)
+      return nullptr;
+    _rpcDocBegin = _pcCur;
+    if (ejdbNewline == m_ejdb)
+    {
+      const _tyChar tcNewline = _tyCharTraits::s_tcNewline;
+      for (; (m_pcEnd != _pcCur) && (tcNewline != *_pcCur); ++_pcCur)
+        ;
+      return _pcCur;
+    }
+    if (_tyCharTraits::s_tcDoubleQuote == *_pcCur)
+      return _PcSkipString(_pcCur + 1);
+    if ((_tyCharTraits::s_tcLeftCurlyBr != *_pcCur) && (_tyCharTraits::s_tcLeftSquareBr != *_pcCur))
+    {
+      // A number or literal - these end at whitespace or at the start of the next document.
+      for (; (m_pcEnd != _pcCur) && !_tyCharTraits::FIsWhitespace(*_pcCur) && !n_JsonScan::FIsMatch(n_JsonScan::eskStructural, *_pcCur); ++_pcCur)
+        ;
+      if (_rpcDocBegin == _pcCur)
+        THROWBADJSONSTREAM("Found [%TC] when looking for the start of a document at offset [%zu].", *_pcCur, size_t(_pcCur - m_pcBegin));
+      return _pcCur;
+    }
+    size_t nDepth = 0;
+    for (;;)
+    {
+      _pcCur = n_JsonScan::PcScan(n_JsonScan::eskStructural, _pcCur, m_pcEnd);
+      if (m_pcEnd == _pcCur)
+        THROWBADJSONSTREAM("EOF found looking for the end of document at offset [%zu].", size_t(_rpcDocBegin - m_pcBegin));
+      _tyChar tcCur = *_pcCur++;
+      if (_tyCharTraits::s_tcDoubleQuote == tcCur)
+        _pcCur = _PcSkipString(_pcCur);
+      else if ((_tyCharTraits::s_tcLeftCurlyBr == tcCur) || (_tyCharTraits::s_tcLeftSquareBr == tcCur))
+        ++nDepth;
+      else if (((_tyCharTraits::s_tcRightCurlyBr == tcCur) || (_tyCharTraits::s_tcRightSquareBr == tcCur)) && !--nDepth)
+        return _pcCur;
+    }
+  }
+
+protected:
+  // _pcCur is just after the opening double quote of a string - return the position just after its closing double quote.
+  const _tyChar *_PcSkipString(const _tyChar *_pcCur) const
+  {
+    for (;;)
+    {
+      _pcCur = n_JsonScan::PcScan(n_JsonScan::eskStringSpecial, _pcCur, m_pcEnd);
+      if (m_pcEnd == _pcCur)
+        THROWBADJSONSTREAM("EOF found looking for end of string.");
+      if (_tyCharTraits::s_tcDoubleQuote == *_pcCur)
+        return _pcCur + 1;
+      if (_tyCharTraits::s_tcBackSlash == *_pcCur)
+        _pcCur = (std::min)(_pcCur + 2, m_pcEnd);
+      else
+        ++_pcCur; // Illegal null - the document's cursor will complain about it.
+    }
+  }
+  struct _Document
+  {
+    const _tyChar *m_pcBegin;
+    const _tyChar *m_pcEnd;
+    size_t m_nDocument;
+  };
+  template <bool t_kfOrdered, class t_tyFnProcess, class t_tyFnDeliver>
+  size_t _NReadDocuments(t_tyFnProcess &_rfnProcess, t_tyFnDeliver &_rfnDeliver)
+  {
+    Assert(FOpened());
+    typedef std::invoke_result_t<t_tyFnProcess &, _tyJsonReadCursor &, size_t> _tyResult;
+    typedef std::conditional_t<t_kfOrdered, _tyResult, int> _tyResultStore;
+    const size_t knThreads = NGetThreads();
+    const size_t knMaxInFlight = knThreads * s_knDocumentsInFlightPerThread;
+    std::mutex mtx; // protects all of the below.
+    std::condition_variable cvWork;
+    std::condition_variable cvSpace;
+    std::deque<_Document> dqDocuments;
+    size_t nDocumentsQueued = 0;
+    size_t nDocumentsDone = 0; // For ordered reads this is the number delivered.
+    bool fNoMoreDocuments = false;
+    std::exception_ptr expFirst;
+    std::mutex mtxDeliver; // Serializes delivery - protects mapPending.
+    std::map<size_t, _tyResultStore> mapPending;
+    size_t nNextDeliver = 0;
+
+    auto lambdaSetException = [&]()
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      if (!expFirst)
+        expFirst = std::current_exception();
+      cvWork.notify_all();
+      cvSpace.notify_all();
+    };
+    auto lambdaWorker = [&]()
+    {
+      _tyJsonReadCursor jrc; // Reused across documents so that it recycles its contexts and values.
+      for (;;)
+      {
+        _Document doc;
+        { // B
+          std::unique_lock<std::mutex> lock(mtx);
+          cvWork.wait(lock, [&]() { return !dqDocuments.empty() || fNoMoreDocuments || !!expFirst; });
+          if (!!expFirst || dqDocuments.empty())
+            return;
+          doc = dqDocuments.front();
+          dqDocuments.pop_front();
+        } // EB
+        try
+        {
+          size_t nDone = 1;
+          _tyJsonInputStream jis(doc.m_pcBegin, doc.m_pcEnd - doc.m_pcBegin);
+          jis.AttachReadCursor(jrc);
+          if constexpr (t_kfOrdered)
+          {
+            _tyResult result = _rfnProcess(jrc, doc.m_nDocument);
+            jrc.Detach();
+            std::unique_lock<std::mutex> lockDeliver(mtxDeliver);
+            mapPending.emplace(doc.m_nDocument, std::move(result));
+            for (nDone = 0; !mapPending.empty() && (nNextDeliver == mapPending.begin()->first); ++nNextDeliver, ++nDone)
+            {
+              _rfnDeliver(nNextDeliver, std::move(mapPending.begin()->second));
+              mapPending.erase(mapPending.begin());
+            }
+          }
+          else
+          {
+            _rfnProcess(jrc, doc.m_nDocument);
+            jrc.Detach();
+          }
+          if (nDone)
+          {
+            std::unique_lock<std::mutex> lock(mtx);
+            nDocumentsDone += nDone;
+            cvSpace.notify_one();
+          }
+        }
+        catch (...)
+        {
+          lambdaSetException();
+          return;
+        }
+      }
+    };
+
+    { // B
+      std::vector<ScopedThread> rgthrWorkers;
+      rgthrWorkers.reserve(knThreads);
+      for (size_t nThread = 0; nThread < knThreads; ++nThread)
+        rgthrWorkers.emplace_back(lambdaWorker);
+      try
+      {
+        const _tyChar *pcDocBegin;
+        for (const _tyChar *pcCur = m_pcBegin; !!(pcCur = PcFindDocumentEnd(pcCur, pcDocBegin));)
+        {
+          std::unique_lock<std::mutex> lock(mtx);
+          cvSpace.wait(lock, [&]() { return (nDocumentsQueued - nDocumentsDone < knMaxInFlight) || !!expFirst; });
+          if (!!expFirst)
+            break;
+          dqDocuments.push_back({pcDocBegin, pcCur, nDocumentsQueued++});
+          cvWork.notify_one();
+        }
+        std::unique_lock<std::mutex> lock(mtx);
+        fNoMoreDocuments = true;
+        cvWork.notify_all();
+      }
+      catch (...)
+      {
+        lambdaSetException();
+      }
+    } // EB - join the workers.
+    if (!!expFirst)
+      std::rethrow_exception(expFirst);
+    return nDocumentsQueued;
+  }
+
+  _tyJsonMemMappedInputStream m_jmmis; // Only used when we have mapped a file.
+  const _tyChar *m_pcBegin{nullptr};
+  const _tyChar *m_pcEnd{nullptr};
+  size_t m_nThreads{0};
+  EJsonDocumentBoundary m_ejdb{ejdbNewline};
+};
+
+__BIENUTIL_END_NAMESPACE
@@ -0,0 +1,325 @@
+#pragma once
+
+//          Copyright David Lawrence Bien 1997 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt).
+
+// jsonlazy.h
+// Read-only JSON values over in-memory (usually memory mapped) JSON that are parsed only when accessed.
+// JsoLazyDocument maps a file (or references memory) and presents its root as a JsoLazyValue. Accessing an element of an object or
+//  array reads that level up to the element - the type and position of each element are recorded and the elements' values are skipped.
+//  So reading a nested value parses only the objects and arrays along its path, and those only as far as the path leads.
+// Values that are skipped are still scanned (and validated) by JsonReadCursor. When many lookups will be made BuildStructuralIndex()
+//  builds the index of the whole JSON in parallel once and then skipped values are jumped over without being scanned.
+
+#include <memory>
+#include <map>
+#include <deque>
+#include "jsonobjs.h"
+
+__BIENUTIL_BEGIN_NAMESPACE
+
+template <class t_tyChar, class t_tyObjectStorage = JsoObjectStorageMap>
+class JsoLazyDocument;
+
+// JsoLazyValue:
+// A value within a JsoLazyDocument - its type and the position of its value in the JSON are known, the value is read on demand.
+// Objects and arrays are parsed incrementally - a lookup by key or index reads elements only until it finds the element and GetSize()
+//  or iteration (RObjectGet(), RArrayGet()) reads the remainder. The elements are themselves JsoLazyValues.
+// Scalars are read via RJvGet() which materializes the value, or for an aggregate the entire subtree, into a JsoValue.
+// Since a level may grow after references to its elements have been returned the elements are kept in std::map<> and std::deque<>,
+//  which don't move them. t_tyObjectStorage applies to the JsoValues returned by RJvGet().
+// Everything parsed is kept by the value. This isn't thread safe - const access modifies the cache.
+template <class t_tyChar, class t_tyObjectStorage = JsoObjectStorageMap>
+class JsoLazyValue
+{
+  typedef JsoLazyValue _tyThis;
+  friend JsoLazyDocument<t_tyChar, t_tyObjectStorage>;
+
+public:
+  typedef t_tyChar _tyChar;
+  typedef JsonCharTraits<_tyChar> _tyCharTraits;
+  typedef const _tyChar *_tyLPCSTR;
+  typedef JsonFixedMemInputStream<_tyCharTraits> _tyJsonInputStream;
+  static_assert(std::is_same_v<_tyChar, typename _tyJsonInputStream::_tyPersistAsChar>, "JsoLazyValue reads the JSON in place - it must be stored as t_tyChar.");
+  typedef JsonReadCursor<_tyJsonInputStream> _tyJsonReadCursor;
+  typedef typename _tyJsonInputStream::_tyFilePos _tyFilePos;
+  typedef JsoValue<_tyChar, t_tyObjectStorage> _tyJsoValue;
+  typedef typename _tyJsoValue::_tyStrWRsv _tyStrWRsv;
+  typedef std::map<_tyStrWRsv, _tyThis> _tyLazyObject;
+  typedef std::deque<_tyThis> _tyLazyArray;
+
+  JsoLazyValue() = default;
+  JsoLazyValue(const _tyJsonInputStream &_rjis, _tyFilePos _posValue, EJsonValueType _jvt)
+      : m_pjis(&_rjis),
+        m_posValue(_posValue),
+        m_jvt(_jvt)
+  {
+  }
+  ~JsoLazyValue() = default;
+  JsoLazyValue(JsoLazyValue const &) = delete;
+  JsoLazyValue &operator=(JsoLazyValue const &) = delete;
+  JsoLazyValue(JsoLazyValue &&) = default;
+  JsoLazyValue &operator=(JsoLazyValue &&) = default;
+
+  EJsonValueType JvtGetValueType() const
+  {
+    return m_jvt;
+  }
+  bool FIsObject() const
+  {
+    return ejvtObject == m_jvt;
+  }
+  bool FIsArray() const
+  {
+    return ejvtArray == m_jvt;
+  }
+  bool FIsAggregate() const
+  {
+    return FIsObject() || FIsArray();
+  }
+  // The byte position of the value within the JSON.
+  _tyFilePos PosGetValue() const
+  {
+    return m_posValue;
+  }
+  // Whether any of the value has been read yet.
+  bool FParsed() const
+  {
+    return !!m_upObject || !!m_upArray || !!m_upjvValue;
+  }
+
+  size_t GetSize() const
+  {
+    if (!FIsAggregate())
+      THROWJSONBADUSAGE("Called on non-aggregate.");
+    return FIsObject() ? RObjectGet().size() : RArrayGet().size();
+  }
+  // These read the entire level.
+  const _tyLazyObject &RObjectGet() const
+  {
+    if (!FIsObject())
+      THROWJSONBADUSAGE("Not an object.");
+    for (_StartParse(); !!_PjlvParseNextEl();)
+      ;
+    return *m_upObject;
+  }
+  const _tyLazyArray &RArrayGet() const
+  {
+    if (!FIsArray())
+      THROWJSONBADUSAGE("Not an array.");
+    for (_StartParse(); !!_PjlvParseNextEl();)
+      ;
+    return *m_upArray;
+  }
+  // Throws if there is no such el.
+  const _tyThis &operator[](size_t _st) const
+  {
+    return GetEl(_st);
+  }
+  const _tyThis &GetEl(size_t _st) const
+  {
+    if (!FIsArray())
+      THROWJSONBADUSAGE("Not an array.");
+    _StartParse();
+    while ((_st >= m_upArray->size()) && !!_PjlvParseNextEl())
+      ;
+    if (_st >= m_upArray->size())
+      THROWJSONBADUSAGE("_st[%zu] exceeds array size[%zu].", _st, m_upArray->size());
+    return (*m_upArray)[_st];
+  }
+  const _tyThis &operator[](_tyLPCSTR _psz) const
+  {
+    return GetEl(_psz);
+  }
+  const _tyThis &GetEl(_tyLPCSTR _psz) const
+  {
+    const _tyThis *pjlv = PGetEl(_psz);
+    if (!pjlv)
+      THROWJSONBADUSAGE("No such key [%s]", _psz);
+    return *pjlv;
+  }
+  // Returns nullptr if there is no such el.
+  const _tyThis *PGetEl(_tyLPCSTR _psz) const
+  {
+    if (!FIsObject())
+      THROWJSONBADUSAGE("Not an object.");
+    _StartParse();
+    typename _tyLazyObject::const_iterator cit = m_upObject->find(_psz);
+    if (m_upObject->end() != cit)
+      return &cit->second;
+    _tyLPCSTR pszKey;
+    for (const _tyThis *pjlv; !!(pjlv = _PjlvParseNextEl(&pszKey));)
+    {
+      if (0 == ICompareStr(pszKey, _psz))
+        return pjlv;
+    }
+    return nullptr;
+  }
+
+  // Read the value - for an aggregate the entire subtree - into a JsoValue.
+  const _tyJsoValue &RJvGet() const
+  {
+    if (!m_upjvValue)
+    {
+      _tyJsonInputStream jis;
+      _tyJsonReadCursor jrc;
+      _AttachReadCursor(jis, jrc);
+      std::unique_ptr<_tyJsoValue> upjv = std::make_unique<_tyJsoValue>(jrc.JvtGetValueType());
+      upjv->FromJSONStream(jrc);
+      m_upjvValue.swap(upjv);
+    }
+    return *m_upjvValue;
+  }
+  template <class t_tyValue>
+  void GetValue(t_tyValue &_rv) const
+  {
+    RJvGet().GetValue(_rv);
+  }
+
+protected:
+  // The state of a partially read object or array - a read cursor within it.
+  struct _ParseState
+  {
+    _tyJsonInputStream m_jis;
+    _tyJsonReadCursor m_jrc;
+    bool m_fReadCurrent{false}; // We have recorded the element the cursor is at.
+  };
+  // Attach _rjrc to a copy of the document's stream positioned at our value. Copies share any structural index.
+  void _AttachReadCursor(_tyJsonInputStream &_rjis, _tyJsonReadCursor &_rjrc) const
+  {
+    if (!m_pjis)
+      THROWJSONBADUSAGE("Value isn't within a document.");
+    _rjis = *m_pjis;
+    _rjis.Seek(m_posValue);
+    _rjis.AttachReadCursor(_rjrc);
+    Assert(m_jvt == _rjrc.JvtGetValueType());
+  }
+  void _StartParse() const
+  {
+    if (!!m_upObject || !!m_upArray)
+      return;
+    std::unique_ptr<_ParseState> upps = std::make_unique<_ParseState>();
+    _AttachReadCursor(upps->m_jis, upps->m_jrc);
+    if (!upps->m_jrc.FMoveDown())
+      THROWJSONBADUSAGE("FMoveDown() returned false unexpectedly.");
+    if (FIsObject())
+      m_upObject = std::make_unique<_tyLazyObject>();
+    else
+      m_upArray = std::make_unique<_tyLazyArray>();
+    m_upps.swap(upps);
+  }
+  // Record the next element of the aggregate, returning it and, for an object, its key. Returns nullptr once the aggregate has been read.
+  const _tyThis *_PjlvParseNextEl(_tyLPCSTR *_ppszKey = nullptr) const
+  {
+    if (!m_upps)
+      return nullptr;
+    _tyJsonReadCursor &rjrc = m_upps->m_jrc;
+    if (m_upps->m_fReadCurrent)
+      (void)rjrc.FNextElement(); // This skips the value of the element we recorded.
+    if (rjrc.FAtEndOfAggregate())
+    {
+      m_upps.reset();
+      return nullptr;
+    }
+    m_upps->m_fReadCurrent = true;
+    if (FIsObject())
+    {
+      EJsonValueType jvt;
+      typename _tyJsonReadCursor::_tyStringView svKey = rjrc.SvKey(&jvt);
+      _tyStrWRsv strKey;
+      strKey.assign(svKey.data(), svKey.length());
+      std::pair<typename _tyLazyObject::iterator, bool> pib = m_upObject->try_emplace(std::move(strKey), *m_pjis, rjrc.GetCurrentContext().PosStartValue(), jvt);
+      if (!pib.second) // key already exists.
+        THROWBADJSONSTREAM("Duplicate key found[%s].", pib.first->first.c_str());
+      if (!!_ppszKey)
+        *_ppszKey = pib.first->first.c_str();
+      return &pib.first->second;
+    }
+    return &m_upArray->emplace_back(*m_pjis, rjrc.GetCurrentContext().PosStartValue(), rjrc.JvtGetValueType());
+  }
+
+  const _tyJsonInputStream *m_pjis{nullptr}; // The document's stream - we read copies of it.
+  _tyFilePos m_posValue{0};
+  EJsonValueType m_jvt{ejvtJsonValueTypeCount};
+  mutable std::unique_ptr<_tyLazyObject> m_upObject;
+  mutable std::unique_ptr<_tyLazyArray> m_upArray;
+  mutable std::unique_ptr<_ParseState> m_upps; // Only while m_upObject or m_upArray is partially read.
+  mutable std::unique_ptr<_tyJsoValue> m_upjvValue;
+};
+
+// JsoLazyDocument:
+// Owns the mapping of a JSON file - or references memory owned by the caller - and the root JsoLazyValue.
+// Opening reads only up to the first character of the root value. Values refer to the document so it can't be copied or moved.
+template <class t_tyChar, class t_tyObjectStorage>
+class JsoLazyDocument
+{
+  typedef JsoLazyDocument _tyThis;
+
+public:
+  typedef t_tyChar _tyChar;
+  typedef JsonCharTraits<_tyChar> _tyCharTraits;
+  typedef JsoLazyValue<_tyChar, t_tyObjectStorage> _tyJsoLazyValue;
+  typedef typename _tyJsoLazyValue::_tyJsonInputStream _tyJsonInputStream;
+  typedef typename _tyJsoLazyValue::_tyJsonReadCursor _tyJsonReadCursor;
+  typedef JsonMemMappedInputStream<_tyCharTraits> _tyJsonMappedInputStream;
+
+  JsoLazyDocument() = default;
+  ~JsoLazyDocument() = default;
+  JsoLazyDocument(JsoLazyDocument const &) = delete;
+  JsoLazyDocument &operator=(JsoLazyDocument const &) = delete;
+
+  // Map the file _pszFilename - throws on failure.
+  void Open(const char *_pszFilename)
+  {
+    Close();
+    m_jmmis.Open(_pszFilename);
+    _Open(m_jmmis.PcpxBegin(), m_jmmis.PcpxEnd() - m_jmmis.PcpxBegin());
+  }
+  // Read the _stLen characters at _pc - the memory must remain valid until Close().
+  void Open(const _tyChar *_pc, size_t _stLen)
+  {
+    Close();
+    _Open(_pc, _stLen);
+  }
+  void Close()
+  {
+    m_jlvRoot = _tyJsoLazyValue();
+    if (m_jis.FOpened())
+      m_jis.Close();
+    if (m_jmmis.FOpened())
+      (void)m_jmmis.Close();
+  }
+  bool FOpened() const
+  {
+    return m_jis.FOpened();
+  }
+  // Build the structural index for the JSON - see JsonStructuralIndex. Values parsed after this skip whole values using the index.
+  void BuildStructuralIndex(size_t _nThreads = 0)
+  {
+    Assert(FOpened());
+    m_jis.BuildStructuralIndex(_nThreads);
+  }
+  const _tyJsoLazyValue &RJvGet() const
+  {
+    Assert(FOpened());
+    return m_jlvRoot;
+  }
+
+protected:
+  void _Open(const _tyChar *_pc, size_t _stLen)
+  {
+    m_jis.Open(_pc, _stLen);
+    _tyJsonInputStream jis(m_jis);
+    _tyJsonReadCursor jrc;
+    jis.AttachReadCursor(jrc);
+    m_jlvRoot = _tyJsoLazyValue(m_jis, jrc.GetCurrentContext().PosStartValue(), jrc.JvtGetValueType());
+  }
+
+  _tyJsonMappedInputStream m_jmmis; // Only when we mapped the file.
+  _tyJsonInputStream m_jis;         // The JSON - values read copies of this stream.
+  _tyJsoLazyValue m_jlvRoot;
+};
+
+__BIENUTIL_END_NAMESPACE
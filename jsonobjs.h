@@ -12,19 +12,25 @@
 #include <vector>
 #include <map>
 #include <compare>
+#include <tuple>
+#include <algorithm>
+#include <memory>
+#include <cmath>
+#include <utility>
 #include "jsonstrm.h"
 #include "strwrsv.h"
 
 __BIENUTIL_BEGIN_NAMESPACE
 
 // predeclare
-template <class t_tyChar>
+struct JsoObjectStorageMap;
+template <class t_tyChar, class t_tyObjectStorage = JsoObjectStorageMap, class t_tyAllocator = std::allocator<char>>
 class JsoValue;
-template <class t_tyChar>
+template <class t_tyChar, class t_tyObjectStorage = JsoObjectStorageMap, class t_tyAllocator = std::allocator<char>>
 class _JsoObject;
-template <class t_tyChar>
+template <class t_tyChar, class t_tyObjectStorage = JsoObjectStorageMap, class t_tyAllocator = std::allocator<char>>
 class _JsoArray;
-template <class t_tyChar, bool t_kfConst>
+template <class t_tyChar, bool t_kfConst, class t_tyObjectStorage = JsoObjectStorageMap, class t_tyAllocator = std::allocator<char>>
 class JsoIterator;
 
 // This exception will get thrown if the user of the read cursor does something inappropriate given the current context.
@@ -51,19 +57,22 @@ public:
 
 // JsoIterator:
 // This iterator may be iterating an object or an array.
-// For an object we iterate in key order.
+// For an object we iterate in the order of the object storage - key order for JsoObjectStorageMap and JsoObjectStorageFlat,
+//  insertion order for JsoObjectStorageHash.
 // For an array we iterate in index order.
-template <class t_tyChar, bool t_kfConst>
+template <class t_tyChar, bool t_kfConst, class t_tyObjectStorage, class t_tyAllocator>
 class JsoIterator
 {
   typedef JsoIterator _tyThis;
 
 public:
-  typedef std::conditional_t<t_kfConst, typename _JsoObject<t_tyChar>::_tyConstIterator, typename _JsoObject<t_tyChar>::_tyIterator> _tyObjectIterator;
-  typedef std::conditional_t<t_kfConst, typename _JsoArray<t_tyChar>::_tyConstIterator, typename _JsoArray<t_tyChar>::_tyIterator> _tyArrayIterator;
-  typedef JsoValue<t_tyChar> _tyJsoValue;
+  typedef _JsoObject<t_tyChar, t_tyObjectStorage, t_tyAllocator> _tyJsoObject;
+  typedef _JsoArray<t_tyChar, t_tyObjectStorage, t_tyAllocator> _tyJsoArray;
+  typedef std::conditional_t<t_kfConst, typename _tyJsoObject::_tyConstIterator, typename _tyJsoObject::_tyIterator> _tyObjectIterator;
+  typedef std::conditional_t<t_kfConst, typename _tyJsoArray::_tyConstIterator, typename _tyJsoArray::_tyIterator> _tyArrayIterator;
+  typedef JsoValue<t_tyChar, t_tyObjectStorage, t_tyAllocator> _tyJsoValue;
   typedef std::conditional_t<t_kfConst, const _tyJsoValue, _tyJsoValue> _tyQualJsoValue;
-  typedef typename _JsoObject<t_tyChar>::_tyMapValueType _tyKeyValueType; // This type is only used by objects.
+  typedef typename _tyJsoObject::_tyMapValueType _tyKeyValueType; // This type is only used by objects.
   typedef std::conditional_t<t_kfConst, const _tyKeyValueType, _tyKeyValueType> _tyQualKeyValueType;
 
   ~JsoIterator()
@@ -181,7 +190,7 @@ public:
     else
       return JsoIterator(GetArrayIterator()--);
   }
-  typename _JsoArray<t_tyChar>::difference_type operator-(const JsoIterator &_r) const
+  typename _tyJsoArray::difference_type operator-(const JsoIterator &_r) const
   {
     if (m_fObjectIterator)
       THROWJSONBADUSAGE("Not valid for object iterator.");
@@ -276,16 +285,328 @@ protected:
   bool m_fObjectIterator{true};
 };
 
+// EJsoNumberType: How a JsoValue number is stored.
+enum EJsoNumberType : uint8_t
+{
+  ejntInt64,  // Any integer representable by int64_t.
+  ejntUInt64, // Integers above INT64_MAX representable by uint64_t.
+  ejntDouble, // Everything else - including integers beyond the range of uint64_t.
+  ejntJsoNumberTypeCount
+};
+
+// _JsoNumber:
+// A JSON number stored as int64_t, uint64_t or double so that reading it as a number doesn't parse text and setting it doesn't format text.
+// The original text is kept only when formatting the stored value wouldn't reproduce it - e.g. "1.50", "1e3", "-0", or more digits than
+//  a double holds - so that ToJSONStream() writes exactly what FromJSONStream() read. Canonical numbers don't allocate.
+// Doubles are formatted in the shortest form that reads back to the same value - as JsonValueLife does by default.
+template <class t_tyChar, class t_tyAllocator = std::allocator<char>>
+class _JsoNumber
+{
+  typedef _JsoNumber _tyThis;
+
+public:
+  typedef t_tyChar _tyChar;
+  typedef JsonCharTraits<_tyChar> _tyCharTraits;
+  typedef typename std::allocator_traits<t_tyAllocator>::template rebind_alloc<_tyChar> _tyCharAllocator;
+  typedef std::basic_string<_tyChar, std::char_traits<_tyChar>, _tyCharAllocator> _tyStdStr;
+  typedef typename std::allocator_traits<t_tyAllocator>::template rebind_alloc<_tyStdStr> _tyStrAllocator;
+  typedef std::basic_string_view<_tyChar> _tyStringView;
+  static const size_t s_kstMaxFormatted = 64; // Enough for the shortest form of any arithmetic type - see JsonNumber_StFormat().
+
+  _JsoNumber() = default;
+  ~_JsoNumber()
+  {
+    _ResetText();
+  }
+  _JsoNumber(_JsoNumber const &_r)
+      : m_u64(_r.m_u64),
+        m_ejnt(_r.m_ejnt)
+  {
+    if (!!_r.m_pstrText)
+      _CreateText(*_r.m_pstrText);
+  }
+  _JsoNumber(_JsoNumber &&_rr) noexcept
+      : m_u64(_rr.m_u64),
+        m_pstrText(std::exchange(_rr.m_pstrText, nullptr)),
+        m_ejnt(_rr.m_ejnt)
+  {
+  }
+  _JsoNumber &operator=(_JsoNumber const &_r)
+  {
+    if (this != &_r)
+    {
+      _JsoNumber jnCopy(_r);
+      swap(jnCopy);
+    }
+    return *this;
+  }
+  _JsoNumber &operator=(_JsoNumber &&_rr) noexcept
+  {
+    if (this != &_rr)
+    {
+      _ResetText();
+      m_u64 = _rr.m_u64;
+      m_pstrText = std::exchange(_rr.m_pstrText, nullptr);
+      m_ejnt = _rr.m_ejnt;
+    }
+    return *this;
+  }
+  void swap(_JsoNumber &_r) noexcept
+  {
+    std::swap(m_u64, _r.m_u64);
+    std::swap(m_pstrText, _r.m_pstrText);
+    std::swap(m_ejnt, _r.m_ejnt);
+  }
+
+  EJsoNumberType JntGetType() const
+  {
+    return m_ejnt;
+  }
+  // Whether we are holding onto the original text because the stored value wouldn't reproduce it.
+  bool FHasText() const
+  {
+    return !!m_pstrText;
+  }
+  int64_t I64Get() const
+  {
+    Assert(ejntInt64 == m_ejnt);
+    return m_i64;
+  }
+  uint64_t U64Get() const
+  {
+    Assert(ejntUInt64 == m_ejnt);
+    return m_u64;
+  }
+  double DblGet() const
+  {
+    Assert(ejntDouble == m_ejnt);
+    return m_dbl;
+  }
+
+  template <class t_tyNum>
+  void SetValue(t_tyNum _num)
+    requires(std::is_arithmetic_v<t_tyNum>)
+  {
+    _ResetText();
+    if constexpr (std::is_integral_v<t_tyNum>)
+    {
+      static_assert(sizeof(t_tyNum) <= sizeof(uint64_t));
+      if constexpr (std::is_signed_v<t_tyNum>)
+        _SetInt64(int64_t(_num));
+      else if (uint64_t(_num) > uint64_t((std::numeric_limits<int64_t>::max)()))
+      {
+        m_u64 = uint64_t(_num);
+        m_ejnt = ejntUInt64;
+      }
+      else
+        _SetInt64(int64_t(_num));
+    }
+    else
+    {
+      m_dbl = double(_num);
+      m_ejnt = ejntDouble;
+      if constexpr (sizeof(t_tyNum) > sizeof(double))
+      {
+        if (t_tyNum(m_dbl) != _num) // Keep the precision that a double can't hold.
+          _SetText(_num);
+      }
+    }
+  }
+  // Set from the text of a JSON number - which must already have been validated against the JSON number grammar.
+  void SetText(_tyStringView _sv)
+  {
+    Assert(!_sv.empty());
+    _ResetText();
+    const _tyChar *pcCur = &_sv[0];
+    const _tyChar *const pcEnd = pcCur + _sv.length();
+    bool fNegative = (_tyCharTraits::s_tcMinus == *pcCur);
+    if (fNegative)
+      ++pcCur;
+    uint64_t u64Value = 0;
+    bool fOverflow = false;
+    for (; (pcEnd != pcCur) && (*pcCur >= _tyCharTraits::s_tc0) && (*pcCur <= _tyCharTraits::s_tc9); ++pcCur)
+    {
+      uint64_t u64Digit = uint64_t(*pcCur - _tyCharTraits::s_tc0);
+      fOverflow = fOverflow || (u64Value > (((std::numeric_limits<uint64_t>::max)() - u64Digit) / 10));
+      u64Value = u64Value * 10 + u64Digit;
+    }
+    if ((pcEnd == pcCur) && !fOverflow && (!fNegative || (u64Value <= (uint64_t(1) << 63))))
+    {
+      if (fNegative)
+        _SetInt64(!u64Value ? 0 : (-int64_t(u64Value - 1) - 1)); // Avoid overflow on the minimum value.
+      else
+        SetValue(u64Value);
+    }
+    else
+    {
+      // Fraction, exponent or too many digits - same parse as JsonParseNumber() except that out of range magnitudes become infinities
+      //  rather than throwing - we have the text to write and a later GetValue() will throw as before.
+      char rgcNum[_tyCharTraits::s_knMaxNumberLength + 1];
+      size_t stLen = JsonNumber_StNarrow<_tyCharTraits>(&_sv[0], pcEnd, rgcNum);
+      std::from_chars_result fcr = std::from_chars(rgcNum, rgcNum + stLen, m_dbl);
+      if (std::errc::result_out_of_range == fcr.ec)
+      {
+        double dblMagnitude = (JsonNumber_NDecimalMagnitude(rgcNum, rgcNum + stLen) > 0) ? HUGE_VAL : 0.0;
+        m_dbl = fNegative ? -dblMagnitude : dblMagnitude;
+      }
+      m_ejnt = ejntDouble;
+    }
+    // Keep the text only if formatting what we stored won't reproduce it.
+    _tyChar rgtcFormatted[s_kstMaxFormatted];
+    size_t stFormatted = _StFormat(rgtcFormatted);
+    if ((stFormatted != _sv.length()) || !!memcmp(rgtcFormatted, &_sv[0], stFormatted * sizeof(_tyChar)))
+      _CreateText(_sv);
+  }
+  // Set _rstr to the JSON text of this number.
+  template <class t_tyStr>
+  void GetText(t_tyStr &_rstr) const
+  {
+    if (!!m_pstrText)
+      _rstr.assign(m_pstrText->c_str(), m_pstrText->length());
+    else
+    {
+      _tyChar rgtcFormatted[s_kstMaxFormatted];
+      _rstr.assign(rgtcFormatted, _StFormat(rgtcFormatted));
+    }
+  }
+  // Conversions are those of JsonParseNumber() on our text - throw when out of range for t_tyNum, fractions truncate toward zero for integers.
+  // Integers to any type and doubles to double don't touch text.
+  template <class t_tyNum>
+  void GetValue(t_tyNum &_rNumber) const
+  {
+    if (!!m_pstrText)
+      return JsonParseNumber<_tyCharTraits>(m_pstrText->c_str(), m_pstrText->c_str() + m_pstrText->length(), _rNumber);
+    if (ejntDouble == m_ejnt)
+    {
+      if constexpr (std::is_same_v<t_tyNum, double>)
+        _rNumber = m_dbl;
+      else
+      {
+        // Parse our shortest form as the original text would have been parsed - e.g. as long double for integers.
+        _tyChar rgtcFormatted[s_kstMaxFormatted];
+        size_t stFormatted = _StFormat(rgtcFormatted);
+        JsonParseNumber<_tyCharTraits>(rgtcFormatted, rgtcFormatted + stFormatted, _rNumber);
+      }
+    }
+    else if constexpr (std::is_integral_v<t_tyNum>)
+    {
+      if (!((ejntInt64 == m_ejnt) ? std::in_range<t_tyNum>(m_i64) : std::in_range<t_tyNum>(m_u64)))
+        _ThrowOutOfRange<t_tyNum>();
+      _rNumber = (ejntInt64 == m_ejnt) ? t_tyNum(m_i64) : t_tyNum(m_u64);
+    }
+    else
+      _rNumber = (ejntInt64 == m_ejnt) ? t_tyNum(m_i64) : t_tyNum(m_u64);
+  }
+
+  // Numbers compare as their JSON text - as they did when they were stored as text.
+  bool operator==(_tyThis const &_r) const
+  {
+    if (!m_pstrText && !_r.m_pstrText)
+      return (m_ejnt == _r.m_ejnt) && (m_u64 == _r.m_u64); // Same bits <=> same shortest form.
+    return (*this <=> _r) == 0;
+  }
+  std::strong_ordering operator<=>(_tyThis const &_r) const
+  {
+    _tyChar rgtcLeft[s_kstMaxFormatted];
+    _tyChar rgtcRight[s_kstMaxFormatted];
+    _tyStringView svLeft = _SvText(rgtcLeft);
+    _tyStringView svRight = _r._SvText(rgtcRight);
+    // Compare as ICompareStr() compares - the shorter string is less when it is a prefix.
+    size_t stCommon = (std::min)(svLeft.length(), svRight.length());
+    for (size_t st = 0; st < stCommon; ++st)
+    {
+      if (svLeft[st] != svRight[st])
+        return (svLeft[st] < svRight[st]) ? std::strong_ordering::less : std::strong_ordering::greater;
+    }
+    return svLeft.length() <=> svRight.length();
+  }
+
+protected:
+  void _SetInt64(int64_t _i64)
+  {
+    m_i64 = _i64;
+    m_ejnt = ejntInt64;
+  }
+  template <class t_tyNum>
+  void _SetText(t_tyNum _num)
+  {
+    _tyChar rgtcFormatted[s_kstMaxFormatted];
+    _CreateText(_tyStringView(rgtcFormatted, JsonNumber_StFormat<_tyCharTraits>(_num, rgtcFormatted, s_kstMaxFormatted)));
+  }
+  // The text is allocated with t_tyAllocator as everything else in the JsoValue tree is.
+  void _CreateText(_tyStringView _sv)
+  {
+    Assert(!m_pstrText);
+    _tyStrAllocator alloc;
+    _tyStdStr *pstr = std::allocator_traits<_tyStrAllocator>::allocate(alloc, 1);
+    try
+    {
+      std::allocator_traits<_tyStrAllocator>::construct(alloc, pstr, _sv.data(), _sv.length());
+    }
+    catch (...)
+    {
+      std::allocator_traits<_tyStrAllocator>::deallocate(alloc, pstr, 1);
+      throw;
+    }
+    m_pstrText = pstr;
+  }
+  void _ResetText() noexcept
+  {
+    if (!!m_pstrText)
+    {
+      _tyStrAllocator alloc;
+      std::allocator_traits<_tyStrAllocator>::destroy(alloc, m_pstrText);
+      std::allocator_traits<_tyStrAllocator>::deallocate(alloc, m_pstrText, 1);
+      m_pstrText = nullptr;
+    }
+  }
+  size_t _StFormat(_tyChar (&_rgtcBuf)[s_kstMaxFormatted]) const
+  {
+    Assert(m_ejnt < ejntJsoNumberTypeCount);
+    if (ejntInt64 == m_ejnt)
+      return JsonNumber_StFormat<_tyCharTraits>(m_i64, _rgtcBuf, s_kstMaxFormatted);
+    else if (ejntUInt64 == m_ejnt)
+      return JsonNumber_StFormat<_tyCharTraits>(m_u64, _rgtcBuf, s_kstMaxFormatted);
+    else
+      return JsonNumber_StFormat<_tyCharTraits>(m_dbl, _rgtcBuf, s_kstMaxFormatted);
+  }
+  _tyStringView _SvText(_tyChar (&_rgtcBuf)[s_kstMaxFormatted]) const
+  {
+    if (!!m_pstrText)
+      return _tyStringView(*m_pstrText);
+    return _tyStringView(_rgtcBuf, _StFormat(_rgtcBuf));
+  }
+  template <class t_tyNum>
+  [[noreturn]] void _ThrowOutOfRange() const
+  {
+    _tyChar rgtcFormatted[s_kstMaxFormatted];
+    size_t stFormatted = _StFormat(rgtcFormatted);
+    JsonNumber_ThrowOutOfRange<_tyCharTraits, t_tyNum>(rgtcFormatted, rgtcFormatted + stFormatted);
+  }
+
+  union
+  {
+    int64_t m_i64;
+    uint64_t m_u64{0};
+    double m_dbl;
+  };
+  _tyStdStr *m_pstrText{nullptr}; // Only when the formatted value wouldn't reproduce the text we were set from.
+  EJsoNumberType m_ejnt{ejntInt64};
+};
+
 // JsoValue:
 // Every JSON object is a value. In fact every single JSON object is represented by the class JsoValue because that is the best spacewise
 //  way of doing things. We embed the string/object/array within this class to implement the different JSON objects.
+// t_tyObjectStorage selects how the members of objects are stored - see JsoObjectStorageMap, etc. below.
+// t_tyAllocator (rebound as needed) allocates every string, container and node in the tree. Each container default constructs its
+//  allocator so a stateless allocator is expected - see JsoArenaAllocator below.
 #if defined(__amd64__) || defined(_M_AMD64) || defined(__x86_64__) || defined(__ia64__)
 #pragma pack(push, 8) // Ensure that we pack this on an 8 byte boundary for 64bit compilation.
 #else
 #pragma pack(push, 4) // Ensure that we pack this on an 4 byte boundary for 32bit compilation.
 #endif
 
-template <class t_tyChar>
+template <class t_tyChar, class t_tyObjectStorage, class t_tyAllocator>
 class JsoValue
 {
   typedef JsoValue _tyThis;
@@ -294,13 +615,17 @@ public:
   typedef t_tyChar _tyChar;
   typedef JsonCharTraits<_tyChar> _tyCharTraits;
   typedef const _tyChar *_tyLPCSTR;
-  typedef std::basic_string<_tyChar> _tyStdStr;
+  typedef t_tyAllocator _tyAllocator;
+  typedef typename std::allocator_traits<_tyAllocator>::template rebind_alloc<_tyChar> _tyCharAllocator;
+  typedef std::basic_string<_tyChar, std::char_traits<_tyChar>, _tyCharAllocator> _tyStdStr;
   typedef StrWRsv<_tyStdStr> _tyStrWRsv; // string with reserve buffer.
-  typedef _JsoObject<_tyChar> _tyJsoObject;
-  typedef _JsoArray<_tyChar> _tyJsoArray;
+  typedef t_tyObjectStorage _tyObjectStorage;
+  typedef _JsoNumber<_tyChar, _tyAllocator> _tyJsoNumber;
+  typedef _JsoObject<_tyChar, _tyObjectStorage, _tyAllocator> _tyJsoObject;
+  typedef _JsoArray<_tyChar, _tyObjectStorage, _tyAllocator> _tyJsoArray;
   typedef JsonFormatSpec<_tyCharTraits> _tyJsonFormatSpec;
-  typedef JsoIterator<_tyChar, false> iterator;
-  typedef JsoIterator<_tyChar, true> const_iterator;
+  typedef JsoIterator<_tyChar, false, _tyObjectStorage, _tyAllocator> iterator;
+  typedef JsoIterator<_tyChar, true, _tyObjectStorage, _tyAllocator> const_iterator;
 
   ~JsoValue()
   {
@@ -315,13 +640,16 @@ public:
   {
     *this = _r;
   }
-  JsoValue(JsoValue &&_rr)
+  // noexcept so that containers of values (and of key/value pairs) move rather than copy upon reallocation.
+  JsoValue(JsoValue &&_rr) noexcept
   {
     if (_rr.JvtGetValueType() != ejvtJsonValueTypeCount)
     {
       switch (_rr.JvtGetValueType())
       {
       case ejvtNumber:
+        new (m_rgbyValBuf) _tyJsoNumber(std::move(_rr._NumberGet()));
+        break;
       case ejvtString:
         new (m_rgbyValBuf) _tyStrWRsv(std::move(_rr.StrGet()));
         break;
@@ -354,6 +682,8 @@ public:
       case ejvtFalse:
         break; // nothing to do
       case ejvtNumber:
+        _NumberGet() = _r._NumberGet();
+        break;
       case ejvtString:
         StrGet() = _r.StrGet();
         break;
@@ -382,6 +712,8 @@ public:
         switch (_rr.JvtGetValueType())
         {
         case ejvtNumber:
+          new (m_rgbyValBuf) _tyJsoNumber(std::move(_rr._NumberGet()));
+          break;
         case ejvtString:
           new (m_rgbyValBuf) _tyStrWRsv(std::move(_rr.StrGet()));
           break;
@@ -458,8 +790,10 @@ public:
       case ejvtFalse:
         break;
       case ejvtNumber:
-      case ejvtString:
         // Note that I don't mean to compare numbers as numbers - only as the strings they are represented in.
+        fSame = (_NumberGet() == _r._NumberGet());
+        break;
+      case ejvtString:
         fSame = (StrGet() == _r.StrGet());
         break;
       case ejvtObject:
@@ -493,8 +827,10 @@ public:
       case ejvtFalse:
         break;
       case ejvtNumber:
-      case ejvtString:
         // Note that I don't mean to compare numbers as numbers - only as the strings they are represented in.
+        comp = _NumberGet() <=> _r._NumberGet();
+        break;
+      case ejvtString:
         comp = StrGet() <=> _r.StrGet();
         break;
       case ejvtObject:
@@ -574,20 +910,46 @@ public:
     else
       THROWJSONBADUSAGE("Called on non-boolean.");
   }
+  // Numbers aren't stored as strings - use GetNumberText() for their text.
   const _tyStrWRsv &StrGet() const
   {
-    Assert( FIsString() || FIsNumber() );
-    if (!FIsString() && !FIsNumber())
-      THROWJSONBADUSAGE("Called on non-string/num.");
+    Assert( FIsString() );
+    if (!FIsString())
+      THROWJSONBADUSAGE("Called on non-string.");
     return *static_cast<const _tyStrWRsv *>((const void *)m_rgbyValBuf);
   }
   _tyStrWRsv &StrGet()
   {
-    Assert( FIsString() || FIsNumber() );
-    if (!FIsString() && !FIsNumber())
-      THROWJSONBADUSAGE("Called on non-string/num.");
+    Assert( FIsString() );
+    if (!FIsString())
+      THROWJSONBADUSAGE("Called on non-string.");
     return *static_cast<_tyStrWRsv *>((void *)m_rgbyValBuf);
   }
+  const _tyJsoNumber &_NumberGet() const
+  {
+    Assert( FIsNumber() );
+    if (!FIsNumber())
+      THROWJSONBADUSAGE("Called on non-number.");
+    return *static_cast<const _tyJsoNumber *>((const void *)m_rgbyValBuf);
+  }
+  _tyJsoNumber &_NumberGet()
+  {
+    Assert( FIsNumber() );
+    if (!FIsNumber())
+      THROWJSONBADUSAGE("Called on non-number.");
+    return *static_cast<_tyJsoNumber *>((void *)m_rgbyValBuf);
+  }
+  // How the number is stored - an int64_t, uint64_t or double may be read without conversion via GetValue().
+  EJsoNumberType JntGetNumberType() const
+  {
+    return _NumberGet().JntGetType();
+  }
+  // The JSON text of the number - exactly the text that was read for numbers read by FromJSONStream().
+  template <class t_tyStr>
+  void GetNumberText(t_tyStr &_rstr) const
+  {
+    _NumberGet().GetText(_rstr);
+  }
   const _tyJsoObject &_ObjectGet() const
   {
     Assert( FIsObject() );
@@ -618,27 +980,24 @@ public:
   }
   // Various number conversion methods.
   template <class t_tyNum>
-  void _GetValue(_tyLPCSTR _pszFmt, t_tyNum &_rNumber) const
+  void _GetValue(t_tyNum &_rNumber) const
   {
     Assert( FIsNumber() );
     if (ejvtNumber != JvtGetValueType())
       THROWJSONBADUSAGE("Not at a numeric value type.");
-
-    // The presumption is that sscanf won't read past any decimal point if scanning a non-floating point number.
-    int iRet = sscanf(StrGet().c_str(), _pszFmt, &_rNumber);
-    Assert(1 == iRet); // Due to the specification of number we expect this to always succeed.
-  }
-  void GetValue(uint8_t &_rby) const { _GetValue("%hhu", _rby); }
-  void GetValue(int8_t &_rsby) const { _GetValue("%hhd", _rsby); }
-  void GetValue(uint16_t &_rus) const { _GetValue("%hu", _rus); }
-  void GetValue(int16_t &_rss) const { _GetValue("%hd", _rss); }
-  void GetValue(uint32_t &_rui) const { _GetValue("%u", _rui); }
-  void GetValue(int32_t &_rsi) const { _GetValue("%d", _rsi); }
-  void GetValue(uint64_t &_rul) const { _GetValue("%llu", _rul); }
-  void GetValue(int64_t &_rsl) const { _GetValue("%lld", _rsl); }
-  void GetValue(float &_rfl) const { _GetValue("%e", _rfl); }
-  void GetValue(double &_rdbl) const { _GetValue("%e", _rdbl); }
-  void GetValue(long double &_rldbl) const { _GetValue("%Le", _rldbl); }
+    _NumberGet().GetValue(_rNumber);
+  }
+  void GetValue(uint8_t &_rby) const { _GetValue(_rby); }
+  void GetValue(int8_t &_rsby) const { _GetValue(_rsby); }
+  void GetValue(uint16_t &_rus) const { _GetValue(_rus); }
+  void GetValue(int16_t &_rss) const { _GetValue(_rss); }
+  void GetValue(uint32_t &_rui) const { _GetValue(_rui); }
+  void GetValue(int32_t &_rsi) const { _GetValue(_rsi); }
+  void GetValue(uint64_t &_rul) const { _GetValue(_rul); }
+  void GetValue(int64_t &_rsl) const { _GetValue(_rsl); }
+  void GetValue(float &_rfl) const { _GetValue(_rfl); }
+  void GetValue(double &_rdbl) const { _GetValue(_rdbl); }
+  void GetValue(long double &_rldbl) const { _GetValue(_rldbl); }
 
   // Setting methods: These overwrite the existing element at this location.
   void SetEmpty() // Note that this is not the same as the NullValue - see below.
@@ -682,10 +1041,13 @@ public:
   }
   template <class t_tyStr>
   void SetStringValue(t_tyStr &&_rrstr) 
-    requires ( is_same_v< typename t_tyStr::value_type, _tyChar > )
+    requires ( is_same_v< typename std::remove_cvref_t< t_tyStr >::value_type, _tyChar > )
   {
     SetValueType(ejvtString);
-    StrGet() = std::move( _rrstr );
+    if constexpr (is_same_v<std::remove_cvref_t<t_tyStr>, _tyStdStr> || is_same_v<std::remove_cvref_t<t_tyStr>, _tyStrWRsv>)
+      StrGet() = std::forward<t_tyStr>( _rrstr );
+    else // A string with some other allocator.
+      StrGet().assign(_rrstr.c_str(), _rrstr.length());
   }
   template < class t_tyStr >
   _tyThis &operator=( const t_tyStr &_rstr ) 
@@ -704,15 +1066,15 @@ public:
 
   void SetValue(uint8_t _by)
   {
-    _SetValue("%hhu", _by);
+    _SetValue(_by);
   }
   void SetValue(int8_t _sby)
   {
-    _SetValue("%hhd", _sby);
+    _SetValue(_sby);
   }
   void SetValue(uint16_t _us)
   {
-    _SetValue("%hu", _us);
+    _SetValue(_us);
   }
   _tyThis &operator=(uint16_t _us)
   {
@@ -721,7 +1083,7 @@ public:
   }
   void SetValue(int16_t _ss)
   {
-    _SetValue("%hd", _ss);
+    _SetValue(_ss);
   }
   _tyThis &operator=(int16_t _ss)
   {
@@ -730,7 +1092,7 @@ public:
   }
   void SetValue(uint32_t _ui)
   {
-    _SetValue("%u", _ui);
+    _SetValue(_ui);
   }
   _tyThis &operator=(uint32_t _ui)
   {
@@ -739,7 +1101,7 @@ public:
   }
   void SetValue(int32_t _si)
   {
-    _SetValue("%d", _si);
+    _SetValue(_si);
   }
   _tyThis &operator=(int32_t _si)
   {
@@ -748,7 +1110,7 @@ public:
   }
   void SetValue(uint64_t _ul)
   {
-    _SetValue("%llu", _ul);
+    _SetValue(_ul);
   }
   _tyThis &operator=(uint64_t _ul)
   {
@@ -757,7 +1119,7 @@ public:
   }
   void SetValue(int64_t _sl)
   {
-    _SetValue("%lld", _sl);
+    _SetValue(_sl);
   }
   _tyThis &operator=(int64_t _sl)
   {
@@ -766,7 +1128,7 @@ public:
   }
   void SetValue(double _dbl)
   {
-    _SetValue("%f", _dbl);
+    _SetValue(_dbl);
   }
   _tyThis &operator=(double _dbl)
   {
@@ -775,7 +1137,7 @@ public:
   }
   void SetValue(long double _ldbl)
   {
-    _SetValue("%Lf", _ldbl);
+    _SetValue(_ldbl);
   }
   _tyThis &operator=(long double _ldbl)
   {
@@ -856,9 +1218,14 @@ public:
     case ejvtFalse:
       break;
     case ejvtNumber:
-    case ejvtString:
-      _jrc.GetValue(StrGet());
+      _NumberGet().SetText(_jrc.SvGetNumberValue());
       break;
+    case ejvtString:
+    {
+      typename JsonReadCursor<t_tyJsonInputStream>::_tyStringView svValue = _jrc.SvGetStringValue();
+      StrGet().assign(svValue.data(), svValue.length());
+    }
+    break;
     case ejvtObject:
       _ObjectGet().FromJSONStream(_jrc);
       break;
@@ -900,9 +1267,14 @@ public:
     case ejvtFalse:
       break;
     case ejvtNumber:
-    case ejvtString:
-      _jrc.GetValue(StrGet());
+      _NumberGet().SetText(_jrc.SvGetNumberValue());
       break;
+    case ejvtString:
+    {
+      typename JsonReadCursor<t_tyJsonInputStream>::_tyStringView svValue = _jrc.SvGetStringValue();
+      StrGet().assign(svValue.data(), svValue.length());
+    }
+    break;
     case ejvtObject:
       _ObjectGet().FromJSONStream(_jrc, *this, _rfFilter);
       break;
@@ -944,8 +1316,10 @@ public:
     case ejvtFalse:
       break; // nothing to do - _jvl has already been created with the correct value type.
     case ejvtNumber:
+      _NumberGet().GetText(*_jvl.RJvGet().PCreateStringValue());
+      break;
     case ejvtString:
-      _jvl.RJvGet().PCreateStringValue()->assign(StrGet());
+      _jvl.RJvGet().PCreateStringValue()->assign(StrGet().c_str(), StrGet().length());
       break;
     case ejvtObject:
       _ObjectGet().ToJSONStream(_jvl);
@@ -987,8 +1361,10 @@ public:
     case ejvtFalse:
       break; // nothing to do - _jvl has already been created with the correct value type.
     case ejvtNumber:
+      _NumberGet().GetText(*_jvl.RJvGet().PCreateStringValue());
+      break;
     case ejvtString:
-      _jvl.RJvGet().PCreateStringValue()->assign(StrGet());
+      _jvl.RJvGet().PCreateStringValue()->assign(StrGet().c_str(), StrGet().length());
       break;
     case ejvtObject:
       _ObjectGet().ToJSONStream(_jvl, *this, _rfFilter);
@@ -1147,14 +1523,10 @@ public:
 
 protected:
   template <class t_tyNum>
-  void _SetValue(_tyLPCSTR _pszFmt, t_tyNum _num)
+  void _SetValue(t_tyNum _num)
   {
-    const int knNum = 512;
-    char rgcNum[knNum];
-    int nPrinted = snprintf(rgcNum, knNum, _pszFmt, _num);
-    Assert(nPrinted < knNum);
     SetValueType(ejvtNumber);
-    StrGet().assign(rgcNum, (std::min)(nPrinted, knNum - 1));
+    _NumberGet().SetValue(_num);
   }
   void _ClearValue()
   {
@@ -1163,6 +1535,8 @@ protected:
     switch (jvt)
     {
     case ejvtNumber:
+      static_cast<_tyJsoNumber *>((void *)m_rgbyValBuf)->~_tyJsoNumber();
+      break;
     case ejvtString:
       static_cast<_tyStrWRsv *>((void *)m_rgbyValBuf)->~_tyStrWRsv();
       break;
@@ -1188,6 +1562,8 @@ protected:
     switch (_jvt)
     {
     case ejvtNumber:
+      new (m_rgbyValBuf) _tyJsoNumber();
+      break;
     case ejvtString:
       new (m_rgbyValBuf) _tyStrWRsv();
       break;
@@ -1210,16 +1586,307 @@ protected:
   }
 
   // Put the object buffer as the first member because then it will have alignment of the object - which is 8(64bit) or 4(32bit).
-  static constexpr size_t s_kstSizeValBuf = (std::max)(sizeof(_tyStrWRsv), (std::max)(sizeof(_tyJsoObject), sizeof(_tyJsoArray)));
+  static constexpr size_t s_kstSizeValBuf = (std::max)((std::max)(sizeof(_tyStrWRsv), sizeof(_tyJsoNumber)), (std::max)(sizeof(_tyJsoObject), sizeof(_tyJsoArray)));
   uint8_t m_rgbyValBuf[s_kstSizeValBuf]; // We aren't initializing this on purpose.
   EJsonValueType m_jvtType{ejvtJsonValueTypeCount};
 };
 
 #pragma pack(pop)
 
+// _JsoFlatMap:
+// A vector of key/value pairs kept sorted by key. Implements the subset of std::map<> used by _JsoObject.
+// Lookup is a linear scan up to t_kstLinearScanMax elements and a binary search beyond that.
+// Keys are checked against the last element first since we usually read objects that we wrote - in key order.
+// As with std::vector<> insertion invalidates iterators and references to elements. Keys must not be modified through an iterator.
+template <class t_tyKey, class t_tyValue, size_t t_kstLinearScanMax, class t_tyAllocator = std::allocator<char>>
+class _JsoFlatMap
+{
+  typedef _JsoFlatMap _tyThis;
+
+public:
+  typedef typename t_tyKey::_tyChar _tyChar;
+  typedef const _tyChar *_tyLPCSTR;
+  typedef std::pair<t_tyKey, t_tyValue> value_type;
+  typedef std::vector<value_type, typename std::allocator_traits<t_tyAllocator>::template rebind_alloc<value_type>> _tyVectorValues;
+  typedef typename _tyVectorValues::iterator iterator;
+  typedef typename _tyVectorValues::const_iterator const_iterator;
+  static constexpr size_t s_kstInitialCapacity = 8;
+
+  iterator begin() { return m_vecValues.begin(); }
+  const_iterator begin() const { return m_vecValues.begin(); }
+  iterator end() { return m_vecValues.end(); }
+  const_iterator end() const { return m_vecValues.end(); }
+  size_t size() const { return m_vecValues.size(); }
+  bool empty() const { return m_vecValues.empty(); }
+  void clear() { m_vecValues.clear(); }
+
+  iterator find(_tyLPCSTR _psz)
+  {
+    bool fFound;
+    iterator it = _ItLowerBound(_psz, fFound);
+    return fFound ? it : m_vecValues.end();
+  }
+  const_iterator find(_tyLPCSTR _psz) const
+  {
+    return const_cast<_tyThis *>(this)->find(_psz);
+  }
+  template <class... t_tyArgs>
+  std::pair<iterator, bool> try_emplace(t_tyKey &&_rrkey, t_tyArgs &&..._args)
+  {
+    bool fFound;
+    iterator it = _ItLowerBound(_rrkey.c_str(), fFound);
+    if (fFound)
+      return std::pair<iterator, bool>(it, false);
+    if (m_vecValues.empty())
+      it = _ItReserveInitial();
+    it = m_vecValues.emplace(it, std::piecewise_construct, std::forward_as_tuple(std::move(_rrkey)), std::forward_as_tuple(std::forward<t_tyArgs>(_args)...));
+    return std::pair<iterator, bool>(it, true);
+  }
+  template <class... t_tyArgs>
+  std::pair<iterator, bool> try_emplace(_tyLPCSTR _psz, t_tyArgs &&..._args)
+  {
+    bool fFound;
+    iterator it = _ItLowerBound(_psz, fFound);
+    if (fFound)
+      return std::pair<iterator, bool>(it, false);
+    if (m_vecValues.empty())
+      it = _ItReserveInitial();
+    it = m_vecValues.emplace(it, std::piecewise_construct, std::forward_as_tuple(_psz), std::forward_as_tuple(std::forward<t_tyArgs>(_args)...));
+    return std::pair<iterator, bool>(it, true);
+  }
+
+  // Since we are sorted by key these compare as std::map<> does.
+  bool operator==(_tyThis const &_r) const
+  {
+    return m_vecValues == _r.m_vecValues;
+  }
+  std::strong_ordering operator<=>(_tyThis const &_r) const
+  {
+    return m_vecValues <=> _r.m_vecValues;
+  }
+
+protected:
+  // Skip the reallocations for the first few members - most objects have at least a few.
+  iterator _ItReserveInitial()
+  {
+    m_vecValues.reserve(s_kstInitialCapacity);
+    return m_vecValues.begin();
+  }
+  // Return the first element whose key isn't less than _psz, set _rfFound if its key is _psz.
+  iterator _ItLowerBound(_tyLPCSTR _psz, bool &_rfFound)
+  {
+    _rfFound = false;
+    const iterator itEnd = m_vecValues.end();
+    if (m_vecValues.empty())
+      return itEnd;
+    std::strong_ordering comp = ICompareStr(m_vecValues.back().first.c_str(), _psz);
+    if (comp <= 0)
+    {
+      _rfFound = (0 == comp);
+      return _rfFound ? itEnd - 1 : itEnd;
+    }
+    iterator it = m_vecValues.begin();
+    if (m_vecValues.size() <= t_kstLinearScanMax)
+    {
+      for (; ICompareStr(it->first.c_str(), _psz) < 0; ++it) // terminates at the last element, which is greater.
+        ;
+    }
+    else
+    {
+      it = std::lower_bound(it, itEnd - 1, _psz, [](value_type const &_rvt, _tyLPCSTR _pszKey)
+                            { return ICompareStr(_rvt.first.c_str(), _pszKey) < 0; });
+    }
+    _rfFound = (0 == ICompareStr(it->first.c_str(), _psz));
+    return it;
+  }
+  _tyVectorValues m_vecValues;
+};
+
+// _JsoOrderedHashMap:
+// A vector of key/value pairs in insertion order with an open addressed hash index. Implements the subset of std::map<> used by _JsoObject.
+// The index isn't created until there are more than t_kstLinearScanMax elements - below that we scan linearly.
+// As with std::vector<> insertion invalidates iterators and references to elements. Keys must not be modified through an iterator.
+template <class t_tyKey, class t_tyValue, size_t t_kstLinearScanMax, class t_tyAllocator = std::allocator<char>>
+class _JsoOrderedHashMap
+{
+  typedef _JsoOrderedHashMap _tyThis;
+
+public:
+  typedef typename t_tyKey::_tyChar _tyChar;
+  typedef const _tyChar *_tyLPCSTR;
+  typedef std::pair<t_tyKey, t_tyValue> value_type;
+  typedef std::vector<value_type, typename std::allocator_traits<t_tyAllocator>::template rebind_alloc<value_type>> _tyVectorValues;
+  typedef typename _tyVectorValues::iterator iterator;
+  typedef typename _tyVectorValues::const_iterator const_iterator;
+  typedef std::vector<size_t, typename std::allocator_traits<t_tyAllocator>::template rebind_alloc<size_t>> _tyVectorIndex; // index+1 of the element in m_vecValues, 0 for an empty slot.
+  static constexpr size_t s_kstInitialCapacity = 8;
+
+  iterator begin() { return m_vecValues.begin(); }
+  const_iterator begin() const { return m_vecValues.begin(); }
+  iterator end() { return m_vecValues.end(); }
+  const_iterator end() const { return m_vecValues.end(); }
+  size_t size() const { return m_vecValues.size(); }
+  bool empty() const { return m_vecValues.empty(); }
+  void clear()
+  {
+    m_vecValues.clear();
+    m_vecIndex.clear();
+  }
+
+  iterator find(_tyLPCSTR _psz)
+  {
+    return m_vecValues.begin() + _StFind(_psz);
+  }
+  const_iterator find(_tyLPCSTR _psz) const
+  {
+    return m_vecValues.begin() + _StFind(_psz);
+  }
+  template <class... t_tyArgs>
+  std::pair<iterator, bool> try_emplace(t_tyKey &&_rrkey, t_tyArgs &&..._args)
+  {
+    size_t st = _StFind(_rrkey.c_str());
+    if (st != m_vecValues.size())
+      return std::pair<iterator, bool>(m_vecValues.begin() + st, false);
+    if (m_vecValues.empty())
+      m_vecValues.reserve(s_kstInitialCapacity); // Skip the reallocations for the first few members.
+    m_vecValues.emplace_back(std::piecewise_construct, std::forward_as_tuple(std::move(_rrkey)), std::forward_as_tuple(std::forward<t_tyArgs>(_args)...));
+    _IndexLast();
+    return std::pair<iterator, bool>(m_vecValues.end() - 1, true);
+  }
+  template <class... t_tyArgs>
+  std::pair<iterator, bool> try_emplace(_tyLPCSTR _psz, t_tyArgs &&..._args)
+  {
+    size_t st = _StFind(_psz);
+    if (st != m_vecValues.size())
+      return std::pair<iterator, bool>(m_vecValues.begin() + st, false);
+    if (m_vecValues.empty())
+      m_vecValues.reserve(s_kstInitialCapacity); // Skip the reallocations for the first few members.
+    m_vecValues.emplace_back(std::piecewise_construct, std::forward_as_tuple(_psz), std::forward_as_tuple(std::forward<t_tyArgs>(_args)...));
+    _IndexLast();
+    return std::pair<iterator, bool>(m_vecValues.end() - 1, true);
+  }
+
+  // Element order doesn't matter to equality - as with JSON objects.
+  bool operator==(_tyThis const &_r) const
+  {
+    if (m_vecValues.size() != _r.m_vecValues.size())
+      return false;
+    const_iterator itCur = m_vecValues.begin();
+    const const_iterator itEnd = m_vecValues.end();
+    for (; itCur != itEnd; ++itCur)
+    {
+      const_iterator itOther = _r.find(itCur->first.c_str());
+      if ((_r.end() == itOther) || !(itOther->second == itCur->second))
+        return false;
+    }
+    return true;
+  }
+  // Order as the equivalent key ordered std::map<> would be ordered.
+  std::strong_ordering operator<=>(_tyThis const &_r) const
+  {
+    std::vector<const value_type *> vecLeft(_VecSorted()), vecRight(_r._VecSorted());
+    return std::lexicographical_compare_three_way(vecLeft.begin(), vecLeft.end(), vecRight.begin(), vecRight.end(),
+                                                  [](const value_type *_pvtLeft, const value_type *_pvtRight)
+                                                  {
+                                                    std::strong_ordering comp = _pvtLeft->first <=> _pvtRight->first;
+                                                    return (0 != comp) ? comp : (_pvtLeft->second <=> _pvtRight->second);
+                                                  });
+  }
+
+protected:
+  // FNV-1a over the null terminated key - keys compare as null terminated strings.
+  static size_t _StHash(_tyLPCSTR _psz)
+  {
+    uint64_t u64Hash = 0xcbf29ce484222325ull;
+    for (; !!*_psz; ++_psz)
+      u64Hash = (u64Hash ^ uint64_t(std::make_unsigned_t<_tyChar>(*_psz))) * 0x100000001b3ull;
+    return size_t(u64Hash ^ (u64Hash >> 32));
+  }
+  // Return the position of _psz in m_vecValues or m_vecValues.size() if not found.
+  size_t _StFind(_tyLPCSTR _psz) const
+  {
+    if (m_vecIndex.empty())
+    {
+      size_t st = 0;
+      for (; (m_vecValues.size() != st) && (0 != ICompareStr(m_vecValues[st].first.c_str(), _psz)); ++st)
+        ;
+      return st;
+    }
+    const size_t stMask = m_vecIndex.size() - 1;
+    for (size_t stSlot = _StHash(_psz) & stMask;; stSlot = (stSlot + 1) & stMask)
+    {
+      size_t stIndex = m_vecIndex[stSlot];
+      if (!stIndex)
+        return m_vecValues.size();
+      if (0 == ICompareStr(m_vecValues[stIndex - 1].first.c_str(), _psz))
+        return stIndex - 1;
+    }
+  }
+  void _InsertIndex(size_t _stIndex)
+  {
+    const size_t stMask = m_vecIndex.size() - 1;
+    size_t stSlot = _StHash(m_vecValues[_stIndex].first.c_str()) & stMask;
+    for (; !!m_vecIndex[stSlot]; stSlot = (stSlot + 1) & stMask)
+      ;
+    m_vecIndex[stSlot] = _stIndex + 1;
+  }
+  // Index the element just appended - creating or doubling the index as needed to keep the load factor at or below one half.
+  void _IndexLast()
+  {
+    const size_t stSize = m_vecValues.size();
+    if (stSize <= t_kstLinearScanMax)
+      return;
+    if (!m_vecIndex.empty() && (2 * stSize <= m_vecIndex.size()))
+      return _InsertIndex(stSize - 1);
+    size_t stIndexSize = 16;
+    while (stIndexSize < 2 * stSize)
+      stIndexSize <<= 1;
+    m_vecIndex.assign(stIndexSize, 0);
+    for (size_t st = 0; st < stSize; ++st)
+      _InsertIndex(st);
+  }
+  std::vector<const value_type *> _VecSorted() const
+  {
+    std::vector<const value_type *> vec;
+    vec.reserve(m_vecValues.size());
+    for (value_type const &rvt : m_vecValues)
+      vec.push_back(&rvt);
+    std::sort(vec.begin(), vec.end(), [](const value_type *_pvtLeft, const value_type *_pvtRight)
+              { return _pvtLeft->first < _pvtRight->first; });
+    return vec;
+  }
+  _tyVectorValues m_vecValues;
+  _tyVectorIndex m_vecIndex;
+};
+
+// _JsoObject storage policies:
+// Each supplies _tyStorage<>, the container of an object's key/value pairs, allocating with (a rebinding of) t_tyAllocator.
+// JsoObjectStorageMap: std::map<> - an allocation per member, iteration in key order. This is the default.
+struct JsoObjectStorageMap
+{
+  template <class t_tyKey, class t_tyValue, class t_tyAllocator = std::allocator<char>>
+  using _tyStorage = std::map<t_tyKey, t_tyValue, std::less<t_tyKey>,
+                              typename std::allocator_traits<t_tyAllocator>::template rebind_alloc<std::pair<const t_tyKey, t_tyValue>>>;
+};
+// JsoObjectStorageFlat: _JsoFlatMap - a single allocation per object, iteration in key order. Best for the common object with few keys.
+template <size_t t_kstLinearScanMax = 16>
+struct JsoObjectStorageFlat
+{
+  template <class t_tyKey, class t_tyValue, class t_tyAllocator = std::allocator<char>>
+  using _tyStorage = _JsoFlatMap<t_tyKey, t_tyValue, t_kstLinearScanMax, t_tyAllocator>;
+};
+// JsoObjectStorageHash: _JsoOrderedHashMap - iteration (and so output) in insertion order, constant time lookup. For large objects.
+template <size_t t_kstLinearScanMax = 16>
+struct JsoObjectStorageHash
+{
+  template <class t_tyKey, class t_tyValue, class t_tyAllocator = std::allocator<char>>
+  using _tyStorage = _JsoOrderedHashMap<t_tyKey, t_tyValue, t_kstLinearScanMax, t_tyAllocator>;
+};
+
 // _JsoObject:
 // This is internal impl only - never exposed to the user of JsoValue.
-template <class t_tyChar>
+// The key/value pairs are stored in t_tyObjectStorage::_tyStorage<> - see above.
+template <class t_tyChar, class t_tyObjectStorage, class t_tyAllocator>
 class _JsoObject
 {
   typedef _JsoObject _tyThis;
@@ -1228,10 +1895,10 @@ public:
   typedef t_tyChar _tyChar;
   typedef JsonCharTraits<_tyChar> _tyCharTraits;
   typedef const t_tyChar *_tyLPCSTR;
-  typedef std::basic_string<t_tyChar> _tyStdStr;
+  typedef JsoValue<t_tyChar, t_tyObjectStorage, t_tyAllocator> _tyJsoValue;
+  typedef std::basic_string<t_tyChar, std::char_traits<t_tyChar>, typename std::allocator_traits<t_tyAllocator>::template rebind_alloc<t_tyChar>> _tyStdStr;
   typedef StrWRsv<_tyStdStr> _tyStrWRsv; // string with reserve buffer.
-  typedef JsoValue<t_tyChar> _tyJsoValue;
-  typedef std::map<_tyStrWRsv, _tyJsoValue> _tyMapValues;
+  typedef typename t_tyObjectStorage::template _tyStorage<_tyStrWRsv, _tyJsoValue, t_tyAllocator> _tyMapValues;
   typedef typename _tyMapValues::iterator _tyIterator;
   typedef typename _tyMapValues::const_iterator _tyConstIterator;
   typedef typename _tyMapValues::value_type _tyMapValueType;
@@ -1326,11 +1993,10 @@ public:
       THROWJSONBADUSAGE("FMoveDown() returned false unexpectedly.");
     for (; !_jrc.FAtEndOfAggregate(); (void)_jrc.FNextElement())
     {
-      _tyStrWRsv strKey;
       EJsonValueType jvt;
-      bool f = _jrc.FGetKeyCurrent(strKey, jvt);
-      if (!f)
-        THROWJSONBADUSAGE("FGetKeyCurrent() returned false unexpectedly.");
+      typename JsonReadCursor<t_tyJsonInputStream>::_tyStringView svKey = _jrc.SvKey(&jvt);
+      _tyStrWRsv strKey;
+      strKey.assign(svKey.data(), svKey.length());
       _tyJsoValue jvValue(jvt);
       jvValue.FromJSONStream(_jrc);
       std::pair<_tyIterator, bool> pib = m_mapValues.try_emplace(std::move(strKey), std::move(jvValue));
@@ -1354,11 +2020,10 @@ public:
     {
       if (!_rfFilter(_jrc, _rjvContainer))
         continue; // Skip this element.
-      _tyStrWRsv strKey;
       EJsonValueType jvt;
-      bool f = _jrc.FGetKeyCurrent(strKey, jvt);
-      if (!f)
-        THROWJSONBADUSAGE("FGetKeyCurrent() returned false unexpectedly.");
+      typename JsonReadCursor<t_tyJsonInputStream>::_tyStringView svKey = _jrc.SvKey(&jvt);
+      _tyStrWRsv strKey;
+      strKey.assign(svKey.data(), svKey.length());
       _tyJsoValue jvValue(jvt);
       jvValue.FromJSONStream(_jrc, _rfFilter);
       std::pair<_tyIterator, bool> pib = m_mapValues.try_emplace(std::move(strKey), std::move(jvValue));
@@ -1381,7 +2046,7 @@ public:
   template <class t_tyJsonOutputStream, class t_tyFilter>
   void ToJSONStream(JsonValueLife<t_tyJsonOutputStream> &_jvl, _tyJsoValue const &_rjvContainer, t_tyFilter &_rfFilter) const
   {
-    typedef JsoIterator<t_tyChar, true> _tyJsoIterator;
+    typedef JsoIterator<t_tyChar, true, t_tyObjectStorage, t_tyAllocator> _tyJsoIterator;
     _tyJsoIterator itCur(m_mapValues.begin());
     _tyJsoIterator const itEnd(m_mapValues.end());
     for (; itCur != itEnd; ++itCur)
@@ -1399,7 +2064,7 @@ protected:
 
 // _JsoArray:
 // This is internal impl only - never exposed to the user of JsoValue.
-template <class t_tyChar>
+template <class t_tyChar, class t_tyObjectStorage, class t_tyAllocator>
 class _JsoArray
 {
   typedef _JsoArray _tyThis;
@@ -1407,10 +2072,10 @@ class _JsoArray
 public:
   typedef t_tyChar _tyChar;
   typedef const t_tyChar *_tyLPCSTR;
-  typedef std::basic_string<t_tyChar> _tyStdStr;
+  typedef JsoValue<t_tyChar, t_tyObjectStorage, t_tyAllocator> _tyJsoValue;
+  typedef std::basic_string<t_tyChar, std::char_traits<t_tyChar>, typename std::allocator_traits<t_tyAllocator>::template rebind_alloc<t_tyChar>> _tyStdStr;
   typedef StrWRsv<_tyStdStr> _tyStrWRsv; // string with reserve buffer.
-  typedef JsoValue<t_tyChar> _tyJsoValue;
-  typedef std::vector<_tyJsoValue> _tyVectorValues;
+  typedef std::vector<_tyJsoValue, typename std::allocator_traits<t_tyAllocator>::template rebind_alloc<_tyJsoValue>> _tyVectorValues;
   typedef typename _tyVectorValues::iterator _tyIterator;
   typedef typename _tyVectorValues::const_iterator _tyConstIterator;
   typedef typename _tyVectorValues::value_type _tyVectorValueType;
@@ -1544,7 +2209,7 @@ public:
   template <class t_tyJsonOutputStream, class t_tyFilter>
   void ToJSONStream(JsonValueLife<t_tyJsonOutputStream> &_jvl, _tyJsoValue const &_rjvContainer, t_tyFilter &_rfFilter) const
   {
-    typedef JsoIterator<t_tyChar, true> _tyJsoIterator;
+    typedef JsoIterator<t_tyChar, true, t_tyObjectStorage, t_tyAllocator> _tyJsoIterator;
     _tyJsoIterator itCur(m_vecValues.begin());
     _tyJsoIterator const itEnd(m_vecValues.end());
     for (; itCur != itEnd; ++itCur)
@@ -1560,26 +2225,247 @@ protected:
   _tyVectorValues m_vecValues;
 };
 
+// JsoArena:
+// A monotonic arena - allocation bumps a pointer within the current chunk, deallocation does nothing and Release() frees every chunk at once.
+// A request of more than a quarter of the chunk size gets a chunk of its own so large arrays don't waste the rest of the current chunk.
+// Not thread safe - a document is built by a single thread.
+class JsoArena
+{
+  typedef JsoArena _tyThis;
+
+public:
+  static constexpr size_t s_kstDefaultChunkSize = size_t(1) << 20;
+
+  JsoArena(size_t _stChunkSize = s_kstDefaultChunkSize)
+      : m_stChunkSize(_stChunkSize)
+  {
+  }
+  ~JsoArena()
+  {
+    Release();
+  }
+  JsoArena(JsoArena const &) = delete;
+  JsoArena &operator=(JsoArena const &) = delete;
+
+  void *PvAllocate(size_t _stBytes, size_t _stAlign = alignof(std::max_align_t))
+  {
+    Assert(!(_stAlign & (_stAlign - 1)));
+    if (!_stBytes)
+      _stBytes = 1; // Distinct pointers for zero sized allocations.
+    uintptr_t uiCur = (uintptr_t(m_pbyCur) + _stAlign - 1) & ~uintptr_t(_stAlign - 1);
+    if (!m_pbyCur || (uiCur > uintptr_t(m_pbyEnd)) || (_stBytes > size_t(uintptr_t(m_pbyEnd) - uiCur)))
+      return _PvAllocateChunk(_stBytes, _stAlign);
+    m_pbyCur = (uint8_t *)uiCur + _stBytes;
+    m_stAllocated += _stBytes;
+    return (void *)uiCur;
+  }
+  // Free all chunks - anything allocated from the arena is gone, no destructors are run.
+  void Release() noexcept
+  {
+    while (!!m_pchHead)
+    {
+      _ChunkHeader *pch = m_pchHead;
+      m_pchHead = pch->m_pchNext;
+      ::free(pch);
+    }
+    m_pbyCur = m_pbyEnd = nullptr;
+    m_stAllocated = m_stReserved = 0;
+  }
+  size_t StAllocated() const
+  {
+    return m_stAllocated;
+  }
+  size_t StReserved() const
+  {
+    return m_stReserved;
+  }
+
+  // Scope:
+  // Make an arena the current arena for this thread for the lifetime of the Scope - JsoArenaAllocator allocates from the current arena.
+  class Scope
+  {
+  public:
+    explicit Scope(JsoArena &_ra)
+        : m_paPrev(s_tls_paCurrent)
+    {
+      s_tls_paCurrent = &_ra;
+    }
+    ~Scope()
+    {
+      s_tls_paCurrent = m_paPrev;
+    }
+    Scope(Scope const &) = delete;
+    Scope &operator=(Scope const &) = delete;
+
+  protected:
+    JsoArena *m_paPrev;
+  };
+  static JsoArena *PaGetCurrent()
+  {
+    return s_tls_paCurrent;
+  }
+
+protected:
+  struct _ChunkHeader
+  {
+    _ChunkHeader *m_pchNext;
+    size_t m_stSize;
+  };
+  void *_PvAllocateChunk(size_t _stBytes, size_t _stAlign)
+  {
+    size_t stNeeded = sizeof(_ChunkHeader) + _stAlign + _stBytes;
+    bool fDedicated = _stBytes > (m_stChunkSize / 4);
+    size_t stChunk = (fDedicated || (stNeeded > m_stChunkSize)) ? stNeeded : m_stChunkSize;
+    _ChunkHeader *pch = (_ChunkHeader *)::malloc(stChunk);
+    if (!pch)
+      THROWNAMEDBADALLOC("malloc failed");
+    pch->m_pchNext = m_pchHead;
+    pch->m_stSize = stChunk;
+    m_pchHead = pch;
+    m_stReserved += stChunk;
+    uintptr_t uiBegin = (uintptr_t(pch + 1) + _stAlign - 1) & ~uintptr_t(_stAlign - 1);
+    if (!fDedicated) // Otherwise leave the current chunk as it is - it likely has room left.
+    {
+      m_pbyCur = (uint8_t *)uiBegin + _stBytes;
+      m_pbyEnd = (uint8_t *)pch + stChunk;
+    }
+    m_stAllocated += _stBytes;
+    return (void *)uiBegin;
+  }
+  static inline thread_local JsoArena *s_tls_paCurrent{nullptr};
+  size_t m_stChunkSize;
+  _ChunkHeader *m_pchHead{nullptr};
+  uint8_t *m_pbyCur{nullptr};
+  uint8_t *m_pbyEnd{nullptr};
+  size_t m_stAllocated{0};
+  size_t m_stReserved{0};
+};
+
+// JsoArenaAllocator:
+// A stateless allocator that allocates from JsoArena::PaGetCurrent() - it is a usage error to allocate with no current arena.
+// Use as the t_tyAllocator of JsoValue - every node, string and container of the tree is then allocated in the arena and deallocation is a no-op.
+template <class t_ty>
+class JsoArenaAllocator
+{
+  typedef JsoArenaAllocator _tyThis;
+
+public:
+  typedef t_ty value_type;
+  typedef std::true_type is_always_equal;
+  typedef std::true_type propagate_on_container_move_assignment;
+
+  JsoArenaAllocator() noexcept = default;
+  template <class t_tyOther>
+  JsoArenaAllocator(JsoArenaAllocator<t_tyOther> const &) noexcept
+  {
+  }
+  t_ty *allocate(size_t _n)
+  {
+    JsoArena *pa = JsoArena::PaGetCurrent();
+    if (!pa)
+      THROWJSONBADUSAGE("No current JsoArena - use JsoArena::Scope.");
+    if (_n > (std::numeric_limits<size_t>::max)() / sizeof(t_ty))
+      throw std::bad_array_new_length();
+    return (t_ty *)pa->PvAllocate(_n * sizeof(t_ty), alignof(t_ty));
+  }
+  void deallocate(t_ty *, size_t) noexcept
+  {
+  }
+  template <class t_tyOther>
+  bool operator==(JsoArenaAllocator<t_tyOther> const &) const noexcept
+  {
+    return true;
+  }
+};
+
+// JsoArenaDocument:
+// A JsoValue tree allocated entirely within a JsoArena owned by the document. Destruction (and Clear()) releases the arena's chunks
+//  without walking the tree - O(1) in the number of values.
+// The tree may only be modified while the document's arena is current - i.e. within a JsoArena::Scope( RArenaGet() ). This includes
+//  CreateOrGetEl() and, with JsoObjectStorageMap, any lookup by key since that constructs a temporary key (which allocates for long keys).
+// The FromString() and FromJSONStream() methods below set the scope themselves.
+template <class t_tyChar, class t_tyObjectStorage = JsoObjectStorageMap>
+class JsoArenaDocument
+{
+  typedef JsoArenaDocument _tyThis;
+
+public:
+  typedef t_tyChar _tyChar;
+  typedef JsoValue<t_tyChar, t_tyObjectStorage, JsoArenaAllocator<char>> _tyJsoValue;
+
+  JsoArenaDocument(size_t _stChunkSize = JsoArena::s_kstDefaultChunkSize)
+      : m_arena(_stChunkSize)
+  {
+    Clear();
+  }
+  ~JsoArenaDocument() = default; // m_arena frees the tree without running its destructors.
+  JsoArenaDocument(JsoArenaDocument const &) = delete;
+  JsoArenaDocument &operator=(JsoArenaDocument const &) = delete;
+
+  _tyJsoValue &RJvGet()
+  {
+    return *m_pjvRoot;
+  }
+  const _tyJsoValue &RJvGet() const
+  {
+    return *m_pjvRoot;
+  }
+  JsoArena &RArenaGet()
+  {
+    return m_arena;
+  }
+  // Release the entire tree and leave an empty root.
+  void Clear()
+  {
+    m_pjvRoot = nullptr;
+    m_arena.Release();
+    m_pjvRoot = new (m_arena.PvAllocate(sizeof(_tyJsoValue), alignof(_tyJsoValue))) _tyJsoValue();
+  }
+
+  template <class t_tyStr>
+  void FromString(t_tyStr const &_rstr)
+  {
+    FromString(&_rstr[0], _rstr.length());
+  }
+  void FromString(const _tyChar *_psz, size_t _stLen)
+  {
+    Clear();
+    JsoArena::Scope scope(m_arena);
+    m_pjvRoot->FromString(_psz, _stLen);
+  }
+  template <class t_tyJsonInputStream>
+  void FromJSONStream(JsonReadCursor<t_tyJsonInputStream> &_jrc)
+  {
+    Clear();
+    JsoArena::Scope scope(m_arena);
+    m_pjvRoot->FromJSONStream(_jrc);
+  }
+
+protected:
+  JsoArena m_arena;
+  _tyJsoValue *m_pjvRoot{nullptr};
+};
+
 namespace n_JSONObjects
 {
 
   // Read data from a ReadCursor into a JSON object.
-  template <class t_tyJsonInputStream>
-  void StreamReadJsoValue(JsonReadCursor<t_tyJsonInputStream> &_jrc, JsoValue<typename t_tyJsonInputStream::_tyChar> &_jv)
+  template <class t_tyJsonInputStream, class t_tyObjectStorage, class t_tyAllocator>
+  void StreamReadJsoValue(JsonReadCursor<t_tyJsonInputStream> &_jrc, JsoValue<typename t_tyJsonInputStream::_tyChar, t_tyObjectStorage, t_tyAllocator> &_jv)
   {
     _jv.FromJSONStream(_jrc);
   }
 
-  template <class t_tyJsonInputStream>
+  template <class t_tyJsonInputStream, class t_tyObjectStorage = JsoObjectStorageMap>
   auto JsoValueStreamRead(JsonReadCursor<t_tyJsonInputStream> &_jrc)
-      -> JsoValue<typename t_tyJsonInputStream::_tyChar>
+      -> JsoValue<typename t_tyJsonInputStream::_tyChar, t_tyObjectStorage>
   {
-    JsoValue<typename t_tyJsonInputStream::_tyChar> jv(_jrc.JvtGetValueType());
+    JsoValue<typename t_tyJsonInputStream::_tyChar, t_tyObjectStorage> jv(_jrc.JvtGetValueType());
     jv.FromJSONStream(_jrc);
     return jv; // we expect clang/gcc to employ NRVO.
   }
 
-  template <class t_tyJsonInputStream, class t_tyJsonOutputStream>
+  template <class t_tyJsonInputStream, class t_tyJsonOutputStream, class t_tyObjectStorage = JsoObjectStorageMap>
   struct StreamJSONObjects
   {
     typedef t_tyJsonInputStream _tyJsonInputStream;
@@ -1593,7 +2479,7 @@ namespace n_JSONObjects
 
     static void Stream(const char *_pszInputFile, _tyPrFilenameHandle _prfnhOutput, bool _fReadOnly, bool _fCheckSkippedKey, const _tyJsonFormatSpec *_pjfs)
     {
-      typedef JsoValue<typename t_tyJsonInputStream::_tyChar> _tyJsoValue;
+      typedef JsoValue<typename t_tyJsonInputStream::_tyChar, t_tyObjectStorage> _tyJsoValue;
       _tyJsoValue jvRead;
       { //B
         _tyJsonInputStream jis;
@@ -1618,7 +2504,7 @@ namespace n_JSONObjects
     }
     static void Stream(vtyFileHandle _fileInput, _tyPrFilenameHandle _prfnhOutput, bool _fReadOnly, bool _fCheckSkippedKey, const _tyJsonFormatSpec *_pjfs)
     {
-      typedef JsoValue<typename t_tyJsonInputStream::_tyChar> _tyJsoValue;
+      typedef JsoValue<typename t_tyJsonInputStream::_tyChar, t_tyObjectStorage> _tyJsoValue;
       _tyJsoValue jvRead;
       { //B
         _tyJsonInputStream jis;
@@ -1643,7 +2529,7 @@ namespace n_JSONObjects
     }
     static void Stream(const char *_pszInputFile, const char *_pszOutputFile, bool _fReadOnly, bool _fCheckSkippedKey, const _tyJsonFormatSpec *_pjfs)
     {
-      typedef JsoValue<typename t_tyJsonInputStream::_tyChar> _tyJsoValue;
+      typedef JsoValue<typename t_tyJsonInputStream::_tyChar, t_tyObjectStorage> _tyJsoValue;
       _tyJsoValue jvRead;
       { //B
         _tyJsonInputStream jis;
@@ -1665,7 +2551,7 @@ namespace n_JSONObjects
     }
     static void Stream(vtyFileHandle _fileInput, const char *_pszOutputFile, bool _fReadOnly, bool _fCheckSkippedKey, const _tyJsonFormatSpec *_pjfs)
     {
-      typedef JsoValue<typename t_tyJsonInputStream::_tyChar> _tyJsoValue;
+      typedef JsoValue<typename t_tyJsonInputStream::_tyChar, t_tyObjectStorage> _tyJsoValue;
       _tyJsoValue jvRead;
       { //B
         _tyJsonInputStream jis;
@@ -8,380 +8,527 @@
 // jsonpath.h
 // JSON path objects and algorithms.
 // dbien 09APR2020
-
-#error Work in progress that may never progress.
+// A JsonPath is compiled from an RFC 6901 JSON pointer or from a subset of JSONPath and then matched against the values
+//  of a JsonReadCursor as they are streamed - subtrees that cannot match are skipped without being read into memory.
+// Supported JSONPath: $ followed by any sequence of: .name, ['name'], ["name"], ['a','b'], .*, [*], [n], [n,m,...], [start:end:step]
+//  and recursive descent of any of these: ..name, ..*, ..[n], etc.
+// Negative indices and slice bounds aren't supported since we don't know the length of an array until we have read it.
+// Filter expressions [?(...)] aren't supported.
 
 #include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include "jsonstrm.h"
 
-// JsonPath:
-// This represents the complete path object.
-template < class t_tyChar >
-class JsonPath
-{
-    typedef JsonPath _tyThis;
-public:
-    typedef t_tyChar _tyChar;
-    typedef std::basic_string< _tyChar > _tyStdStr;
-    typedef StrWRsv< _tyStdStr > _tyStrWRsv;
-
-    JsonPath() = default;
+__BIENUTIL_BEGIN_NAMESPACE
 
-
-};
-
-// _JsonPathElement:
-// This reprsents a segment of a JaonPath.
-// (.|..)( [name|*] | [ '['range|index|setofnames|expression']' ] )
-// When array notation is used then any leading single dot is redundant.
-template < class t_tyChar >
-class _JsonPathElement
+// This exception will get thrown when a path expression is invalid.
+class bad_json_path_exception : public _t__Named_exception<__JSONSTRM_DEFAULT_ALLOCATOR>
 {
-    typedef _JsonPathElement _tyThis;
+  typedef bad_json_path_exception _TyThis;
+  typedef _t__Named_exception<__JSONSTRM_DEFAULT_ALLOCATOR> _TyBase;
 public:
-    typedef t_tyChar _tyChar;
-    typedef std::basic_string< _tyChar > _tyStdStr;
-    typedef StrWRsv< _tyStdStr > _tyStrWRsv;
-
+  bad_json_path_exception( const char * _pc )
+      : _TyBase( _pc )
+  {
+  }
+  bad_json_path_exception(const string_type &__s)
+      : _TyBase(__s)
+  {
+  }
+  bad_json_path_exception(const char *_pcFmt, va_list _args)
+      : _TyBase(_pcFmt, _args)
+  {
+  }
 };
+// By default we will always add the __FILE__, __LINE__ even in retail for debugging purposes.
+#define THROWBADJSONPATH(MESG, ...) ExceptionUsage<bad_json_path_exception>::ThrowFileLineFunc(__FILE__, __LINE__, FUNCTION_PRETTY_NAME, MESG, ##__VA_ARGS__)
 
-// _JsonExpression
-// An expression that is within square brackets.
-// Note that any numeric constant without a decimal point '.' will be treated as an integer
-//  and will cause *truncation* of any corresponding JSON value.
-template < class t_tyChar >
-class _JsonExpression
+// What a single segment of the path selects from an object or array.
+enum EJsonPathSelector : uint8_t
 {
-    typedef _JsonExpression _tyThis;
-public:
-    typedef t_tyChar _tyChar;
-    typedef std::basic_string< _tyChar > _tyStdStr;
-    typedef StrWRsv< _tyStdStr > _tyStrWRsv;
-
-};
-
-enum _EJsonExprType : uint8_t
-{
-// Leaves - these form the basis of any expression.
-    ejetConstant, // A constant value. This is a JsoValue.
-    ejetArraySlice, // An array slice.
-    ejetSetOfKeys, // A set of 2 more more keys - referred to sometimes as a union - one or more of these names maybe matched.
-    ejetSingleKey, // a key must exist - not that if a key is included in an equation then we cannot match without it - keeping in mind that ORs are conditional.
-    ejetLastLeaf = ejetSingleKey,
-// Unary:
-    ejetNot,
-    ejetBitwiseNot,
-    ejetLastUnary = ejetBitwiseNot,
-// Binary:
-    ejetEquals,
-    ejetLessThan,
-    ejetLessThanOrEqual,
-    ejetGreaterThan,
-    ejetGreaterThanOrEqual,
-    ejetEJsonExprType // Leave this at the end.
+  ejpsKey,          // One or more keys of an object: .name, ['name'], ['a','b'].
+  ejpsWildcard,     // Every element of an object or array: .*, [*].
+  ejpsIndex,        // One or more indices of an array: [n], [n,m].
+  ejpsSlice,        // A range of indices of an array: [start:end:step].
+  ejpsPointerToken, // An RFC 6901 reference token - a key of an object or, if it is an array index, an element of an array.
+  ejpsJsonPathSelectorCount
 };
-typedef _EJsonExprType EJsonExprType;
 
-//_JsonExprOpBase
-// A single operation within a JsonExpression.
-// Abstract base class.
-template < class t_tyChar >
-class _JsonExprOpBase
+// _JsonPathElement:
+// This represents a segment of a JsonPath.
+template <class t_tyCharTraits>
+class _JsonPathElement
 {
-    typedef _JsonExprOpBase _tyThis;
+  typedef _JsonPathElement _tyThis;
 public:
-    typedef t_tyChar _tyChar;
-    typedef std::basic_string< _tyChar > _tyStdStr;
-    typedef StrWRsv< _tyStdStr > _tyStrWRsv;
-
-    virtual ~_JsonExprOpBase() = 0;
-    _JsonExprOpBase( EJsonExprType _jet = ejetEJsonExprType )
-        : m_jet( _jet )
+  typedef t_tyCharTraits _tyCharTraits;
+  typedef typename _tyCharTraits::_tyChar _tyChar;
+  typedef std::basic_string<_tyChar> _tyStdStr;
+  typedef std::basic_string_view<_tyChar> _tyStringView;
+  static constexpr size_t s_knNoIndex = (std::numeric_limits<size_t>::max)();
+
+  _JsonPathElement() = default;
+  _JsonPathElement(EJsonPathSelector _ejps, bool _fDescendant)
+      : m_ejps(_ejps),
+        m_fDescendant(_fDescendant)
+  {
+  }
+
+  EJsonPathSelector EjpsGet() const
+  {
+    return m_ejps;
+  }
+  // Recursive descent - this segment may match at any depth below the previous segment.
+  bool FDescendant() const
+  {
+    return m_fDescendant;
+  }
+  bool FMatchKey(_tyStringView _svKey) const
+  {
+    switch (m_ejps)
     {
+    case ejpsWildcard:
+      return true;
+    case ejpsKey:
+    case ejpsPointerToken:
+      return m_rgstrKeys.end() != std::find(m_rgstrKeys.begin(), m_rgstrKeys.end(), _svKey);
+    default:
+      return false;
     }
-
-protected:
-    EJsonExprType m_jet{ejetEJsonExprType};
-};
-
-//_JsonExprArgBase<T,0>:
-// A single operation within a JsonExpression.
-// Abstract base class.
-template < class t_tyChar, size_t t_knArgs >
-class _JsonExprArgBase : public _JsonExprOpBase< t_tyChar >
-{
-    typedef _JsonExprOpBase< t_tyChar > _tyBase;
-    typedef _JsonExprArgBase _tyThis;
-public:
-    typedef t_tyChar _tyChar;
-    typedef std::basic_string< _tyChar > _tyStdStr;
-    typedef StrWRsv< _tyStdStr > _tyStrWRsv;
-
-    virtual ~_JsonExprArgBase() = 0;
-    _JsonExprArgBase( EJsonExprType _jet = ejetEJsonExprType )
-        : _tyBase( _jet )
+  }
+  bool FMatchIndex(size_t _nIndex) const
+  {
+    return _nIndex == NNextIndex(_nIndex);
+  }
+  // Return the first index at or after _nIndex that this segment matches or s_knNoIndex if there is none.
+  size_t NNextIndex(size_t _nIndex) const
+  {
+    switch (m_ejps)
     {
-    }
-
-protected:
-};
-
-//_JsonExprArgBase<T,1>:
-// A single operation within a JsonExpression.
-// Abstract base class.
-template < class t_tyChar >
-class _JsonExprArgBase< t_tyChar, 1 > : public _JsonExprOpBase< t_tyChar >
-{
-    typedef _JsonExprOpBase< t_tyChar > _tyBase;
-    typedef _JsonExprArgBase _tyThis;
-public:
-    typedef _JsonExprOpBase< t_tyChar > _tyExprOpBase;
-    typedef t_tyChar _tyChar;
-    typedef std::basic_string< _tyChar > _tyStdStr;
-    typedef StrWRsv< _tyStdStr > _tyStrWRsv;
-
-    virtual ~_JsonExprArgBase() = 0;
-    _JsonExprArgBase( EJsonExprType _jet = ejetEJsonExprType )
-        : _tyBase( _jet )
+    case ejpsWildcard:
+      return _nIndex;
+    case ejpsIndex:
+    case ejpsPointerToken:
     {
+      std::vector<size_t>::const_iterator citFound = std::lower_bound(m_rgnIndices.begin(), m_rgnIndices.end(), _nIndex);
+      return (m_rgnIndices.end() == citFound) ? s_knNoIndex : *citFound;
     }
-
-protected:
-    _tyExprOpBase * m_peopArg0{nullptr};
-};
-
-//_JsonExprArgBase<T,2>:
-// A single operation within a JsonExpression.
-// Abstract base class.
-template < class t_tyChar >
-class _JsonExprArgBase< t_tyChar, 2 > : public _JsonExprOpBase< t_tyChar >
-{
-    typedef _JsonExprOpBase< t_tyChar > _tyBase;
-    typedef _JsonExprArgBase _tyThis;
-public:
-    typedef _JsonExprOpBase< t_tyChar > _tyExprOpBase;
-    typedef t_tyChar _tyChar;
-    typedef std::basic_string< _tyChar > _tyStdStr;
-    typedef StrWRsv< _tyStdStr > _tyStrWRsv;
-
-    virtual ~_JsonExprArgBase() = 0;
-    _JsonExprArgBase( EJsonExprType _jet = ejetEJsonExprType )
-        : _tyBase( _jet )
+    case ejpsSlice:
     {
+      if (_nIndex < m_nSliceBegin)
+        _nIndex = m_nSliceBegin;
+      else if (!!((_nIndex - m_nSliceBegin) % m_nSliceStep))
+      {
+        size_t nSteps = (_nIndex - m_nSliceBegin) / m_nSliceStep + 1;
+        if (nSteps > (s_knNoIndex - m_nSliceBegin) / m_nSliceStep)
+          return s_knNoIndex;
+        _nIndex = m_nSliceBegin + nSteps * m_nSliceStep;
+      }
+      return (_nIndex < m_nSliceEnd) ? _nIndex : s_knNoIndex;
     }
-
-protected:
-    _tyExprOpBase * m_peopArg0{nullptr};
-    _tyExprOpBase * m_peopArg1{nullptr};
-};
-
-// Leaves:
-// _JsonExprLeafConstant:
-template < class t_tyChar >
-class _JsonExprLeafConstant : public _JsonExprArgBase< t_tyChar, 0 >
-{
-    typedef _JsonExprArgBase< t_tyChar, 0 > _tyBase;
-    typedef  _JsonExprLeafConstant _tyThis;
-public:
-    typedef t_tyChar _tyChar;
-    typedef std::basic_string< _tyChar > _tyStdStr;
-    typedef StrWRsv< _tyStdStr > _tyStrWRsv;
-    typedef JsoValue< _tyChar > _tyJsoValue;
-
-    _JsonExprLeafConstant()
-        : _tyBase( ejetConstant )
-    {
+    default:
+      return s_knNoIndex;
     }
+  }
+
+  void AddKey(_tyStringView _svKey)
+  {
+    m_rgstrKeys.emplace_back(_svKey);
+  }
+  void AddIndex(size_t _nIndex)
+  {
+    m_rgnIndices.insert(std::upper_bound(m_rgnIndices.begin(), m_rgnIndices.end(), _nIndex), _nIndex);
+  }
+  void SetSlice(size_t _nBegin, size_t _nEnd, size_t _nStep)
+  {
+    Assert(ejpsSlice == m_ejps);
+    Assert(!!_nStep);
+    m_nSliceBegin = _nBegin;
+    m_nSliceEnd = _nEnd;
+    m_nSliceStep = _nStep;
+  }
 
 protected:
-    _tyJsoValue m_jvValue;
+  EJsonPathSelector m_ejps{ejpsJsonPathSelectorCount};
+  bool m_fDescendant{false};
+  std::vector<_tyStdStr> m_rgstrKeys;
+  std::vector<size_t> m_rgnIndices; // sorted.
+  size_t m_nSliceBegin{0};
+  size_t m_nSliceEnd{s_knNoIndex};
+  size_t m_nSliceStep{1};
 };
 
-template < class t_tyChar >
-class _JsonExprLeafArraySlice : public _JsonExprArgBase< t_tyChar, 0 >
+// JsonPath:
+// This represents the complete path object.
+template <class t_tyCharTraits>
+class JsonPath
 {
-    typedef _JsonExprArgBase< t_tyChar, 0 > _tyBase;
-    typedef  _JsonExprLeafArraySlice _tyThis;
+  typedef JsonPath _tyThis;
 public:
-    typedef t_tyChar _tyChar;
-    typedef std::basic_string< _tyChar > _tyStdStr;
-    typedef StrWRsv< _tyStdStr > _tyStrWRsv;
-    typedef JsoValue< _tyChar > _tyJsoValue;
-
-    _JsonExprLeafArraySlice()
-        : _tyBase( ejetArraySlice )
+  typedef t_tyCharTraits _tyCharTraits;
+  typedef typename _tyCharTraits::_tyChar _tyChar;
+  typedef std::basic_string<_tyChar> _tyStdStr;
+  typedef std::basic_string_view<_tyChar> _tyStringView;
+  typedef _JsonPathElement<_tyCharTraits> _tyJsonPathElement;
+  static constexpr size_t s_knNoIndex = _tyJsonPathElement::s_knNoIndex;
+
+  JsonPath() = default;
+  // Compile _svPath as a JSONPath if it starts with '$', otherwise as a JSON pointer.
+  JsonPath(_tyStringView _svPath)
+  {
+    Compile(_svPath);
+  }
+  void Compile(_tyStringView _svPath)
+  {
+    if (!_svPath.empty() && (_tyChar('$') == _svPath[0]))
+      CompileJsonPath(_svPath);
+    else
+      CompileJsonPointer(_svPath);
+  }
+  // RFC 6901: "" is the whole document, otherwise a sequence of "/token" where "~0" is '~' and "~1" is '/'.
+  void CompileJsonPointer(_tyStringView _svPointer)
+  {
+    m_rgjpe.clear();
+    if (_svPointer.empty())
+      return;
+    if (_tyChar('/') != _svPointer[0])
+      THROWBADJSONPATH("JSON pointer must be empty or start with '/'.");
+    const _tyChar *pcCur = _svPointer.data() + 1;
+    const _tyChar *const pcEnd = _svPointer.data() + _svPointer.size();
+    for (;;)
     {
+      _tyStdStr strToken;
+      for (; (pcEnd != pcCur) && (_tyChar('/') != *pcCur); ++pcCur)
+      {
+        if (_tyChar('~') != *pcCur)
+        {
+          strToken.push_back(*pcCur);
+          continue;
+        }
+        if ((pcEnd == ++pcCur) || ((_tyChar('0') != *pcCur) && (_tyChar('1') != *pcCur)))
+          THROWBADJSONPATH("Invalid '~' escape at offset [%zu] of JSON pointer.", size_t(pcCur - _svPointer.data()));
+        strToken.push_back((_tyChar('0') == *pcCur) ? _tyChar('~') : _tyChar('/'));
+      }
+      _tyJsonPathElement jpe(ejpsPointerToken, false);
+      jpe.AddKey(strToken);
+      // A token is also an array index if it is "0" or digits without a leading zero. "-" is past the end and so matches no element.
+      size_t nIndex;
+      if (!strToken.empty() && ((_tyChar('0') != strToken[0]) || (1 == strToken.size())) && _FParseIndex(strToken, nIndex))
+        jpe.AddIndex(nIndex);
+      m_rgjpe.push_back(std::move(jpe));
+      if (pcEnd == pcCur)
+        break;
+      ++pcCur; // skip the '/'.
     }
-
-protected:
-    typedef int32_t _tyIdxType;
-    _tyIdxType m_idxBegin{};
-    _tyIdxType m_idxEnd{};
-    _tyIdxType m_idxStep{};
-};
-
-// _JsonExprLeafSingleKey:
-template < class t_tyChar >
-class _JsonExprLeafSingleKey : public _JsonExprArgBase< t_tyChar, 0 >
-{
-    typedef _JsonExprArgBase< t_tyChar, 0 > _tyBase;
-    typedef  _JsonExprLeafSingleKey _tyThis;
-public:
-    typedef t_tyChar _tyChar;
-    typedef std::basic_string< _tyChar > _tyStdStr;
-    typedef StrWRsv< _tyStdStr > _tyStrWRsv;
-    typedef JsoValue< _tyChar > _tyJsoValue;
-
-    _JsonExprLeafSingleKey()
-        : _tyBase( ejetSingleKey )
+  }
+  void CompileJsonPath(_tyStringView _svPath)
+  {
+    m_rgjpe.clear();
+    _tyStringView svCur = _svPath;
+    if (svCur.empty() || (_tyChar('$') != svCur[0]))
+      THROWBADJSONPATH("JSONPath must start with '$'.");
+    svCur.remove_prefix(1);
+    auto lambdaOffset = [&_svPath, &svCur]() { return size_t(svCur.data() - _svPath.data()); };
+    while (!svCur.empty())
     {
+      bool fDescendant = false;
+      if (_tyChar('.') == svCur[0])
+      {
+        svCur.remove_prefix(1);
+        if (!svCur.empty() && (_tyChar('.') == svCur[0]))
+        {
+          fDescendant = true;
+          svCur.remove_prefix(1);
+        }
+        if (svCur.empty())
+          THROWBADJSONPATH("JSONPath ends with '.'.");
+        if (_tyChar('[') != svCur[0])
+        {
+          if (_tyChar('*') == svCur[0])
+          {
+            m_rgjpe.emplace_back(ejpsWildcard, fDescendant);
+            svCur.remove_prefix(1);
+            continue;
+          }
+          size_t nLenName = 0;
+          for (; (nLenName < svCur.size()) && (_tyChar('.') != svCur[nLenName]) && (_tyChar('[') != svCur[nLenName]); ++nLenName)
+            ;
+          if (!nLenName)
+            THROWBADJSONPATH("Expected a name at offset [%zu] of JSONPath.", lambdaOffset());
+          m_rgjpe.emplace_back(ejpsKey, fDescendant);
+          m_rgjpe.back().AddKey(svCur.substr(0, nLenName));
+          svCur.remove_prefix(nLenName);
+          continue;
+        }
+      }
+      if (_tyChar('[') != svCur[0])
+        THROWBADJSONPATH("Expected '.' or '[' at offset [%zu] of JSONPath.", lambdaOffset());
+      svCur.remove_prefix(1);
+      m_rgjpe.push_back(_JpeParseBracket(svCur, fDescendant, lambdaOffset));
     }
+  }
+
+  size_t NSegments() const
+  {
+    return m_rgjpe.size();
+  }
+  const _tyJsonPathElement &RGetSegment(size_t _nSegment) const
+  {
+    Assert(_nSegment < m_rgjpe.size());
+    return m_rgjpe[_nSegment];
+  }
+
+  // Match this path against the value at the current position of _rjrc - calling _rrfnMatch( _rjrc ) with the cursor at each matching value.
+  // _rrfnMatch may read the value and may navigate below it but must leave the cursor at the matched value.
+  // It may return void or bool - returning false stops the match.
+  // The cursor is left at the value it started at. Returns the number of matches.
+  template <class t_tyJsonInputStream, class t_tyFnMatch>
+  size_t NMatch(JsonReadCursor<t_tyJsonInputStream> &_rjrc, t_tyFnMatch &&_rrfnMatch) const
+  {
+    size_t nMatches = 0;
+    _tyRgStates rgStates{0};
+    (void)_FMatch(_rjrc, rgStates, _rrfnMatch, nMatches);
+    return nMatches;
+  }
 
 protected:
-    _tyStrWRsv m_strKey;
-};
+  typedef std::vector<size_t> _tyRgStates; // The indices of the segments we are waiting to match - NSegments() indicates a complete match.
 
-// _JsonExprLeafSetOfKeys:
-// This leaf has limited modifiers. There is no syntax for "!"(not) for instance currently.
-template < class t_tyChar >
-class _JsonExprLeafSetOfKeys : public _JsonExprArgBase< t_tyChar, 0 >
-{
-    typedef _JsonExprArgBase< t_tyChar, 0 > _tyBase;
-    typedef  _JsonExprLeafSetOfKeys _tyThis;
-public:
-    typedef t_tyChar _tyChar;
-    typedef std::basic_string< _tyChar > _tyStdStr;
-    typedef StrWRsv< _tyStdStr > _tyStrWRsv;
-    typedef JsoValue< _tyChar > _tyJsoValue;
-    typedef std::vector< _tyStrWRsv > _tyRgKeys;
-
-    _JsonExprLeafSetOfKeys()
-        : _tyBase( ejetSetOfKeys )
+  template <class t_tyJsonReadCursor, class t_tyFnMatch>
+  bool _FMatch(t_tyJsonReadCursor &_rjrc, _tyRgStates const &_rrgStates, t_tyFnMatch &_rfnMatch, size_t &_rnMatches) const
+  {
+    Assert(!_rrgStates.empty());
+    if (m_rgjpe.size() == _rrgStates.back()) // states are sorted.
     {
+      ++_rnMatches;
+      if constexpr (std::is_same_v<bool, std::invoke_result_t<t_tyFnMatch &, t_tyJsonReadCursor &>>)
+      {
+        if (!_rfnMatch(_rjrc))
+          return false;
+      }
+      else
+        _rfnMatch(_rjrc);
+      if (1 == _rrgStates.size())
+        return true;
     }
-
-protected:
-    _tyRgKeys m_rgKeys;
-};
-
-// Unary operators:
-// _JsonExprOpNot:
-template < class t_tyChar >
-class _JsonExprOpNot : public _JsonExprArgBase< t_tyChar, 1 >
-{
-    typedef _JsonExprArgBase< t_tyChar, 1 > _tyBase;
-    typedef  _JsonExprOpNot _tyThis;
-public:
-    typedef t_tyChar _tyChar;
-    typedef std::basic_string< _tyChar > _tyStdStr;
-    typedef StrWRsv< _tyStdStr > _tyStrWRsv;
-    typedef JsoValue< _tyChar > _tyJsoValue;
-
-    _JsonExprOpNot()
-        : _tyBase( ejetNot )
+    if (!_rjrc.FAtAggregateValue())
+      return true;
+    const bool kfObject = _rjrc.FAtObjectValue();
+    // If we are only looking for particular indices of an array then we can jump between them.
+    bool fJumpToIndex = !kfObject;
+    for (size_t nState : _rrgStates)
     {
+      if ((nState < m_rgjpe.size()) && m_rgjpe[nState].FDescendant())
+        fJumpToIndex = false;
     }
-};
-// _JsonExprOpBitwiseNot:
-template < class t_tyChar >
-class _JsonExprOpBitwiseNot : public _JsonExprArgBase< t_tyChar, 1 >
-{
-    typedef _JsonExprArgBase< t_tyChar, 1 > _tyBase;
-    typedef  _JsonExprOpBitwiseNot _tyThis;
-public:
-    typedef t_tyChar _tyChar;
-    typedef std::basic_string< _tyChar > _tyStdStr;
-    typedef StrWRsv< _tyStdStr > _tyStrWRsv;
-    typedef JsoValue< _tyChar > _tyJsoValue;
-
-    _JsonExprOpBitwiseNot()
-        : _tyBase( ejetBitwiseNot )
+    (void)_rjrc.FMoveDown();
+    _tyRgStates rgStatesChild;
+    for (size_t nIndex = 0; !_rjrc.FAtEndOfAggregate(); ++nIndex)
     {
+      if (fJumpToIndex)
+      {
+        size_t nIndexNext = s_knNoIndex;
+        for (size_t nState : _rrgStates)
+        {
+          if (nState < m_rgjpe.size())
+            nIndexNext = (std::min)(nIndexNext, m_rgjpe[nState].NNextIndex(nIndex));
+        }
+        if (s_knNoIndex == nIndexNext)
+          break; // Nothing more in this array can match - our caller will skip the rest.
+        if ((nIndexNext != nIndex) && !_rjrc.FSkipElements(nIndexNext - nIndex))
+          break;
+        nIndex = nIndexNext;
+      }
+      _tyStringView svKey;
+      if (kfObject)
+        svKey = _rjrc.SvKey();
+      rgStatesChild.clear();
+      for (size_t nState : _rrgStates)
+      {
+        if (nState == m_rgjpe.size())
+          continue;
+        const _tyJsonPathElement &rjpe = m_rgjpe[nState];
+        if (kfObject ? rjpe.FMatchKey(svKey) : rjpe.FMatchIndex(nIndex))
+          rgStatesChild.push_back(nState + 1);
+        if (rjpe.FDescendant())
+          rgStatesChild.push_back(nState);
+      }
+      if (!rgStatesChild.empty())
+      {
+        std::sort(rgStatesChild.begin(), rgStatesChild.end());
+        rgStatesChild.erase(std::unique(rgStatesChild.begin(), rgStatesChild.end()), rgStatesChild.end());
+        if (!_FMatch(_rjrc, rgStatesChild, _rfnMatch, _rnMatches))
+        {
+          (void)_rjrc.FMoveUp();
+          return false;
+        }
+      }
+      if (!_rjrc.FNextElement())
+        break;
     }
-};
-
-// Binary operators:
-// _JsonExprOpEquals:
-template < class t_tyChar >
-class _JsonExprOpEquals : public _JsonExprArgBase< t_tyChar, 2 >
-{
-    typedef _JsonExprArgBase< t_tyChar, 1 > _tyBase;
-    typedef  _JsonExprOpEquals _tyThis;
-public:
-    typedef t_tyChar _tyChar;
-    typedef std::basic_string< _tyChar > _tyStdStr;
-    typedef StrWRsv< _tyStdStr > _tyStrWRsv;
-    typedef JsoValue< _tyChar > _tyJsoValue;
-
-    _JsonExprOpEquals()
-        : _tyBase( ejetEquals )
+    (void)_rjrc.FMoveUp();
+    return true;
+  }
+  template <class t_tyStr>
+  static bool _FParseIndex(t_tyStr const &_rstr, size_t &_rnIndex)
+  {
+    _rnIndex = 0;
+    for (_tyChar tc : _rstr)
     {
+      if ((tc < _tyChar('0')) || (tc > _tyChar('9')) || (_rnIndex > ((s_knNoIndex - 1) - (tc - _tyChar('0'))) / 10))
+        return false;
+      _rnIndex = _rnIndex * 10 + (tc - _tyChar('0'));
     }
-};
-// _JsonExprOpLessThan:
-template < class t_tyChar >
-class _JsonExprOpLessThan : public _JsonExprArgBase< t_tyChar, 2 >
-{
-    typedef _JsonExprArgBase< t_tyChar, 1 > _tyBase;
-    typedef  _JsonExprOpLessThan _tyThis;
-public:
-    typedef t_tyChar _tyChar;
-    typedef std::basic_string< _tyChar > _tyStdStr;
-    typedef StrWRsv< _tyStdStr > _tyStrWRsv;
-    typedef JsoValue< _tyChar > _tyJsoValue;
-
-    _JsonExprOpLessThan()
-        : _tyBase( ejetLessThan )
+    return !_rstr.empty();
+  }
+  static void _SkipSpaces(_tyStringView &_rsvCur)
+  {
+    for (; !_rsvCur.empty() && (_tyChar(' ') == _rsvCur[0]); _rsvCur.remove_prefix(1))
+      ;
+  }
+  // Parse an unsigned integer or nothing - returns false if there is nothing.
+  template <class t_tyLambdaOffset>
+  static bool _FParseBracketIndex(_tyStringView &_rsvCur, size_t &_rnIndex, t_tyLambdaOffset &_rlambdaOffset)
+  {
+    _SkipSpaces(_rsvCur);
+    if (!_rsvCur.empty() && (_tyChar('-') == _rsvCur[0]))
+      THROWBADJSONPATH("Negative indices aren't supported at offset [%zu] of JSONPath.", _rlambdaOffset());
+    size_t nLen = 0;
+    for (; (nLen < _rsvCur.size()) && (_rsvCur[nLen] >= _tyChar('0')) && (_rsvCur[nLen] <= _tyChar('9')); ++nLen)
+      ;
+    if (!nLen)
+      return false;
+    if (!_FParseIndex(_rsvCur.substr(0, nLen), _rnIndex))
+      THROWBADJSONPATH("Index out of range at offset [%zu] of JSONPath.", _rlambdaOffset());
+    _rsvCur.remove_prefix(nLen);
+    _SkipSpaces(_rsvCur);
+    return true;
+  }
+  // Parse a quoted name - we are at the opening quote.
+  template <class t_tyLambdaOffset>
+  static _tyStdStr _StrParseQuoted(_tyStringView &_rsvCur, t_tyLambdaOffset &_rlambdaOffset)
+  {
+    const _tyChar tcQuote = _rsvCur[0];
+    _rsvCur.remove_prefix(1);
+    _tyStdStr strName;
+    for (;;)
     {
+      if (_rsvCur.empty())
+        THROWBADJSONPATH("Unterminated quoted name in JSONPath.");
+      _tyChar tc = _rsvCur[0];
+      _rsvCur.remove_prefix(1);
+      if (tcQuote == tc)
+        return strName;
+      if (_tyChar('\\') == tc)
+      {
+        if (_rsvCur.empty())
+          THROWBADJSONPATH("Unterminated quoted name in JSONPath.");
+        tc = _rsvCur[0];
+        _rsvCur.remove_prefix(1);
+        switch (tc)
+        {
+        case _tyChar('b'):
+          tc = _tyChar('\b');
+          break;
+        case _tyChar('f'):
+          tc = _tyChar('\f');
+          break;
+        case _tyChar('n'):
+          tc = _tyChar('\n');
+          break;
+        case _tyChar('r'):
+          tc = _tyChar('\r');
+          break;
+        case _tyChar('t'):
+          tc = _tyChar('\t');
+          break;
+        case _tyChar('\\'):
+        case _tyChar('/'):
+        case _tyChar('\''):
+        case _tyChar('"'):
+          break;
+        default:
+          THROWBADJSONPATH("Unsupported escape at offset [%zu] of JSONPath.", _rlambdaOffset());
+        }
+      }
+      strName.push_back(tc);
     }
-};
-// _JsonExprOpLessThanOrEqual:
-template < class t_tyChar >
-class _JsonExprOpLessThanOrEqual : public _JsonExprArgBase< t_tyChar, 2 >
-{
-    typedef _JsonExprArgBase< t_tyChar, 1 > _tyBase;
-    typedef  _JsonExprOpLessThanOrEqual _tyThis;
-public:
-    typedef t_tyChar _tyChar;
-    typedef std::basic_string< _tyChar > _tyStdStr;
-    typedef StrWRsv< _tyStdStr > _tyStrWRsv;
-    typedef JsoValue< _tyChar > _tyJsoValue;
-
-    _JsonExprOpLessThanOrEqual()
-        : _tyBase( ejetLessThanOrEqual )
+  }
+  // Parse the contents of [...] - we are just past the '['.
+  template <class t_tyLambdaOffset>
+  static _tyJsonPathElement _JpeParseBracket(_tyStringView &_rsvCur, bool _fDescendant, t_tyLambdaOffset &_rlambdaOffset)
+  {
+    _tyJsonPathElement jpe;
+    _SkipSpaces(_rsvCur);
+    if (_rsvCur.empty())
+      THROWBADJSONPATH("Unterminated '[' in JSONPath.");
+    if (_tyChar('?') == _rsvCur[0])
+      THROWBADJSONPATH("Filter expressions aren't supported at offset [%zu] of JSONPath.", _rlambdaOffset());
+    if (_tyChar('*') == _rsvCur[0])
     {
+      jpe = _tyJsonPathElement(ejpsWildcard, _fDescendant);
+      _rsvCur.remove_prefix(1);
+      _SkipSpaces(_rsvCur);
     }
-};
-// _JsonExprOpGreaterThan:
-template < class t_tyChar >
-class _JsonExprOpGreaterThan : public _JsonExprArgBase< t_tyChar, 2 >
-{
-    typedef _JsonExprArgBase< t_tyChar, 1 > _tyBase;
-    typedef  _JsonExprOpGreaterThan _tyThis;
-public:
-    typedef t_tyChar _tyChar;
-    typedef std::basic_string< _tyChar > _tyStdStr;
-    typedef StrWRsv< _tyStdStr > _tyStrWRsv;
-    typedef JsoValue< _tyChar > _tyJsoValue;
-
-    _JsonExprOpGreaterThan()
-        : _tyBase( ejetGreaterThan )
+    else if ((_tyChar('\'') == _rsvCur[0]) || (_tyChar('"') == _rsvCur[0]))
     {
+      jpe = _tyJsonPathElement(ejpsKey, _fDescendant);
+      for (;;)
+      {
+        jpe.AddKey(_StrParseQuoted(_rsvCur, _rlambdaOffset));
+        _SkipSpaces(_rsvCur);
+        if (_rsvCur.empty() || (_tyChar(',') != _rsvCur[0]))
+          break;
+        _rsvCur.remove_prefix(1);
+        _SkipSpaces(_rsvCur);
+        if (_rsvCur.empty() || ((_tyChar('\'') != _rsvCur[0]) && (_tyChar('"') != _rsvCur[0])))
+          THROWBADJSONPATH("Expected a quoted name at offset [%zu] of JSONPath.", _rlambdaOffset());
+      }
     }
-};
-// _JsonExprOpGreaterThanOrEqual:
-template < class t_tyChar >
-class _JsonExprOpGreaterThanOrEqual : public _JsonExprArgBase< t_tyChar, 2 >
-{
-    typedef _JsonExprArgBase< t_tyChar, 1 > _tyBase;
-    typedef  _JsonExprOpGreaterThanOrEqual _tyThis;
-public:
-    typedef t_tyChar _tyChar;
-    typedef std::basic_string< _tyChar > _tyStdStr;
-    typedef StrWRsv< _tyStdStr > _tyStrWRsv;
-    typedef JsoValue< _tyChar > _tyJsoValue;
-
-    _JsonExprOpGreaterThanOrEqual()
-        : _tyBase( ejetGreaterThanOrEqual )
+    else
     {
+      size_t nFirst = 0;
+      bool fHaveFirst = _FParseBracketIndex(_rsvCur, nFirst, _rlambdaOffset);
+      if (!_rsvCur.empty() && (_tyChar(':') == _rsvCur[0]))
+      {
+        size_t nEnd = s_knNoIndex, nStep = 1;
+        _rsvCur.remove_prefix(1);
+        (void)_FParseBracketIndex(_rsvCur, nEnd, _rlambdaOffset);
+        if (!_rsvCur.empty() && (_tyChar(':') == _rsvCur[0]))
+        {
+          _rsvCur.remove_prefix(1);
+          if (_FParseBracketIndex(_rsvCur, nStep, _rlambdaOffset) && !nStep)
+            THROWBADJSONPATH("Slice step of zero at offset [%zu] of JSONPath.", _rlambdaOffset());
+        }
+        jpe = _tyJsonPathElement(ejpsSlice, _fDescendant);
+        jpe.SetSlice(fHaveFirst ? nFirst : 0, nEnd, nStep);
+      }
+      else
+      {
+        if (!fHaveFirst)
+          THROWBADJSONPATH("Expected '*', a quoted name, an index or a slice at offset [%zu] of JSONPath.", _rlambdaOffset());
+        jpe = _tyJsonPathElement(ejpsIndex, _fDescendant);
+        jpe.AddIndex(nFirst);
+        while (!_rsvCur.empty() && (_tyChar(',') == _rsvCur[0]))
+        {
+          _rsvCur.remove_prefix(1);
+          if (!_FParseBracketIndex(_rsvCur, nFirst, _rlambdaOffset))
+            THROWBADJSONPATH("Expected an index at offset [%zu] of JSONPath.", _rlambdaOffset());
+          jpe.AddIndex(nFirst);
+        }
+      }
     }
+    if (_rsvCur.empty() || (_tyChar(']') != _rsvCur[0]))
+      THROWBADJSONPATH("Expected ']' at offset [%zu] of JSONPath.", _rlambdaOffset());
+    _rsvCur.remove_prefix(1);
+    return jpe;
+  }
+
+  std::vector<_tyJsonPathElement> m_rgjpe;
 };
+
+__BIENUTIL_END_NAMESPACE
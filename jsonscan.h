@@ -0,0 +1,201 @@
+#pragma once
+
+//          Copyright David Lawrence Bien 1997 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt).
+
+// jsonscan.h
+// Block scanning kernels for in-memory JSON input streams and for escaping JSON strings on output.
+// These process 16 (SSE2) or 32 (AVX2) bytes at a time for 8 and 16 bit characters and fall back to a scalar loop otherwise.
+// AVX2 is selected at runtime when the CPU supports it (gcc/clang only), SSE2 is the x64 baseline.
+
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+#include "bienutil.h"
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+#define JSONSCAN_SSE2 1
+#include <emmintrin.h>
+#if ( defined( __GNUC__ ) || defined( __clang__ ) ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#define JSONSCAN_AVX2 1
+#include <immintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+__BIENUTIL_BEGIN_NAMESPACE
+
+namespace n_JsonScan
+{
+
+// Which characters a kernel is looking for.
+enum EScanKind
+{
+  eskNonWhitespace,       // The first character that isn't JSON whitespace ( ' ', '\t', '\n', '\r' ).
+  eskStringSpecial,       // The first '"', '\\' or illegal character (null) - i.e. the end of a run of plain string characters.
+  eskStructural,          // The first '{', '}', '[', ']', ':', ',', '"' or '\\' - used outside of strings when building a structural index.
+  eskEscape,              // The first character that must be escaped within a JSON string on output: '"', '\\' or a control character (< 0x20).
+};
+
+template < class t_tyChar >
+inline bool FIsMatch( EScanKind _esk, t_tyChar _tc )
+{
+  if ( eskNonWhitespace == _esk )
+    return !( ( t_tyChar( ' ' ) == _tc ) || ( t_tyChar( '\t' ) == _tc ) || ( t_tyChar( '\n' ) == _tc ) || ( t_tyChar( '\r' ) == _tc ) );
+  if ( eskStructural == _esk )
+    return ( t_tyChar( '{' ) == _tc ) || ( t_tyChar( '}' ) == _tc ) || ( t_tyChar( '[' ) == _tc ) || ( t_tyChar( ']' ) == _tc ) ||
+           ( t_tyChar( ':' ) == _tc ) || ( t_tyChar( ',' ) == _tc ) || ( t_tyChar( '"' ) == _tc ) || ( t_tyChar( '\\' ) == _tc );
+  if ( eskEscape == _esk )
+    return ( std::make_unsigned_t< t_tyChar >( _tc ) < 0x20 ) || ( t_tyChar( '"' ) == _tc ) || ( t_tyChar( '\\' ) == _tc );
+  return ( t_tyChar( '"' ) == _tc ) || ( t_tyChar( '\\' ) == _tc ) || ( t_tyChar( 0 ) == _tc );
+}
+template < class t_tyChar >
+inline const t_tyChar * PcScanScalar( EScanKind _esk, const t_tyChar * _pcCur, const t_tyChar * _pcEnd )
+{
+  for ( ; ( _pcEnd != _pcCur ) && !FIsMatch( _esk, *_pcCur ); ++_pcCur )
+    ;
+  return _pcCur;
+}
+
+#ifdef JSONSCAN_SSE2
+inline unsigned UCountTrailingZeros( uint32_t _u )
+{
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward( &index, _u );
+  return index;
+#else
+  return __builtin_ctz( _u );
+#endif
+}
+// Return a mask of the bytes in the 16 byte block which match what we are looking for.
+template < size_t t_kstCharSize >
+inline uint32_t UMatchMaskSSE2( EScanKind _esk, __m128i _v )
+{
+  auto lambdaCmpEq = [_v]( int _iChar )
+  {
+    if constexpr ( 1 == t_kstCharSize )
+      return _mm_cmpeq_epi8( _v, _mm_set1_epi8( char( _iChar ) ) );
+    else
+      return _mm_cmpeq_epi16( _v, _mm_set1_epi16( short( _iChar ) ) );
+  };
+  if ( eskNonWhitespace == _esk )
+  {
+    __m128i vWs = _mm_or_si128( _mm_or_si128( lambdaCmpEq( ' ' ), lambdaCmpEq( '\t' ) ), _mm_or_si128( lambdaCmpEq( '\n' ), lambdaCmpEq( '\r' ) ) );
+    return ~uint32_t( _mm_movemask_epi8( vWs ) ) & 0xffff;
+  }
+  if ( eskStructural == _esk )
+  {
+    __m128i vBrackets = _mm_or_si128( _mm_or_si128( lambdaCmpEq( '{' ), lambdaCmpEq( '}' ) ), _mm_or_si128( lambdaCmpEq( '[' ), lambdaCmpEq( ']' ) ) );
+    __m128i vOther = _mm_or_si128( _mm_or_si128( lambdaCmpEq( ':' ), lambdaCmpEq( ',' ) ), _mm_or_si128( lambdaCmpEq( '"' ), lambdaCmpEq( '\\' ) ) );
+    return uint32_t( _mm_movemask_epi8( _mm_or_si128( vBrackets, vOther ) ) );
+  }
+  if ( eskEscape == _esk )
+  { // Control characters are those with none of the bits above 0x1f set.
+    __m128i vControl;
+    if constexpr ( 1 == t_kstCharSize )
+      vControl = _mm_cmpeq_epi8( _mm_and_si128( _v, _mm_set1_epi8( char( 0xe0 ) ) ), _mm_setzero_si128() );
+    else
+      vControl = _mm_cmpeq_epi16( _mm_and_si128( _v, _mm_set1_epi16( short( 0xffe0 ) ) ), _mm_setzero_si128() );
+    return uint32_t( _mm_movemask_epi8( _mm_or_si128( vControl, _mm_or_si128( lambdaCmpEq( '"' ), lambdaCmpEq( '\\' ) ) ) ) );
+  }
+  __m128i vSpecial = _mm_or_si128( _mm_or_si128( lambdaCmpEq( '"' ), lambdaCmpEq( '\\' ) ), lambdaCmpEq( 0 ) );
+  return uint32_t( _mm_movemask_epi8( vSpecial ) );
+}
+#endif //JSONSCAN_SSE2
+
+#ifdef JSONSCAN_AVX2
+template < size_t t_kstCharSize >
+__attribute__(( target( "avx2" ) )) inline uint32_t UMatchMaskAVX2( EScanKind _esk, __m256i _v )
+{
+  auto lambdaCmpEq = [_v]( int _iChar ) __attribute__(( target( "avx2" ) ))
+  {
+    if constexpr ( 1 == t_kstCharSize )
+      return _mm256_cmpeq_epi8( _v, _mm256_set1_epi8( char( _iChar ) ) );
+    else
+      return _mm256_cmpeq_epi16( _v, _mm256_set1_epi16( short( _iChar ) ) );
+  };
+  if ( eskNonWhitespace == _esk )
+  {
+    __m256i vWs = _mm256_or_si256( _mm256_or_si256( lambdaCmpEq( ' ' ), lambdaCmpEq( '\t' ) ), _mm256_or_si256( lambdaCmpEq( '\n' ), lambdaCmpEq( '\r' ) ) );
+    return ~uint32_t( _mm256_movemask_epi8( vWs ) );
+  }
+  if ( eskStructural == _esk )
+  {
+    __m256i vBrackets = _mm256_or_si256( _mm256_or_si256( lambdaCmpEq( '{' ), lambdaCmpEq( '}' ) ), _mm256_or_si256( lambdaCmpEq( '[' ), lambdaCmpEq( ']' ) ) );
+    __m256i vOther = _mm256_or_si256( _mm256_or_si256( lambdaCmpEq( ':' ), lambdaCmpEq( ',' ) ), _mm256_or_si256( lambdaCmpEq( '"' ), lambdaCmpEq( '\\' ) ) );
+    return uint32_t( _mm256_movemask_epi8( _mm256_or_si256( vBrackets, vOther ) ) );
+  }
+  if ( eskEscape == _esk )
+  {
+    __m256i vControl;
+    if constexpr ( 1 == t_kstCharSize )
+      vControl = _mm256_cmpeq_epi8( _mm256_and_si256( _v, _mm256_set1_epi8( char( 0xe0 ) ) ), _mm256_setzero_si256() );
+    else
+      vControl = _mm256_cmpeq_epi16( _mm256_and_si256( _v, _mm256_set1_epi16( short( 0xffe0 ) ) ), _mm256_setzero_si256() );
+    return uint32_t( _mm256_movemask_epi8( _mm256_or_si256( vControl, _mm256_or_si256( lambdaCmpEq( '"' ), lambdaCmpEq( '\\' ) ) ) ) );
+  }
+  __m256i vSpecial = _mm256_or_si256( _mm256_or_si256( lambdaCmpEq( '"' ), lambdaCmpEq( '\\' ) ), lambdaCmpEq( 0 ) );
+  return uint32_t( _mm256_movemask_epi8( vSpecial ) );
+}
+// Scan full 32 byte blocks - returns the matching character or the start of the remaining partial block.
+template < class t_tyChar >
+__attribute__(( target( "avx2" ) )) inline const t_tyChar * PcScanAVX2( EScanKind _esk, const t_tyChar * _pcCur, const t_tyChar * _pcEnd )
+{
+  const size_t kstCharsPerBlock = 32 / sizeof( t_tyChar );
+  for ( ; size_t( _pcEnd - _pcCur ) >= kstCharsPerBlock; _pcCur += kstCharsPerBlock )
+  {
+    uint32_t uMask = UMatchMaskAVX2< sizeof( t_tyChar ) >( _esk, _mm256_loadu_si256( (const __m256i *)_pcCur ) );
+    if ( !!uMask )
+      return _pcCur + ( __builtin_ctz( uMask ) / sizeof( t_tyChar ) );
+  }
+  return _pcCur;
+}
+inline bool FHasAVX2()
+{
+  static const bool s_kfHasAVX2 = []()
+  {
+    __builtin_cpu_init();
+    return !!__builtin_cpu_supports( "avx2" );
+  }();
+  return s_kfHasAVX2;
+}
+#endif //JSONSCAN_AVX2
+
+// Return the first character in [_pcCur,_pcEnd) matching _esk, or _pcEnd if there is none.
+template < class t_tyChar >
+inline const t_tyChar * PcScan( EScanKind _esk, const t_tyChar * _pcCur, const t_tyChar * _pcEnd )
+{
+#ifdef JSONSCAN_SSE2
+  if constexpr ( ( 1 == sizeof( t_tyChar ) ) || ( 2 == sizeof( t_tyChar ) ) )
+  {
+    const size_t kstCharsPerBlock = 16 / sizeof( t_tyChar );
+    // Most whitespace runs and many strings are short - don't bother with the blocks unless there is a mismatch on the first char.
+    if ( ( _pcEnd == _pcCur ) || FIsMatch( _esk, *_pcCur ) )
+      return _pcCur;
+#ifdef JSONSCAN_AVX2
+    if ( ( size_t( _pcEnd - _pcCur ) >= 2 * kstCharsPerBlock ) && FHasAVX2() )
+    {
+      _pcCur = PcScanAVX2( _esk, _pcCur, _pcEnd );
+      if ( ( _pcEnd != _pcCur ) && FIsMatch( _esk, *_pcCur ) )
+        return _pcCur;
+    }
+#endif //JSONSCAN_AVX2
+    for ( ; size_t( _pcEnd - _pcCur ) >= kstCharsPerBlock; _pcCur += kstCharsPerBlock )
+    {
+      uint32_t uMask = UMatchMaskSSE2< sizeof( t_tyChar ) >( _esk, _mm_loadu_si128( (const __m128i *)_pcCur ) );
+      if ( !!uMask )
+        return _pcCur + ( UCountTrailingZeros( uMask ) / sizeof( t_tyChar ) );
+    }
+  }
+#endif //JSONSCAN_SSE2
+  return PcScanScalar( _esk, _pcCur, _pcEnd );
+}
+
+} // namespace n_JsonScan
+
+__BIENUTIL_END_NAMESPACE
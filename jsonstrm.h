@@ -10,10 +10,24 @@
 // dbien: 17FEB2020
 
 #include <string>
+#include <string_view>
 #include <ostream>
 #include <memory>
 #include <compare>
+#include <concepts>
 #include <utility>
+#include <charconv>
+#include <limits>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <exception>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <chrono>
 #ifndef WIN32
 #include <unistd.h>
 #include <sys/mman.h>
@@ -34,6 +48,7 @@
 #include "memfile.h"
 #include "syslogmgr.h"
 #include "strwrsv.h"
+#include "jsonscan.h"
 
 // jsonstrm.h
 // This implements JSON streaming in/out.
@@ -583,7 +598,7 @@ struct JsonCharTraits<char32_t>
   static const _tyChar s_tcF = U'F';
   static const _tyChar s_tct = U't';
   static const _tyChar s_tcr = U'r';
-  static const _tyChar s_tcu = U'U';
+  static const _tyChar s_tcu = U'u';
   static const _tyChar s_tcl = U'l';
   static const _tyChar s_tcs = U's';
   static const _tyChar s_tcn = U'n';
@@ -807,6 +822,8 @@ public:
 };
 
 // JsonFileInputStream: A class using open(), read(), etc.
+// We read the file in blocks of m_stBlockSize bytes into a private buffer and serve characters from that buffer.
+// Note that this means the file descriptor's position will be ahead of the logical position of the stream - ByPosGet() returns the logical position.
 template <class t_tyCharTraits, class t_tyPersistAsChar = typename t_tyCharTraits::_tyPersistAsChar>
 class JsonFileInputStream : public JsonInputStreamBase<t_tyCharTraits, size_t>
 {
@@ -818,6 +835,7 @@ public:
   typedef t_tyPersistAsChar _tyPersistAsChar;
   typedef size_t _tyFilePos;
   typedef JsonReadCursor<_tyThis> _tyJsonReadCursor;
+  static const size_t s_kstDefaultBlockSize = 65536;
 
   ~JsonFileInputStream() = default;
   JsonFileInputStream() = default;
@@ -830,6 +848,10 @@ public:
     m_szFilename.swap( _r.m_szFilename );
     std::swap( m_pos, _r.m_pos );
     m_foFile.swap( _r.m_foFile );
+    m_rgbyBuffer.swap( _r.m_rgbyBuffer );
+    std::swap( m_stBlockSize, _r.m_stBlockSize );
+    std::swap( m_stBufferCur, _r.m_stBufferCur );
+    std::swap( m_stBufferEnd, _r.m_stBufferEnd );
     std::swap( m_tcLookahead, _r.m_tcLookahead );
     std::swap( m_fHasLookahead, _r.m_fHasLookahead );
     std::swap( m_fUseSeek, _r.m_fUseSeek );
@@ -838,6 +860,20 @@ public:
   {
     return m_foFile.FIsOpen();
   }
+  // Set the size of the block we read from the file at a time. This must be called before Open() or AttachFd().
+  void SetBlockSize( size_t _stBlockSize )
+  {
+    Assert( !FOpened() );
+    if ( FOpened() )
+      THROWBADJSONSEMANTICUSE( "SetBlockSize() must be called before the stream is opened." );
+    // We must be able to hold at least one full character in the buffer:
+    m_stBlockSize = (std::max)( _stBlockSize, sizeof( _tyPersistAsChar ) );
+    m_rgbyBuffer.reset();
+  }
+  size_t StGetBlockSize() const
+  {
+    return m_stBlockSize;
+  }
   // Throws on open failure. This object owns the lifetime of the file descriptor.
   void Open(const char *_szFilename, bool _fUseSeek = true)
   {
@@ -848,8 +884,10 @@ public:
     m_szFilename = _szFilename; // For error reporting and general debugging. Of course we don't need to store this.
     m_fUseSeek = _fUseSeek;
     m_pos = 0;
+    m_stBufferCur = m_stBufferEnd = 0;
   }
   // Attach to an FD whose lifetime we do not own. This can be used, for instance, to attach to stdin which is usually at FD 0 unless reopen()ed.
+  // Since we read ahead in blocks the FD will be positioned beyond what we have consumed when we are done with it.
   void AttachFd(vtyFileHandle _hFile, bool _fUseSeek = false, bool _fOwnFileLifetime = false )
   {
     Assert(_hFile != vkhInvalidFileHandle);
@@ -858,9 +896,11 @@ public:
     m_szFilename.clear();     // No filename indicates we are attached to "some hFile".
     m_fUseSeek = _fUseSeek;
     m_pos = 0;
+    m_stBufferCur = m_stBufferEnd = 0;
   }
   int Close()
   {
+    m_stBufferCur = m_stBufferEnd = 0;
     return m_foFile.Close();
   }
   // Attach to this FOpened() JsonFileInputStream.
@@ -876,22 +916,15 @@ public:
     // We will keep reading characters until we find non-whitespace:
     if (m_fHasLookahead && !_tyCharTraits::FIsWhitespace(m_tcLookahead))
       return;
-    size_t stRead;
     for (;;)
     {
       _tyPersistAsChar cpxRead;
-      int iReadResult = FileRead( m_foFile.HFileGet(), &cpxRead, sizeof cpxRead, &stRead );
-      if (-1 == iReadResult)
-        THROWBADJSONSTREAMERRNO(GetLastErrNo(), "FileRead() failed for file [%s]", m_szFilename.c_str());
-      m_tcLookahead = cpxRead;
-      m_pos += stRead;
-      if (stRead != sizeof cpxRead)
-        THROWBADJSONSTREAMERRNO(GetLastErrNo(), "FileRead() for file [%s] had [%zu] leftover bytes.", m_szFilename.c_str(), stRead);
-      if (!stRead)
+      if (!_FReadPersistChar(cpxRead))
       {
         m_fHasLookahead = false;
         return; // We have skipped the whitespace until we hit EOF.
       }
+      m_tcLookahead = cpxRead;
       if (_tyCharTraits::FIsIllegalChar(m_tcLookahead))
         THROWBADJSONSTREAM("Found illegal char [%TC] in file [%s]", m_tcLookahead ? m_tcLookahead : '?', m_szFilename.c_str());
       if (!_tyCharTraits::FIsWhitespace(m_tcLookahead))
@@ -901,23 +934,22 @@ public:
       }
     }
   }
-  // Throws if lseek() fails.
+  // We maintain the logical position ourselves since the file position is ahead of us by the amount buffered.
+  // When m_fUseSeek we check that the file agrees with us in debug. Throws if lseek() fails.
   _tyFilePos ByPosGet() const
   {
     Assert(FOpened());
+#if ASSERTSENABLED
     if (m_fUseSeek)
     {
       vtySeekOffset pos;
       int iSeekResult = FileSeek( m_foFile.HFileGet(), 0, vkSeekCur, &pos );
       if (-1 == iSeekResult)
         THROWBADJSONSTREAMERRNO(GetLastErrNo(), "FileSeek() failed for file [%s]", m_szFilename.c_str());
-      Assert(pos == m_pos); // These should always match.
-      if (m_fHasLookahead)
-        pos -= sizeof m_tcLookahead; // Since we have a lookahead we are actually one character before.
-      return pos;
+      Assert((_tyFilePos)pos == m_pos + (m_stBufferEnd - m_stBufferCur)); // These should always match.
     }
-    else
-      return m_pos - (m_fHasLookahead ? sizeof m_tcLookahead : 0);
+#endif //ASSERTSENABLED
+    return m_pos - (m_fHasLookahead ? sizeof(_tyPersistAsChar) : 0); // If we have a lookahead we are actually one character before.
   }
   // Read a single character from the file - always throw on EOF.
   _tyChar ReadChar(const char *_pcEOFMessage)
@@ -929,21 +961,11 @@ public:
       return m_tcLookahead;
     }
     _tyPersistAsChar cpxRead;
-    size_t stRead;
-    int iReadResult = FileRead( m_foFile.HFileGet(), &cpxRead, sizeof cpxRead, &stRead );
-    if (-1 == iReadResult)
-      THROWBADJSONSTREAMERRNO(GetLastErrNo(), "FileRead() failed for file [%s]", m_szFilename.c_str());
-    m_tcLookahead = cpxRead;
-    if (stRead != sizeof cpxRead)
-    {
-      Assert(!stRead); // For multibyte characters this could fail but then we would have a bogus file anyway and would want to throw.
-      m_pos += stRead;
+    if (!_FReadPersistChar(cpxRead))
       THROWBADJSONSTREAM("[%s]: %s", m_szFilename.c_str(), _pcEOFMessage);
-    }
+    m_tcLookahead = cpxRead;
     if (_tyCharTraits::FIsIllegalChar(m_tcLookahead))
       THROWBADJSONSTREAM("Found illegal char [%TC] in file [%s]", m_tcLookahead ? m_tcLookahead : '?', m_szFilename.c_str());
-    m_pos += stRead;
-    Assert(!m_fHasLookahead);
     return m_tcLookahead;
   }
   bool FReadChar(_tyChar &_rtch, bool _fThrowOnEOF, const char *_pcEOFMessage)
@@ -956,28 +978,15 @@ public:
       return true;
     }
     _tyPersistAsChar cpxRead;
-    size_t stRead;
-    int iReadResult = FileRead( m_foFile.HFileGet(), &cpxRead, sizeof cpxRead, &stRead );
-    if (-1 == iReadResult)
-      THROWBADJSONSTREAMERRNO(GetLastErrNo(), "FileRead() failed for file [%s]", m_szFilename.c_str());
-    m_tcLookahead = cpxRead;
-    if (stRead != sizeof cpxRead)
+    if (!_FReadPersistChar(cpxRead))
     {
-      if (!!stRead)
-      {
-        m_pos += stRead;
-        THROWBADJSONSTREAMERRNO(GetLastErrNo(), "read() for file [%s] had [%zu] leftover bytes.", m_szFilename.c_str(), stRead);
-      }
-      else
-      {
-        if (_fThrowOnEOF)
-          THROWBADJSONSTREAM("[%s]: %s", m_szFilename.c_str(), _pcEOFMessage);
-        return false;
-      }
+      if (_fThrowOnEOF)
+        THROWBADJSONSTREAM("[%s]: %s", m_szFilename.c_str(), _pcEOFMessage);
+      return false;
     }
+    m_tcLookahead = cpxRead;
     if (_tyCharTraits::FIsIllegalChar(m_tcLookahead))
       THROWBADJSONSTREAM("Found illegal char [%TC] in file [%s]", m_tcLookahead ? m_tcLookahead : '?', m_szFilename.c_str());
-    m_pos += stRead;
     _rtch = m_tcLookahead;
     return true;
   }
@@ -989,12 +998,271 @@ public:
       m_fHasLookahead = true;
   }
 protected:
+  // Read the next persisted character from the buffer, refilling as necessary. Returns false on EOF.
+  bool _FReadPersistChar(_tyPersistAsChar &_rcpx)
+  {
+    if (((m_stBufferEnd - m_stBufferCur) < sizeof(_tyPersistAsChar)) && !_FFillBuffer())
+      return false;
+    memcpy(&_rcpx, m_rgbyBuffer.get() + m_stBufferCur, sizeof _rcpx);
+    m_stBufferCur += sizeof _rcpx;
+    m_pos += sizeof _rcpx;
+    return true;
+  }
+  // Refill the buffer - preserving any partial character at the end. Returns false on EOF.
+  // A read may return less than a full character from a pipe or socket so we keep reading until we have at least one character.
+  bool _FFillBuffer()
+  {
+    Assert(FOpened());
+    if (!m_rgbyBuffer)
+      m_rgbyBuffer = std::make_unique<uint8_t[]>(m_stBlockSize);
+    size_t stLeftover = m_stBufferEnd - m_stBufferCur;
+    if (!!stLeftover)
+      memmove(m_rgbyBuffer.get(), m_rgbyBuffer.get() + m_stBufferCur, stLeftover);
+    m_stBufferCur = 0;
+    m_stBufferEnd = stLeftover;
+    while (m_stBufferEnd < sizeof(_tyPersistAsChar))
+    {
+      uint64_t u64Read;
+      int iReadResult = FileRead( m_foFile.HFileGet(), m_rgbyBuffer.get() + m_stBufferEnd, m_stBlockSize - m_stBufferEnd, &u64Read );
+      if (-1 == iReadResult)
+        THROWBADJSONSTREAMERRNO(GetLastErrNo(), "FileRead() failed for file [%s]", m_szFilename.c_str());
+      if (!u64Read)
+      {
+        if (!!m_stBufferEnd)
+          THROWBADJSONSTREAM("FileRead() for file [%s] had [%zu] leftover bytes.", m_szFilename.c_str(), m_stBufferEnd);
+        return false;
+      }
+      m_stBufferEnd += (size_t)u64Read;
+    }
+    return true;
+  }
   std::string m_szFilename;
-  _tyFilePos m_pos{0};      // We use this if !m_fUseSeek.
+  _tyFilePos m_pos{0};      // The logical position of the stream - i.e. the number of bytes we have consumed from the buffer.
   FileObj m_foFile;
+  std::unique_ptr<uint8_t[]> m_rgbyBuffer; // Allocated upon first read.
+  size_t m_stBlockSize{s_kstDefaultBlockSize};
+  size_t m_stBufferCur{0};  // Current read position within m_rgbyBuffer.
+  size_t m_stBufferEnd{0};  // End of valid data within m_rgbyBuffer.
   _tyChar m_tcLookahead{0}; // Everytime we read a character we put it in the m_tcLookahead and clear that we have a lookahead.
   bool m_fHasLookahead{false};
-  bool m_fUseSeek{true};        // For STDIN we cannot use seek so we just maintain our "current" position.
+  bool m_fUseSeek{true};        // For STDIN we cannot use seek - we only use it to check our position in debug.
+};
+
+// JsonStructuralIndex:
+// An index (tape) of the positions of the structural characters of in-memory JSON - '{', '}', '[', ']', ':', ',' and the '"' at either end of each string.
+// Each opening bracket and opening double quote is linked to its matching close and vice versa.
+// The index is built by a pre-pass over the memory which is split into chunks and scanned in parallel.
+// With it a JsonReadCursor can jump over whole objects and arrays, and over runs of elements, without rescanning them.
+// Note that content skipped via the index is only checked for matching brackets and terminated strings - it isn't otherwise validated.
+template <class t_tyCharTraits>
+class JsonStructuralIndex
+{
+  typedef JsonStructuralIndex _tyThis;
+public:
+  typedef t_tyCharTraits _tyCharTraits;
+  typedef typename _tyCharTraits::_tyChar _tyChar;
+  static const size_t s_knMinCharsPerChunk = 1 << 20; // We don't use more threads than will give each at least this much to scan.
+
+  struct _tyEntry
+  {
+    size_t m_nPos;  // character offset in the JSON.
+    size_t m_nLink; // index of the matching entry for brackets and double quotes, zero for ':' and ','.
+  };
+
+  JsonStructuralIndex() = default;
+  JsonStructuralIndex(const _tyChar *_pcBegin, const _tyChar *_pcEnd, size_t _nThreads = 0)
+  {
+    Build(_pcBegin, _pcEnd, _nThreads);
+  }
+
+  size_t NEntries() const
+  {
+    return m_rgEntries.size();
+  }
+  size_t NPos(size_t _nEntry) const
+  {
+    Assert(_nEntry < m_rgEntries.size());
+    return m_rgEntries[_nEntry].m_nPos;
+  }
+  size_t NLink(size_t _nEntry) const
+  {
+    Assert(_nEntry < m_rgEntries.size());
+    return m_rgEntries[_nEntry].m_nLink;
+  }
+  // Return the first entry at or after character offset _nPos, or NEntries() if there is none.
+  // Access is mostly forward through the JSON so we first look just after _rnHint, the result of the last lookup, and update it.
+  size_t NFindEntry(size_t _nPos, size_t &_rnHint) const
+  {
+    static const size_t s_knLinearProbe = 8;
+    size_t nEntry = (std::min)(_rnHint, m_rgEntries.size());
+    if (!nEntry || (m_rgEntries[nEntry - 1].m_nPos < _nPos))
+    {
+      size_t nEntryEndProbe = (std::min)(nEntry + s_knLinearProbe, m_rgEntries.size());
+      for (; (nEntry != nEntryEndProbe) && (m_rgEntries[nEntry].m_nPos < _nPos); ++nEntry)
+        ;
+      if ((nEntry != nEntryEndProbe) || (nEntry == m_rgEntries.size()))
+        return _rnHint = nEntry;
+    }
+    else
+      nEntry = 0; // We have to look behind the hint.
+    typename std::vector<_tyEntry>::const_iterator citFound = std::lower_bound(m_rgEntries.begin() + nEntry, m_rgEntries.end(), _nPos,
+      [](_tyEntry const &_rentry, size_t _nPosFind) { return _rentry.m_nPos < _nPosFind; });
+    return _rnHint = (citFound - m_rgEntries.begin());
+  }
+
+  // Build the index for [_pcBegin,_pcEnd) using up to _nThreads threads - zero means use as many as there are hardware threads.
+  // Throws if the brackets don't match or a string isn't terminated.
+  void Build(const _tyChar *_pcBegin, const _tyChar *_pcEnd, size_t _nThreads = 0)
+  {
+    m_rgEntries.clear();
+    const size_t knChars = _pcEnd - _pcBegin;
+    if (!_nThreads)
+      _nThreads = (std::max)(std::thread::hardware_concurrency(), 1u);
+    const size_t knChunks = (std::max)((size_t)1, (std::min)(_nThreads, knChars / s_knMinCharsPerChunk));
+    const size_t knCharsPerChunk = (knChars + knChunks - 1) / knChunks;
+    std::vector<_Chunk> rgChunks(knChunks);
+    for (size_t nChunk = 0; nChunk < knChunks; ++nChunk)
+    {
+      rgChunks[nChunk].m_pcBegin = _pcBegin + (std::min)(knChars, nChunk * knCharsPerChunk);
+      rgChunks[nChunk].m_pcEnd = _pcBegin + (std::min)(knChars, (nChunk + 1) * knCharsPerChunk);
+    }
+    // 1) Whether each chunk starts with an escaped character and how many unescaped double quotes it contains.
+    //    A backslash can only legally appear within a string so the run of them preceding the chunk tells us about escaping.
+    _RunChunks(knChunks, [&rgChunks, _pcBegin](size_t _nChunk)
+    {
+      _Chunk &rchunk = rgChunks[_nChunk];
+      const _tyChar *pcBackslash = rchunk.m_pcBegin;
+      for (; (_pcBegin != pcBackslash) && (_tyCharTraits::s_tcBackSlash == pcBackslash[-1]); --pcBackslash)
+        ;
+      rchunk.m_fEscapedStart = !!((rchunk.m_pcBegin - pcBackslash) % 2);
+      for (const _tyChar *pcCur = rchunk.m_pcBegin + rchunk.m_fEscapedStart; pcCur < rchunk.m_pcEnd; )
+      {
+        pcCur = n_JsonScan::PcScan(n_JsonScan::eskStringSpecial, pcCur, rchunk.m_pcEnd);
+        if (rchunk.m_pcEnd == pcCur)
+          break;
+        if (_tyCharTraits::s_tcDoubleQuote == *pcCur)
+          ++rchunk.m_nQuotes;
+        pcCur += (_tyCharTraits::s_tcBackSlash == *pcCur) ? 2 : 1; // skip the escaped char - may step past m_pcEnd.
+      }
+    });
+    // 2) Now we know whether each chunk starts within a string.
+    for (size_t nChunk = 1; nChunk < knChunks; ++nChunk)
+      rgChunks[nChunk].m_fInString = rgChunks[nChunk - 1].m_fInString != !!(rgChunks[nChunk - 1].m_nQuotes % 2);
+    // 3) Record the structural characters of each chunk.
+    _RunChunks(knChunks, [&rgChunks, _pcBegin](size_t _nChunk)
+    {
+      _Chunk &rchunk = rgChunks[_nChunk];
+      bool fInString = rchunk.m_fInString;
+      for (const _tyChar *pcCur = rchunk.m_pcBegin + rchunk.m_fEscapedStart; pcCur < rchunk.m_pcEnd; )
+      {
+        pcCur = n_JsonScan::PcScan(fInString ? n_JsonScan::eskStringSpecial : n_JsonScan::eskStructural, pcCur, rchunk.m_pcEnd);
+        if (rchunk.m_pcEnd == pcCur)
+          break;
+        if (_tyCharTraits::s_tcBackSlash == *pcCur)
+        {
+          pcCur += 2;
+          continue;
+        }
+        if (_tyCharTraits::s_tcDoubleQuote == *pcCur)
+          fInString = !fInString;
+        else if (fInString)
+        {
+          ++pcCur; // an illegal null - the cursor will complain about it if it reads it.
+          continue;
+        }
+        rchunk.m_rgPos.push_back(pcCur++ - _pcBegin);
+      }
+    });
+    // 4) Concatenate the chunks and link the matching entries.
+    size_t nEntries = 0;
+    for (_Chunk const &rchunk : rgChunks)
+      nEntries += rchunk.m_rgPos.size();
+    m_rgEntries.reserve(nEntries);
+    std::vector<size_t> rgnOpen; // stack of open brackets.
+    bool fInString = false;
+    for (_Chunk &rchunk : rgChunks)
+    {
+      for (size_t nPos : rchunk.m_rgPos)
+      {
+        size_t nEntry = m_rgEntries.size();
+        m_rgEntries.push_back({nPos, 0});
+        _tyChar tc = _pcBegin[nPos];
+        if (_tyCharTraits::s_tcDoubleQuote == tc)
+        {
+          if (fInString)
+            m_rgEntries[nEntry].m_nLink = nEntry - 1, m_rgEntries[nEntry - 1].m_nLink = nEntry;
+          fInString = !fInString;
+        }
+        else if ((_tyCharTraits::s_tcLeftCurlyBr == tc) || (_tyCharTraits::s_tcLeftSquareBr == tc))
+          rgnOpen.push_back(nEntry);
+        else if ((_tyCharTraits::s_tcRightCurlyBr == tc) || (_tyCharTraits::s_tcRightSquareBr == tc))
+        {
+          if (rgnOpen.empty())
+            THROWBADJSONSTREAM("Unmatched [%TC] at offset [%zu].", tc, nPos);
+          size_t nOpen = rgnOpen.back();
+          rgnOpen.pop_back();
+          if ((_tyCharTraits::s_tcRightCurlyBr == tc) != (_tyCharTraits::s_tcLeftCurlyBr == _pcBegin[m_rgEntries[nOpen].m_nPos]))
+            THROWBADJSONSTREAM("Found [%TC] at offset [%zu] when looking for the close of [%TC] at offset [%zu].", tc, nPos, _pcBegin[m_rgEntries[nOpen].m_nPos], m_rgEntries[nOpen].m_nPos);
+          m_rgEntries[nEntry].m_nLink = nOpen;
+          m_rgEntries[nOpen].m_nLink = nEntry;
+        }
+      }
+      std::vector<size_t>().swap(rchunk.m_rgPos);
+    }
+    if (fInString)
+      THROWBADJSONSTREAM("EOF found looking for end of string.");
+    if (!rgnOpen.empty())
+      THROWBADJSONSTREAM("EOF found looking for the close of [%TC] at offset [%zu].", _pcBegin[m_rgEntries[rgnOpen.back()].m_nPos], m_rgEntries[rgnOpen.back()].m_nPos);
+  }
+
+protected:
+  struct _Chunk
+  {
+    const _tyChar *m_pcBegin{nullptr};
+    const _tyChar *m_pcEnd{nullptr};
+    size_t m_nQuotes{0};
+    bool m_fEscapedStart{false};
+    bool m_fInString{false};
+    std::vector<size_t> m_rgPos;
+  };
+  // Call _rrf( nChunk ) for each chunk, each on its own thread except the first which runs on this thread.
+  template <class t_tyFunctor>
+  static void _RunChunks(size_t _nChunks, t_tyFunctor &&_rrf)
+  {
+    if (1 == _nChunks)
+      return _rrf(0);
+    std::vector<std::exception_ptr> rgexp(_nChunks);
+    { // B
+      std::vector<ScopedThread> rgthr;
+      rgthr.reserve(_nChunks - 1);
+      for (size_t nChunk = 1; nChunk < _nChunks; ++nChunk)
+        rgthr.emplace_back([&_rrf, &rgexp, nChunk]()
+        {
+          try
+          {
+            _rrf(nChunk);
+          }
+          catch (...)
+          {
+            rgexp[nChunk] = std::current_exception();
+          }
+        });
+      try
+      {
+        _rrf(0);
+      }
+      catch (...)
+      {
+        rgexp[0] = std::current_exception();
+      }
+    } // EB - join the threads.
+    for (std::exception_ptr &rexp : rgexp)
+    {
+      if (!!rexp)
+        std::rethrow_exception(rexp);
+    }
+  }
+  std::vector<_tyEntry> m_rgEntries;
 };
 
 // JsonFixedMemInputStream: Stream a fixed piece o' mem'ry at the JSON parser.
@@ -1009,6 +1277,7 @@ public:
   typedef t_tyPersistAsChar _tyPersistAsChar;
   typedef size_t _tyFilePos;
   typedef JsonReadCursor<_tyThis> _tyJsonReadCursor;
+  typedef JsonStructuralIndex<_tyCharTraits> _tyStructuralIndex;
 
   JsonFixedMemInputStream(const _tyPersistAsChar *_pcpxBegin, _tyFilePos _stLen)
   {
@@ -1032,6 +1301,15 @@ public:
     Assert(FOpened());
     return (m_pcpxEnd - m_pcpxBegin) * sizeof(_tyPersistAsChar);
   }
+  // The memory we are streaming.
+  const _tyPersistAsChar *PcpxBegin() const
+  {
+    return m_pcpxBegin;
+  }
+  const _tyPersistAsChar *PcpxEnd() const
+  {
+    return m_pcpxEnd;
+  }
   void Open(const _tyPersistAsChar *_pcpxBegin, _tyFilePos _stLen)
   {
     Close();
@@ -1045,6 +1323,7 @@ public:
     m_pcpxEnd = (_tyPersistAsChar *)vkpvNullMapping;
     m_fHasLookahead = false;
     m_tcLookahead = 0;
+    ClearStructuralIndex();
   }
   // Attach to this FOpened() JsonFileInputStream.
   void AttachReadCursor(_tyJsonReadCursor &_rjrc)
@@ -1059,6 +1338,8 @@ public:
     if (m_fHasLookahead && !_tyCharTraits::FIsWhitespace(m_tcLookahead))
       return;
     m_fHasLookahead = false;
+    if constexpr (std::is_same_v<_tyChar, _tyPersistAsChar>)
+      m_pcpxCur = n_JsonScan::PcScan(n_JsonScan::eskNonWhitespace, m_pcpxCur, m_pcpxEnd); // Skip whitespace runs a block at a time.
     for (;;)
     {
       if (FEOF())
@@ -1078,6 +1359,14 @@ public:
     Assert(FOpened());
     return ((m_pcpxCur - m_pcpxBegin) - (size_t)m_fHasLookahead) * sizeof(_tyPersistAsChar);
   }
+  // Move to byte position _pos - e.g. a value's position recorded earlier, to attach a new read cursor there.
+  void Seek(_tyFilePos _pos)
+  {
+    Assert(FOpened());
+    Assert(!(_pos % sizeof(_tyPersistAsChar)) && (_pos <= StLenBytes()));
+    m_pcpxCur = m_pcpxBegin + (_pos / sizeof(_tyPersistAsChar));
+    m_fHasLookahead = false;
+  }
   // Read a single character from the file - always throw on EOF.
   _tyChar ReadChar(const char *_pcEOFMessage, const char *_pcFilename = 0)
   {
@@ -1123,6 +1412,101 @@ public:
     if (!_tyCharTraits::FIsWhitespace(m_tcLookahead))
       m_fHasLookahead = true;
   }
+  // Zero-copy string support - we are within a string, e.g. the opening '"' has just been read.
+  // Return in _rsv the run of plain characters up to the next '"' or '\\' and consume it - this view is valid for the lifetime of the memory we are reading.
+  // If the run ended with the closing '"' we consume it and return true. Otherwise we return false and the caller must read the '\\' and the escape following it.
+  bool FReadStringRun(std::basic_string_view<_tyChar> &_rsv, const char *_pcFilename = 0)
+    requires(std::is_same_v<_tyChar, _tyPersistAsChar>)
+  {
+    Assert(FOpened());
+    Assert(!m_fHasLookahead); // We should have just read the double quote or an escape.
+    const _tyPersistAsChar *pcpxSpecial = n_JsonScan::PcScan(n_JsonScan::eskStringSpecial, m_pcpxCur, m_pcpxEnd);
+    if (m_pcpxEnd == pcpxSpecial)
+      THROWBADJSONSTREAM("[%s]: %s", !_pcFilename ? "(no file)" : _pcFilename, "EOF found looking for end of string.");
+    _rsv = std::basic_string_view<_tyChar>(m_pcpxCur, pcpxSpecial - m_pcpxCur);
+    m_pcpxCur = pcpxSpecial;
+    m_tcLookahead = *m_pcpxCur;
+    if (_tyCharTraits::s_tcDoubleQuote == m_tcLookahead)
+    {
+      ++m_pcpxCur;
+      return true;
+    }
+    if (_tyCharTraits::FIsIllegalChar(m_tcLookahead))
+      THROWBADJSONSTREAM("Found illegal char [%TC] in file [%s]", m_tcLookahead ? m_tcLookahead : '?', !_pcFilename ? "(no file)" : _pcFilename);
+    Assert(_tyCharTraits::s_tcBackSlash == m_tcLookahead);
+    return false;
+  }
+  // Structural index support - when we have an index the read cursor uses it to jump over aggregates and elements. Copies of the stream share the index.
+  void BuildStructuralIndex(size_t _nThreads = 0)
+    requires(std::is_same_v<_tyChar, _tyPersistAsChar>)
+  {
+    Assert(FOpened());
+    m_spjsiIndex = std::make_shared<const _tyStructuralIndex>(m_pcpxBegin, m_pcpxEnd, _nThreads);
+    m_nIndexHint = 0;
+  }
+  bool FHasStructuralIndex() const
+  {
+    return !!m_spjsiIndex;
+  }
+  void ClearStructuralIndex()
+  {
+    m_spjsiIndex.reset();
+    m_nIndexHint = 0;
+  }
+  // We have read the '{' or '[' at _posOpen - move to just past its matching close.
+  void SkipToMatchingBracket(_tyFilePos _posOpen, const char *_pcFilename = 0)
+  {
+    Assert(FOpened() && FHasStructuralIndex());
+    const size_t knPosOpen = _posOpen / sizeof(_tyPersistAsChar);
+    size_t nEntry = m_spjsiIndex->NFindEntry(knPosOpen, m_nIndexHint);
+    if ((m_spjsiIndex->NEntries() == nEntry) || (m_spjsiIndex->NPos(nEntry) != knPosOpen))
+      THROWBADJSONSTREAM("[%s]: No structural index entry for bracket at offset [%zu].", !_pcFilename ? "(no file)" : _pcFilename, knPosOpen);
+    size_t nEntryClose = m_spjsiIndex->NLink(nEntry);
+    m_pcpxCur = m_pcpxBegin + m_spjsiIndex->NPos(nEntryClose) + 1;
+    m_tcLookahead = m_pcpxCur[-1];
+    m_fHasLookahead = false;
+    m_nIndexHint = nEntryClose + 1;
+  }
+  // We are just past a value within an object (_fObject) or array - skip the _nElements elements that follow it.
+  // This leaves us before the ',' preceding the next element or before the close of the aggregate. Returns false if we reached the close first.
+  bool FSkipElements(size_t _nElements, bool _fObject, const char *_pcFilename = 0)
+  {
+    Assert(FOpened() && FHasStructuralIndex());
+    const _tyStructuralIndex &rjsi = *m_spjsiIndex;
+    const _tyChar tcClose = _fObject ? _tyCharTraits::s_tcRightCurlyBr : _tyCharTraits::s_tcRightSquareBr;
+    size_t nEntry = rjsi.NFindEntry((m_pcpxCur - m_pcpxBegin) - (size_t)m_fHasLookahead, m_nIndexHint);
+    for (;; --_nElements)
+    {
+      if (rjsi.NEntries() == nEntry)
+        THROWBADJSONSTREAM("[%s]: EOF looking for end object/array }/] or comma.", !_pcFilename ? "(no file)" : _pcFilename);
+      _tyChar tcCur = m_pcpxBegin[rjsi.NPos(nEntry)];
+      if (_tyCharTraits::s_tcComma != tcCur)
+      {
+        if (tcClose != tcCur)
+          THROWBADJSONSTREAM("Found [%TC] when looking for comma or object/array end.", tcCur);
+        break;
+      }
+      if (!_nElements)
+        break;
+      if (_fObject)
+      {
+        nEntry += 3; // The key's double quotes and then the colon.
+        if ((rjsi.NEntries() <= nEntry) || (_tyCharTraits::s_tcColon != m_pcpxBegin[rjsi.NPos(nEntry)]))
+          THROWBADJSONSTREAM("[%s]: Expected key and colon after comma at offset [%zu].", !_pcFilename ? "(no file)" : _pcFilename, rjsi.NPos(nEntry - 3));
+      }
+      // If the value is an aggregate or string then jump past its close, otherwise it has no entries.
+      if (++nEntry < rjsi.NEntries())
+      {
+        tcCur = m_pcpxBegin[rjsi.NPos(nEntry)];
+        if ((_tyCharTraits::s_tcLeftCurlyBr == tcCur) || (_tyCharTraits::s_tcLeftSquareBr == tcCur) || (_tyCharTraits::s_tcDoubleQuote == tcCur))
+          nEntry = rjsi.NLink(nEntry) + 1;
+      }
+    }
+    m_pcpxCur = m_pcpxBegin + rjsi.NPos(nEntry);
+    m_fHasLookahead = false;
+    m_nIndexHint = nEntry;
+    return !_nElements;
+  }
   std::strong_ordering ICompare(_tyThis const &_rOther) const
   {
     Assert(FOpened() && _rOther.FOpened());
@@ -1139,6 +1523,8 @@ protected:
   const _tyPersistAsChar *m_pcpxEnd{(_tyPersistAsChar *)vkpvNullMapping};
   _tyChar m_tcLookahead{0}; // Everytime we read a character we put it in the m_tcLookahead and clear that we have a lookahead.
   bool m_fHasLookahead{false};
+  std::shared_ptr<const _tyStructuralIndex> m_spjsiIndex; // Optional structural index for the memory.
+  size_t m_nIndexHint{0};                                 // The last entry we looked up in m_spjsiIndex.
 };
 
 // JsonMemMappedInputStream: A class using open(), read(), etc.
@@ -1191,6 +1577,8 @@ public:
   }
   using _tyBase::FEOF;
   using _tyBase::StLenBytes;
+  using _tyBase::PcpxBegin;
+  using _tyBase::PcpxEnd;
   // Throws on open failure. This object owns the lifetime of the file descriptor.
   void Open(const char *_szFilename)
   {
@@ -1220,6 +1608,7 @@ public:
   }
   int Close()
   {
+    _tyBase::ClearStructuralIndex();
     return m_fmoMapping.Close();
   }
   // Attach to this FOpened() JsonFileInputStream.
@@ -1246,6 +1635,26 @@ public:
     return _tyBase::FReadChar(_rtch, _fThrowOnEOF, _pcEOFMessage, m_szFilename.c_str());
   }
   using _tyBase::PushBackLastChar;
+  bool FReadStringRun(std::basic_string_view<_tyChar> &_rsv)
+    requires(std::is_same_v<_tyChar, _tyPersistAsChar>)
+  {
+    return _tyBase::FReadStringRun(_rsv, m_szFilename.c_str());
+  }
+  void BuildStructuralIndex(size_t _nThreads = 0)
+    requires(std::is_same_v<_tyChar, _tyPersistAsChar>)
+  {
+    _tyBase::BuildStructuralIndex(_nThreads);
+  }
+  using _tyBase::FHasStructuralIndex;
+  using _tyBase::ClearStructuralIndex;
+  void SkipToMatchingBracket(_tyFilePos _posOpen)
+  {
+    _tyBase::SkipToMatchingBracket(_posOpen, m_szFilename.c_str());
+  }
+  bool FSkipElements(size_t _nElements, bool _fObject)
+  {
+    return _tyBase::FSkipElements(_nElements, _fObject, m_szFilename.c_str());
+  }
   std::strong_ordering ICompare(_tyThis const &_rOther) const
   {
     return _tyBase::ICompare(_rOther);
@@ -1262,6 +1671,8 @@ protected:
 
 // Utility method used by the various output streams.
 // If <_fEscape> then we escape all special characters when writing.
+// We find runs of characters needing no escaping with the n_JsonScan kernels and write each run with a single WriteRawChars() -
+//  for typical strings that is the whole string.
 template < class t_tyJsonOutputStream >
 void JsonOutputStream_WriteString( t_tyJsonOutputStream & _rjos, bool _fEscape, 
   typename t_tyJsonOutputStream::_tyLPCSTR _psz, ssize_t _sstLen = -1, const typename t_tyJsonOutputStream::_tyJsonFormatSpec *_pjfs = 0 )
@@ -1274,107 +1685,544 @@ void JsonOutputStream_WriteString( t_tyJsonOutputStream & _rjos, bool _fEscape,
   if (!_sstLen)
     return;
   size_t stLen = (_sstLen < 0) ? _tyCharTraits::StrLen(_psz) : (size_t)_sstLen;
-  if (!_fEscape) // We shouldn't write such characters to strings so we had better know that we don't have any.
-    Assert(stLen <= _tyCharTraits::StrCSpn(_psz, _tyCharTraits::s_tcFirstUnprintableChar, _tyCharTraits::s_tcLastUnprintableChar + 1,
-                                            _tyCharTraits::s_szEscapeStringChars));
-  _tyLPCSTR pszPrintableWhitespaceAtEnd = _psz + stLen;
-  if (_fEscape && !!_pjfs && !_pjfs->m_fEscapePrintableWhitespace && _pjfs->m_fEscapePrintableWhitespaceAtEndOfLine)
-    pszPrintableWhitespaceAtEnd -= _tyCharTraits::StrRSpn(_psz, pszPrintableWhitespaceAtEnd, _tyCharTraits::s_szPrintableWhitespace);
-
-  // When we are escaping the string we write piecewise.
+  _tyLPCSTR pszEnd = _psz + stLen;
+  if (!_fEscape)
+  { // We shouldn't write such characters to strings so we had better know that we don't have any.
+    Assert(pszEnd == n_JsonScan::PcScan(n_JsonScan::eskEscape, _psz, pszEnd));
+    _rjos.WriteRawChars(_psz, stLen);
+    return;
+  }
+  const bool kfEscapePrintableWhitespace = !_pjfs || _pjfs->m_fEscapePrintableWhitespace;
+  _tyLPCSTR pszPrintableWhitespaceAtEnd = pszEnd;
+  if (!kfEscapePrintableWhitespace && _pjfs->m_fEscapePrintableWhitespaceAtEndOfLine)
+    pszPrintableWhitespaceAtEnd -= _tyCharTraits::StrRSpn(_psz, pszEnd, _tyCharTraits::s_szPrintableWhitespace);
+
   _tyLPCSTR pszWrite = _psz;
-  while (!!stLen)
+  for (;;)
+  {
+    _tyLPCSTR pszEscape = n_JsonScan::PcScan(n_JsonScan::eskEscape, pszWrite, pszEnd);
+    if (!kfEscapePrintableWhitespace)
+    {
+      // Printable whitespace before any trailing whitespace is written as is.
+      while ((pszEscape < pszPrintableWhitespaceAtEnd) &&
+             ((_tyCharTraits::s_tcTab == *pszEscape) || (_tyCharTraits::s_tcNewline == *pszEscape) || (_tyCharTraits::s_tcCarriageReturn == *pszEscape)))
+        pszEscape = n_JsonScan::PcScan(n_JsonScan::eskEscape, pszEscape + 1, pszEnd);
+    }
+    if (pszEscape != pszWrite)
+      _rjos.WriteRawChars(pszWrite, pszEscape - pszWrite);
+    if (pszEnd == pszEscape)
+      return; // the overwhelming case is we return here the first time through.
+    _tyChar rgtcEscape[6];
+    rgtcEscape[0] = _tyCharTraits::s_tcBackSlash;
+    size_t stEscape = 2;
+    switch (*pszEscape)
+    {
+    case _tyCharTraits::s_tcBackSpace:
+      rgtcEscape[1] = _tyCharTraits::s_tcb;
+      break;
+    case _tyCharTraits::s_tcFormFeed:
+      rgtcEscape[1] = _tyCharTraits::s_tcf;
+      break;
+    case _tyCharTraits::s_tcNewline:
+      rgtcEscape[1] = _tyCharTraits::s_tcn;
+      break;
+    case _tyCharTraits::s_tcCarriageReturn:
+      rgtcEscape[1] = _tyCharTraits::s_tcr;
+      break;
+    case _tyCharTraits::s_tcTab:
+      rgtcEscape[1] = _tyCharTraits::s_tct;
+      break;
+    case _tyCharTraits::s_tcBackSlash:
+    case _tyCharTraits::s_tcDoubleQuote:
+      rgtcEscape[1] = *pszEscape;
+      break;
+    default:
+      // Unprintable character between 0 and 31. We'll use the \uXXXX method for this character.
+      rgtcEscape[1] = _tyCharTraits::s_tcu;
+      rgtcEscape[2] = _tyCharTraits::s_tc0;
+      rgtcEscape[3] = _tyCharTraits::s_tc0;
+      rgtcEscape[4] = _tyChar('0' + (*pszEscape / 16));
+      rgtcEscape[5] = _tyChar((*pszEscape % 16) < 10 ? ('0' + (*pszEscape % 16)) : ('A' + (*pszEscape % 16) - 10));
+      stEscape = 6;
+      break;
+    }
+    _rjos.WriteRawChars(rgtcEscape, stEscape);
+    pszWrite = pszEscape + 1;
+  }
+}
+
+// Utility methods for parsing numbers - used by JsonReadCursor and JsoValue.
+// JSON numbers are entirely ASCII so narrowing to char is lossless. Returns the length - _rgcNum is null terminated.
+template < class t_tyCharTraits >
+size_t JsonNumber_StNarrow( const typename t_tyCharTraits::_tyChar * _pcBegin, const typename t_tyCharTraits::_tyChar * _pcEnd, 
+  char (&_rgcNum)[ t_tyCharTraits::s_knMaxNumberLength + 1 ] )
+{
+  size_t stLen = (std::min)( size_t( _pcEnd - _pcBegin ), size_t( t_tyCharTraits::s_knMaxNumberLength ) );
+  for ( size_t st = 0; st < stLen; ++st )
+    _rgcNum[st] = char( _pcBegin[st] );
+  _rgcNum[stLen] = 0;
+  return stLen;
+}
+// Return the power of ten of the leading significant digit plus one - i.e. a value <= 0 indicates a magnitude less than one.
+inline int JsonNumber_NDecimalMagnitude( const char * _pcBegin, const char * _pcEnd )
+{
+  const char * pcCur = _pcBegin;
+  if ( '-' == *pcCur )
+    ++pcCur;
+  int nMagnitude = 0;
+  bool fSignificant = false;
+  for ( ; ( _pcEnd != pcCur ) && isdigit( *pcCur ); ++pcCur )
+  {
+    fSignificant = fSignificant || ( '0' != *pcCur );
+    nMagnitude += int( fSignificant );
+  }
+  if ( ( _pcEnd != pcCur ) && ( '.' == *pcCur ) )
   {
-    if (pszWrite < pszPrintableWhitespaceAtEnd)
+    for ( ++pcCur; ( _pcEnd != pcCur ) && isdigit( *pcCur ); ++pcCur )
     {
-      ssize_t sstLenWrite = stLen;
-      if (_fEscape)
+      if ( !fSignificant && ( '0' == *pcCur ) )
+        --nMagnitude;
+      else
+        fSignificant = true;
+    }
+  }
+  if ( !fSignificant )
+    return INT_MIN; // zero.
+  if ( ( _pcEnd != pcCur ) && ( ( 'e' == *pcCur ) || ( 'E' == *pcCur ) ) )
+  {
+    ++pcCur;
+    bool fNegExp = ( '-' == *pcCur );
+    if ( fNegExp || ( '+' == *pcCur ) )
+      ++pcCur;
+    int nExp = 0;
+    for ( ; ( _pcEnd != pcCur ) && isdigit( *pcCur ); ++pcCur )
+      nExp = (std::min)( nExp * 10 + ( *pcCur - '0' ), 1000000 ); // saturate - plenty for any floating point type.
+    nMagnitude += fNegExp ? -nExp : nExp;
+  }
+  return nMagnitude;
+}
+template < class t_tyCharTraits, class t_tyNum >
+[[noreturn]] void JsonNumber_ThrowOutOfRange( const typename t_tyCharTraits::_tyChar * _pcBegin, const typename t_tyCharTraits::_tyChar * _pcEnd )
+{
+  typedef t_tyCharTraits _tyCharTraits;
+  char rgcNum[ _tyCharTraits::s_knMaxNumberLength + 1 ];
+  (void)JsonNumber_StNarrow< _tyCharTraits >( _pcBegin, _pcEnd, rgcNum );
+  if constexpr ( std::is_integral_v< t_tyNum > )
+    THROWBADJSONSEMANTICUSE( "Number [%s] is out of range for %s %zu-bit integer.", rgcNum, std::is_signed_v< t_tyNum > ? "signed" : "unsigned", sizeof( t_tyNum ) * CHAR_BIT );
+  else
+    THROWBADJSONSEMANTICUSE( "Number [%s] is out of range for %zu-bit floating point.", rgcNum, sizeof( t_tyNum ) * CHAR_BIT );
+#ifdef _MSC_VER // The throw above isn't declared noreturn.
+  __assume( 0 );
+#else
+  __builtin_unreachable();
+#endif
+}
+// Locale-free parse of the JSON number in [_pcBegin,_pcEnd) into _rNumber - works for any character type.
+// The number must already have been validated against the JSON number grammar - e.g. by JsonReadCursor::_ReadNumber().
+// Throws if the value cannot be represented by t_tyNum. A fractional value read into an integer is truncated toward zero.
+// Floating point underflow results in a signed zero as strtod() would produce.
+template < class t_tyCharTraits, class t_tyNum >
+void JsonParseNumber( const typename t_tyCharTraits::_tyChar * _pcBegin, const typename t_tyCharTraits::_tyChar * _pcEnd, t_tyNum & _rNumber )
+{
+  typedef t_tyCharTraits _tyCharTraits;
+  typedef typename _tyCharTraits::_tyChar _tyChar;
+  Assert( _pcEnd > _pcBegin );
+  if constexpr ( std::is_integral_v< t_tyNum > )
+  {
+    const _tyChar * pcCur = _pcBegin;
+    bool fNegative = ( _tyCharTraits::s_tcMinus == *pcCur );
+    if ( fNegative )
+      ++pcCur;
+    uint64_t u64Value = 0;
+    bool fOverflow = false; // We may yet have an exponent that brings the number back into range.
+    for ( ; ( _pcEnd != pcCur ) && ( *pcCur >= _tyCharTraits::s_tc0 ) && ( *pcCur <= _tyCharTraits::s_tc9 ); ++pcCur )
+    {
+      uint64_t u64Digit = uint64_t( *pcCur - _tyCharTraits::s_tc0 );
+      if ( fOverflow || ( u64Value > ( ( (std::numeric_limits< uint64_t >::max)() - u64Digit ) / 10 ) ) )
+        fOverflow = true;
+      else
+        u64Value = u64Value * 10 + u64Digit;
+    }
+    if ( _pcEnd != pcCur )
+    {
+      // Fraction and/or exponent present - evaluate as floating point, truncate and then range check against powers of two which are exact.
+      long double ldblValue;
+      JsonParseNumber< _tyCharTraits >( _pcBegin, _pcEnd, ldblValue );
+      ldblValue = std::trunc( ldblValue );
+      const long double kldblLimit = std::ldexp( 1.0L, std::numeric_limits< t_tyNum >::digits );
+      if ( !( ldblValue < kldblLimit ) || ( ldblValue < ( std::is_signed_v< t_tyNum > ? -kldblLimit : 0.0L ) ) )
+        JsonNumber_ThrowOutOfRange< _tyCharTraits, t_tyNum >( _pcBegin, _pcEnd );
+      _rNumber = t_tyNum( ldblValue );
+    }
+    else if ( fOverflow ) // The mantissa is the whole number.
+      JsonNumber_ThrowOutOfRange< _tyCharTraits, t_tyNum >( _pcBegin, _pcEnd );
+    else if ( fNegative )
+    {
+      if constexpr ( std::is_signed_v< t_tyNum > )
       {
-        if (!_pjfs || _pjfs->m_fEscapePrintableWhitespace) // escape everything.
-          sstLenWrite = _tyCharTraits::StrCSpn(pszWrite,
-                                                _tyCharTraits::s_tcFirstUnprintableChar, _tyCharTraits::s_tcLastUnprintableChar + 1,
-                                                _tyCharTraits::s_szEscapeStringChars);
-        else
+        if ( u64Value > uint64_t( (std::numeric_limits< t_tyNum >::max)() ) + 1 )
+          JsonNumber_ThrowOutOfRange< _tyCharTraits, t_tyNum >( _pcBegin, _pcEnd );
+        _rNumber = !u64Value ? t_tyNum( 0 ) : t_tyNum( -t_tyNum( u64Value - 1 ) - 1 ); // Avoid overflow on the minimum value.
+      }
+      else
+      {
+        if ( !!u64Value )
+          JsonNumber_ThrowOutOfRange< _tyCharTraits, t_tyNum >( _pcBegin, _pcEnd );
+        _rNumber = 0; // "-0"
+      }
+    }
+    else
+    {
+      if ( u64Value > uint64_t( (std::numeric_limits< t_tyNum >::max)() ) )
+        JsonNumber_ThrowOutOfRange< _tyCharTraits, t_tyNum >( _pcBegin, _pcEnd );
+      _rNumber = t_tyNum( u64Value );
+    }
+  }
+  else
+  {
+    static_assert( std::is_floating_point_v< t_tyNum > );
+    char rgcNum[ _tyCharTraits::s_knMaxNumberLength + 1 ];
+    size_t stLen = JsonNumber_StNarrow< _tyCharTraits >( _pcBegin, _pcEnd, rgcNum );
+    std::from_chars_result fcr = std::from_chars( rgcNum, rgcNum + stLen, _rNumber );
+    if ( std::errc::result_out_of_range == fcr.ec )
+    {
+      if ( JsonNumber_NDecimalMagnitude( rgcNum, rgcNum + stLen ) > 0 )
+        JsonNumber_ThrowOutOfRange< _tyCharTraits, t_tyNum >( _pcBegin, _pcEnd );
+      _rNumber = ( '-' == rgcNum[0] ) ? -t_tyNum( 0 ) : t_tyNum( 0 );
+    }
+    else
+    {
+      Assert( ( std::errc() == fcr.ec ) && ( rgcNum + stLen == fcr.ptr ) ); // Due to the specification of number we expect this to always succeed.
+      if ( std::errc() != fcr.ec )
+        THROWBADJSONSTREAM( "std::from_chars() failed to parse number [%s].", rgcNum );
+    }
+  }
+}
+
+// Locale-free formatting of _num into _pcBuf, returns the number of characters written - no null termination is written.
+// Integers are written two digits at a time. Floating point is written in the shortest form that round-trips via JsonParseNumber().
+template < class t_tyCharTraits, class t_tyNum >
+size_t JsonNumber_StFormat( t_tyNum _num, typename t_tyCharTraits::_tyChar * _pcBuf, size_t _stBuf )
+{
+  typedef t_tyCharTraits _tyCharTraits;
+  typedef typename _tyCharTraits::_tyChar _tyChar;
+  const size_t knNum = 64; // Plenty for the shortest representation of any arithmetic type.
+  char rgcNum[ knNum ];
+  const char * pcNumBegin;
+  const char * pcNumEnd;
+  if constexpr ( std::is_integral_v< t_tyNum > )
+  {
+    static constexpr char s_rgcDigitPairs[] =
+      "0001020304050607080910111213141516171819202122232425262728293031323334353637383940414243444546474849"
+      "5051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+    static_assert( sizeof( t_tyNum ) <= sizeof( uint64_t ) );
+    bool fNegative = std::is_signed_v< t_tyNum > && ( _num < 0 );
+    uint64_t u64Value = fNegative ? ( uint64_t( 0 ) - uint64_t( int64_t( _num ) ) ) : uint64_t( _num );
+    char * pcCur = rgcNum + knNum;
+    pcNumEnd = pcCur;
+    while ( u64Value >= 100 )
+    {
+      size_t stPair = size_t( u64Value % 100 ) * 2;
+      u64Value /= 100;
+      pcCur -= 2;
+      memcpy( pcCur, s_rgcDigitPairs + stPair, 2 );
+    }
+    if ( u64Value >= 10 )
+    {
+      pcCur -= 2;
+      memcpy( pcCur, s_rgcDigitPairs + size_t( u64Value ) * 2, 2 );
+    }
+    else
+      *--pcCur = char( '0' + u64Value );
+    if ( fNegative )
+      *--pcCur = '-';
+    pcNumBegin = pcCur;
+  }
+  else
+  {
+    static_assert( std::is_floating_point_v< t_tyNum > );
+    std::to_chars_result tcr = std::to_chars( rgcNum, rgcNum + knNum, _num );
+    Assert( std::errc() == tcr.ec );
+    if ( std::errc() != tcr.ec )
+      THROWBADJSONSTREAM( "std::to_chars() failed to format a floating point number." );
+    pcNumBegin = rgcNum;
+    pcNumEnd = tcr.ptr;
+  }
+  size_t stLen = pcNumEnd - pcNumBegin;
+  Assert( stLen <= _stBuf );
+  stLen = (std::min)( stLen, _stBuf );
+  for ( size_t st = 0; st < stLen; ++st )
+    _pcBuf[st] = _tyChar( pcNumBegin[st] );
+  return stLen;
+}
+
+// JsonFileOutputStream: A class using open(), read(), etc.
+// We coalesce writes into a buffer of m_stBufferSize bytes and write the buffer to the file when it fills, upon Flush() and upon Close().
+// A flush policy may be set via SetFlushPolicy() to cause flushing at a lower threshold or after each linefeed.
+template <class t_tyCharTraits, class t_tyPersistAsChar = typename t_tyCharTraits::_tyPersistAsChar>
+class JsonFileOutputStream : public JsonOutputStreamBase<t_tyCharTraits, size_t>
+{
+  typedef JsonFileOutputStream _tyThis;
+  typedef JsonOutputStreamBase<t_tyCharTraits, size_t> _tyBase;
+public:
+  typedef t_tyCharTraits _tyCharTraits;
+  typedef typename _tyCharTraits::_tyChar _tyChar;
+  typedef t_tyPersistAsChar _tyPersistAsChar;
+  typedef std::basic_string<_tyPersistAsChar> _tyStdStrPersist;
+  typedef typename _tyCharTraits::_tyLPCSTR _tyLPCSTR;
+  typedef size_t _tyFilePos;
+  typedef JsonReadCursor<_tyThis> _tyJsonReadCursor;
+  typedef JsonFormatSpec<_tyCharTraits> _tyJsonFormatSpec;
+  static const size_t s_kstDefaultBufferSize = 65536;
+
+  ~JsonFileOutputStream() noexcept(false)
+  {
+    if (FOpened())
+      (void)Close(!std::uncaught_exceptions()); // Only throw on error from close if we are not currently unwinding.
+  }
+  JsonFileOutputStream() = default;
+  JsonFileOutputStream( JsonFileOutputStream const & ) = delete;
+  JsonFileOutputStream & operator = ( JsonFileOutputStream const &) = delete;
+  JsonFileOutputStream( JsonFileOutputStream && _rr ) = default;
+  JsonFileOutputStream & operator = ( JsonFileOutputStream && _rr )
+  {
+    _tyThis acquire( std::move( _rr ) );
+    swap( acquire );
+    return *this;
+  }
+  void swap( JsonFileOutputStream & _r )
+  {
+    _r.m_szFilename.swap(m_szFilename);
+    _r.m_szExceptionString.swap(m_szExceptionString);
+    m_foFile.swap( _r.m_foFile );
+    m_rgbyBuffer.swap( _r.m_rgbyBuffer );
+    std::swap( m_stBufferSize, _r.m_stBufferSize );
+    std::swap( m_stBuffered, _r.m_stBuffered );
+    std::swap( m_stFlushAtBytes, _r.m_stFlushAtBytes );
+    std::swap( m_fFlushOnLinefeed, _r.m_fFlushOnLinefeed );
+    std::swap( m_stBytesWritten, _r.m_stBytesWritten );
+  }
+  // This is a manner of indicating that something happened during streaming.
+  // Since we use object destruction to finalize writes to a file and cannot throw out of a destructor.
+  void SetExceptionString(const char *_szWhat)
+  {
+    m_szExceptionString = _szWhat;
+  }
+  void GetExceptionString(std::string &_rstrExceptionString)
+  {
+    _rstrExceptionString = m_szExceptionString;
+  }
+  bool FOpened() const
+  {
+    return m_foFile.FIsOpen();
+  }
+  // Set the size of the write buffer. A size of zero writes through to the file on each write.
+  // Any currently buffered data is flushed first.
+  void SetBufferSize( size_t _stBufferSize )
+  {
+    if ( !!m_stBuffered )
+      Flush();
+    m_rgbyBuffer.reset();
+    m_stBufferSize = _stBufferSize;
+  }
+  size_t StGetBufferSize() const
+  {
+    return m_stBufferSize;
+  }
+  // The number of bytes written since open - including those still buffered.
+  size_t StGetBytesWritten() const
+  {
+    return m_stBytesWritten;
+  }
+  // _stFlushAtBytes: If non-zero then we flush as soon as at least this many bytes are buffered.
+  // _fFlushOnLinefeed: Flush after writing any linefeed - e.g. after each line of pretty-printed output.
+  void SetFlushPolicy( size_t _stFlushAtBytes, bool _fFlushOnLinefeed )
+  {
+    m_stFlushAtBytes = _stFlushAtBytes;
+    m_fFlushOnLinefeed = _fFlushOnLinefeed;
+  }
+  // Throws on open failure. This object owns the lifetime of the file descriptor.
+  void Open(const char *_szFilename, FileSharing _fs = FileSharing::NoSharing)
+  {
+    (void)Close(); // Make sure we flush anything remaining for any previously open file.
+    m_szExceptionString.clear();
+    m_foFile.SetHFile( CreateWriteOnlyFile( _szFilename, _fs) );
+    if (!FOpened())
+      THROWBADJSONSTREAMERRNO(GetLastErrNo(), "Unable to CreateWriteOnlyFile() file [%s]", _szFilename);
+    m_szFilename = _szFilename; // For error reporting and general debugging. Of course we don't need to store this.
+    m_stBytesWritten = 0;
+  }
+  // Attach to an FD whose lifetime we do not own. This can be used, for instance, to attach to stdout which is usually at FD 1 (unless reopen()ed).
+  void AttachFd(vtyFileHandle _hFile, bool _fOwnFdLifetime = false)
+  {
+    Assert(_hFile != vkhInvalidFileHandle);
+    (void)Close();
+    m_foFile.SetHFile( _hFile, _fOwnFdLifetime );
+    m_szFilename.clear();     // No filename indicates we are attached to "some hFile".
+    m_stBytesWritten = 0;
+  }
+  // We flush the buffer before closing. If !_fAllowThrows then we log any error and return -1.
+  int Close( bool _fAllowThrows = true ) noexcept(false)
+  {
+    if ( !FOpened() )
+    {
+      m_stBuffered = 0;
+      return 0;
+    }
+    int iFlush = 0;
+    try
+    {
+      Flush();
+    }
+    catch (std::exception const &rexc)
+    {
+      m_stBuffered = 0; // Don't try to write this again.
+      if (_fAllowThrows)
+      {
+        (void)m_foFile.Close();
+        throw;
+      }
+      LOGSYSLOG(eslmtError, "JsonFileOutputStream::Close(): Caught exception [%s].", rexc.what());
+      iFlush = -1;
+    }
+    int iClose = m_foFile.Close();
+    return !!iFlush ? iFlush : iClose;
+  }
+  // Write any buffered data to the file.
+  void Flush()
+  {
+    if (!m_stBuffered)
+      return;
+    Assert(FOpened());
+    size_t stWrite = m_stBuffered;
+    m_stBuffered = 0; // If we throw we will have lost this data - there's no reasonable way to recover it anyway.
+    _WriteFile(m_rgbyBuffer.get(), stWrite);
+  }
+  void WriteByteOrderMark()
+  {
+    Assert( FOpened() );
+    Assert( !m_stBuffered && ( 0 == NFileSeekAndThrow( m_foFile.HFileGet(), 0, vkSeekCur ) ) );
+    uint8_t rgBOM[] = {0xFF, 0xFE};
+    _WriteBytes( rgBOM, sizeof rgBOM );
+  }
+  // Write a single character from the file - always throw on EOF.
+  void WriteChar(_tyChar _tc)
+  {
+    Assert(FOpened());
+    if (sizeof(_tyChar) == sizeof(_tyPersistAsChar))
+      _WriteBytes( &_tc, sizeof _tc );
+    else
+    {
+      _tyStdStrPersist strPersist;
+      ConvertString(strPersist, &_tc, 1);
+      _WriteBytes( &strPersist[0], strPersist.length() * sizeof(_tyPersistAsChar) );
+    }
+    if (m_fFlushOnLinefeed && (_tyCharTraits::s_tcNewline == _tc))
+      Flush();
+  }
+  void WriteRawChars(_tyLPCSTR _psz, ssize_t _sstLen = -1)
+  {
+    Assert(FOpened());
+    if (_sstLen < 0)
+      _sstLen = _tyCharTraits::StrLen(_psz);
+    if (sizeof(_tyChar) != sizeof(_tyPersistAsChar))
+    {
+      _tyStdStrPersist strPersist;
+      ConvertString(strPersist, _psz, _sstLen);
+      _WriteBytes( &strPersist[0], strPersist.length() * sizeof(_tyPersistAsChar) );
+    }
+    else
+      _WriteBytes( _psz, _sstLen * sizeof(_tyChar) );
+    if (m_fFlushOnLinefeed && !!m_stBuffered)
+    {
+      for (_tyLPCSTR pszCur = _psz, pszEnd = _psz + _sstLen; pszEnd != pszCur; ++pszCur)
+      {
+        if (_tyCharTraits::s_tcNewline == *pszCur)
         {
-          // More complex escaping of whitespace is possible here:
-          _tyLPCSTR pszNoEscape = pszWrite;
-          for (; pszPrintableWhitespaceAtEnd != pszNoEscape; ++pszNoEscape)
-          {
-            _tyLPCSTR pszPrintableWS = _tyCharTraits::s_szPrintableWhitespace;
-            for (; !!*pszPrintableWS; ++pszPrintableWS)
-            {
-              if (*pszNoEscape == *pszPrintableWS)
-                break;
-            }
-            if (!!*pszPrintableWS)
-              continue; // found printable WS that we want to print.
-            if ((*pszNoEscape < _tyCharTraits::s_tcFirstUnprintableChar) ||
-                (*pszNoEscape > _tyCharTraits::s_tcLastUnprintableChar))
-            {
-              _tyLPCSTR pszEscapeChar = _tyCharTraits::s_szEscapeStringChars;
-              for (; !!*pszEscapeChar && (*pszNoEscape != *pszEscapeChar); ++pszEscapeChar)
-                ;
-              if (!!*pszEscapeChar)
-                continue; // found printable WS that we want to print.
-            }
-          }
-          sstLenWrite = pszNoEscape - pszWrite;
+          Flush();
+          break;
         }
       }
-      if (sstLenWrite)
+    }
+  }
+  // If <_fEscape> then we escape all special characters when writing.
+  void WriteString(bool _fEscape, _tyLPCSTR _psz, ssize_t _sstLen = -1, const _tyJsonFormatSpec *_pjfs = 0)
+  {
+    JsonOutputStream_WriteString( *this, _fEscape, _psz, _sstLen, _pjfs );
+  }
+protected:
+  void _WriteBytes( const void * _pv, size_t _stBytes )
+  {
+    m_stBytesWritten += _stBytes;
+    if ( _stBytes > ( m_stBufferSize - m_stBuffered ) )
+    {
+      Flush();
+      if ( _stBytes >= m_stBufferSize )
       {
-        _rjos.WriteRawChars(pszWrite, sstLenWrite);
-        stLen -= sstLenWrite;
-        pszWrite += sstLenWrite;
-        if (!stLen)
-          return; // the overwhelming case is we return here.
+        _WriteFile( _pv, _stBytes ); // Too big to buffer - just write it.
+        return;
       }
-      else
-        Assert(!!stLen); // invariant.
     }
-    // else otherwise we will escape all remaining characters.
-    _rjos.WriteChar(_tyCharTraits::s_tcBackSlash); // use for error handling.
-    // If we haven't written the whole string then we encountered a character we need to escape.
-    switch (*pszWrite)
+    if ( !m_rgbyBuffer )
+      m_rgbyBuffer = std::make_unique<uint8_t[]>( m_stBufferSize );
+    memcpy( m_rgbyBuffer.get() + m_stBuffered, _pv, _stBytes );
+    m_stBuffered += _stBytes;
+    if ( !!m_stFlushAtBytes && ( m_stBuffered >= m_stFlushAtBytes ) )
+      Flush();
+  }
+  void _WriteFile( const void * _pv, size_t _stBytes )
+  {
+    uint64_t u64Wrote;
+    int iWriteResult = FileWrite( m_foFile.HFileGet(), _pv, _stBytes, &u64Wrote );
+    if (!!iWriteResult)
     {
-    case _tyCharTraits::s_tcBackSpace:
-      _rjos.WriteChar(_tyCharTraits::s_tcb);
-      break;
-    case _tyCharTraits::s_tcFormFeed:
-      _rjos.WriteChar(_tyCharTraits::s_tcf);
-      break;
-    case _tyCharTraits::s_tcNewline:
-      _rjos.WriteChar(_tyCharTraits::s_tcn);
-      break;
-    case _tyCharTraits::s_tcCarriageReturn:
-      _rjos.WriteChar(_tyCharTraits::s_tcr);
-      break;
-    case _tyCharTraits::s_tcTab:
-      _rjos.WriteChar(_tyCharTraits::s_tct);
-      break;
-    case _tyCharTraits::s_tcBackSlash:
-    case _tyCharTraits::s_tcDoubleQuote:
-      _rjos.WriteChar(*pszWrite);
-      break;
-    default:
-      // Unprintable character between 0 and 31. We'll use the \uXXXX method for this character.
-      _rjos.WriteChar(_tyCharTraits::s_tcu);
-      _rjos.WriteChar(_tyCharTraits::s_tc0);
-      _rjos.WriteChar(_tyCharTraits::s_tc0);
-      _rjos.WriteChar(_tyChar('0' + (*pszWrite / 16)));
-      _rjos.WriteChar(_tyChar((*pszWrite % 16) < 10 ? ('0' + (*pszWrite % 16)) : ('A' + (*pszWrite % 16) - 10)));
-      break;
+      Assert( -1 == iWriteResult );
+      THROWBADJSONSTREAMERRNO(GetLastErrNo(), "FileWrite() failed for file [%s]", m_szFilename.c_str());
     }
-    ++pszWrite;
-    --stLen;
+    if ( u64Wrote != _stBytes )
+      THROWBADJSONSTREAM("FileWrite() only wrote [%llu] bytes of [%zu] to file [%s].", (unsigned long long)u64Wrote, _stBytes, m_szFilename.c_str());
   }
-}
+  std::string m_szFilename;
+  std::string m_szExceptionString;
+  FileObj m_foFile;
+  std::unique_ptr<uint8_t[]> m_rgbyBuffer; // Allocated upon first buffered write.
+  size_t m_stBufferSize{s_kstDefaultBufferSize};
+  size_t m_stBuffered{0};       // Number of bytes currently in m_rgbyBuffer.
+  size_t m_stFlushAtBytes{0};   // If non-zero we flush when at least this many bytes are buffered.
+  bool m_fFlushOnLinefeed{false};
+  size_t m_stBytesWritten{0};   // Since open.
+};
 
-// JsonFileOutputStream: A class using open(), read(), etc.
+// EJsonAsyncBackpressure: What JsonAsyncFileOutputStream does when the producer needs a buffer and every buffer is waiting to be written.
+enum EJsonAsyncBackpressure : uint8_t
+{
+  ejabBlock, // Wait for the writer thread to release a buffer.
+  ejabDrop,  // Drop the current record - everything written since the last Flush() - and all further writes until the next Flush().
+  ejabGrow,  // Allocate another buffer, up to the limit given to SetBackpressurePolicy(), then block.
+  ejabJsonAsyncBackpressureCount
+};
+// EJsonAsyncSync: How the writer thread syncs the file to the storage device.
+enum EJsonAsyncSync : uint8_t
+{
+  ejasNone,     // Never sync - leave it to the OS.
+  ejasDataSync, // fdatasync().
+  ejasFullSync, // fsync().
+  ejasJsonAsyncSyncCount
+};
+
+// JsonAsyncFileOutputStream: Same contract as JsonFileOutputStream but the producing thread never calls write().
+// We fill one buffer while a background writer thread writes previously filled buffers to the file.
+// Flush() hands the current buffer to the writer and returns without waiting - Drain() waits for the writer to catch up.
+// When the writer hasn't yet started on the last buffer handed to it a Flush() appends to that buffer, so flushing after each
+//  small record (as _SysLogMgr does) doesn't use up a buffer per record.
+// Memory is bounded by the number of buffers - SetBackpressurePolicy() determines what happens when the writer falls behind.
+// An error on the writer thread is rethrown on the producing thread by the next write, Flush(), Drain() or Close() and the stream
+//  discards everything after that.
+// This object isn't movable since the writer thread refers to it.
 template <class t_tyCharTraits, class t_tyPersistAsChar = typename t_tyCharTraits::_tyPersistAsChar>
-class JsonFileOutputStream : public JsonOutputStreamBase<t_tyCharTraits, size_t>
+class JsonAsyncFileOutputStream : public JsonOutputStreamBase<t_tyCharTraits, size_t>
 {
-  typedef JsonFileOutputStream _tyThis;
+  typedef JsonAsyncFileOutputStream _tyThis;
   typedef JsonOutputStreamBase<t_tyCharTraits, size_t> _tyBase;
 public:
   typedef t_tyCharTraits _tyCharTraits;
@@ -1385,21 +2233,18 @@ public:
   typedef size_t _tyFilePos;
   typedef JsonReadCursor<_tyThis> _tyJsonReadCursor;
   typedef JsonFormatSpec<_tyCharTraits> _tyJsonFormatSpec;
+  static const size_t s_kstDefaultBufferSize = 65536;
+  static const size_t s_knDefaultBuffers = 2;
 
-  ~JsonFileOutputStream() = default;
-  JsonFileOutputStream() = default;
-  JsonFileOutputStream( JsonFileOutputStream const & ) = delete;
-  JsonFileOutputStream & operator = ( JsonFileOutputStream const &) = delete;
-  JsonFileOutputStream( JsonFileOutputStream && _rr ) = default;
-  JsonFileOutputStream & operator = ( JsonFileOutputStream &&) = default;
-  void swap( JsonFileOutputStream & _r )
+  ~JsonAsyncFileOutputStream() noexcept(false)
   {
-    _r.m_szFilename.swap(m_szFilename);
-    _r.m_szExceptionString.swap(m_szExceptionString);
-    m_foFile.swap( _r.m_foFile );
+    if (FOpened())
+      (void)Close(!std::uncaught_exceptions()); // Only throw on error from close if we are not currently unwinding.
   }
-  // This is a manner of indicating that something happened during streaming.
-  // Since we use object destruction to finalize writes to a file and cannot throw out of a destructor.
+  JsonAsyncFileOutputStream() = default;
+  JsonAsyncFileOutputStream( JsonAsyncFileOutputStream const & ) = delete;
+  JsonAsyncFileOutputStream & operator = ( JsonAsyncFileOutputStream const &) = delete;
+
   void SetExceptionString(const char *_szWhat)
   {
     m_szExceptionString = _szWhat;
@@ -1412,69 +2257,166 @@ public:
   {
     return m_foFile.FIsOpen();
   }
+  // The buffer size, backpressure and sync policies may only be changed while closed.
+  void SetBufferSize( size_t _stBufferSize )
+  {
+    _CheckClosed();
+    if ( !_stBufferSize )
+      THROWBADJSONSEMANTICUSE("A buffer size of zero isn't supported.");
+    m_stBufferSize = _stBufferSize;
+  }
+  size_t StGetBufferSize() const
+  {
+    return m_stBufferSize;
+  }
+  // _nBuffers: The number of buffers allocated upon open - at least two.
+  // _nMaxBuffers: For ejabGrow, the most buffers we will allocate before blocking - zero for no limit.
+  void SetBackpressurePolicy( EJsonAsyncBackpressure _ejab, size_t _nBuffers = s_knDefaultBuffers, size_t _nMaxBuffers = 0 )
+  {
+    _CheckClosed();
+    if ( ( _ejab >= ejabJsonAsyncBackpressureCount ) || ( _nBuffers < 2 ) || ( !!_nMaxBuffers && ( _nMaxBuffers < _nBuffers ) ) )
+      THROWBADJSONSEMANTICUSE("Invalid backpressure policy _ejab[%u] _nBuffers[%zu] _nMaxBuffers[%zu].", unsigned(_ejab), _nBuffers, _nMaxBuffers);
+    m_ejab = _ejab;
+    m_nBuffers = _nBuffers;
+    m_nMaxBuffers = _nMaxBuffers;
+  }
+  EJsonAsyncBackpressure EjabGetBackpressurePolicy() const
+  {
+    return m_ejab;
+  }
+  // The writer thread syncs once at least _stSyncAtBytes have been written since the last sync and/or once _msSyncInterval
+  //  has elapsed since the first unsynced write. Zero disables either trigger. Unless _ejas is ejasNone we always sync upon close.
+  void SetSyncPolicy( EJsonAsyncSync _ejas, size_t _stSyncAtBytes = 0, std::chrono::milliseconds _msSyncInterval = std::chrono::milliseconds( 0 ) )
+  {
+    _CheckClosed();
+    if ( _ejas >= ejasJsonAsyncSyncCount )
+      THROWBADJSONSEMANTICUSE("Invalid sync policy _ejas[%u].", unsigned(_ejas));
+    m_ejas = _ejas;
+    m_stSyncAtBytes = _stSyncAtBytes;
+    m_msSyncInterval = _msSyncInterval;
+  }
+  // _stFlushAtBytes: If non-zero then we hand the buffer to the writer as soon as at least this many bytes are buffered.
+  // _fFlushOnLinefeed: Flush() after writing any linefeed - e.g. after each record of JSON Lines output.
+  void SetFlushPolicy( size_t _stFlushAtBytes, bool _fFlushOnLinefeed )
+  {
+    m_stFlushAtBytes = _stFlushAtBytes;
+    m_fFlushOnLinefeed = _fFlushOnLinefeed;
+  }
+  // The number of bytes written since open - including those still buffered or dropped.
+  size_t StGetBytesWritten() const
+  {
+    return m_stBytesWritten;
+  }
+  // Bytes and records dropped under ejabDrop since open.
+  size_t StGetDroppedBytes() const
+  {
+    return m_stDroppedBytes;
+  }
+  size_t NGetDroppedRecords() const
+  {
+    return m_nDroppedRecords;
+  }
   // Throws on open failure. This object owns the lifetime of the file descriptor.
   void Open(const char *_szFilename, FileSharing _fs = FileSharing::NoSharing)
   {
+    (void)Close(); // Make sure we write anything remaining for any previously open file.
     m_szExceptionString.clear();
     m_foFile.SetHFile( CreateWriteOnlyFile( _szFilename, _fs) );
     if (!FOpened())
       THROWBADJSONSTREAMERRNO(GetLastErrNo(), "Unable to CreateWriteOnlyFile() file [%s]", _szFilename);
-    m_szFilename = _szFilename; // For error reporting and general debugging. Of course we don't need to store this.
+    m_szFilename = _szFilename;
+    _StartWriter();
   }
-  // Attach to an FD whose lifetime we do not own. This can be used, for instance, to attach to stdout which is usually at FD 1 (unless reopen()ed).
+  // Attach to an FD whose lifetime we do not own. Note that a sync policy will fail for FDs that don't support syncing - e.g. pipes.
   void AttachFd(vtyFileHandle _hFile, bool _fOwnFdLifetime = false)
   {
     Assert(_hFile != vkhInvalidFileHandle);
+    (void)Close();
     m_foFile.SetHFile( _hFile, _fOwnFdLifetime );
-    m_szFilename.clear();     // No filename indicates we are attached to "some hFile".
+    m_szFilename.clear();
+    _StartWriter();
   }
-  int Close()
+  // We write everything buffered, stop the writer and close the file. If !_fAllowThrows then we log any error and return -1.
+  int Close( bool _fAllowThrows = true ) noexcept(false)
   {
-    return m_foFile.Close();
+    if ( !FOpened() )
+      return 0;
+    std::exception_ptr ep;
+    try
+    {
+      Flush();
+    }
+    catch ( ... )
+    {
+      ep = std::current_exception();
+    }
+    {
+      std::unique_lock< std::mutex > lock( m_mtx );
+      m_fStop = true;
+      m_cvWriter.notify_one();
+    }
+    m_thrWriter.reset(); // The writer drains the queue and performs any final sync before exiting.
+    if ( !ep )
+      ep = m_epWriter;
+    _ReleaseBuffers();
+    int iClose = m_foFile.Close();
+    if ( !ep )
+      return iClose;
+    if ( _fAllowThrows )
+      std::rethrow_exception( ep );
+    try
+    {
+      std::rethrow_exception( ep );
+    }
+    catch ( std::exception const & rexc )
+    {
+      LOGSYSLOG(eslmtError, "JsonAsyncFileOutputStream::Close(): Caught exception [%s].", rexc.what());
+    }
+    return -1;
+  }
+  // Hand any buffered data to the writer thread - this doesn't wait for it to be written.
+  // This is also a record boundary: after dropping under ejabDrop we resume writing after the next Flush().
+  void Flush()
+  {
+    _CheckWriterError();
+    m_fDropping = false;
+    if ( !m_pbufCur || !m_pbufCur->m_stUsed )
+      return;
+    Assert(FOpened());
+    std::unique_lock< std::mutex > lock( m_mtx );
+    _SubmitLocked();
+  }
+  // Flush() and wait for the writer thread to write everything.
+  void Drain()
+  {
+    Flush();
+    if ( !FOpened() )
+      return;
+    std::unique_lock< std::mutex > lock( m_mtx );
+    m_cvProducer.wait( lock, [this]() { return ( m_dqWrite.empty() && !m_fWriting ) || !!m_epWriter; } );
+    if ( !!m_epWriter )
+      std::rethrow_exception( m_epWriter );
   }
-  void WriteByteOrderMark() const
+  void WriteByteOrderMark()
   {
     Assert( FOpened() );
-    Assert( 0 == NFileSeekAndThrow( m_foFile.HFileGet(), 0, vkSeekCur ) );
+    Assert( !m_pbufCur || !m_pbufCur->m_stUsed );
     uint8_t rgBOM[] = {0xFF, 0xFE};
-    uint64_t u64Wrote;
-    int iWriteResult = FileWrite( m_foFile.HFileGet(), &rgBOM, sizeof rgBOM, &u64Wrote );
-    if (!!iWriteResult)
-    {
-      Assert( -1 == iWriteResult );
-      THROWBADJSONSTREAMERRNO(GetLastErrNo(), "FileWrite() failed for file [%s]", m_szFilename.c_str());
-    }
-    Assert( u64Wrote == sizeof rgBOM );
+    _WriteBytes( rgBOM, sizeof rgBOM );
   }
-  // Write a single character from the file - always throw on EOF.
   void WriteChar(_tyChar _tc)
   {
     Assert(FOpened());
     if (sizeof(_tyChar) == sizeof(_tyPersistAsChar))
-    {
-      uint64_t u64Wrote;
-      int iWriteResult = FileWrite( m_foFile.HFileGet(), &_tc, sizeof _tc, &u64Wrote );
-      if (!!iWriteResult)
-      {
-        Assert( -1 == iWriteResult );
-        THROWBADJSONSTREAMERRNO(GetLastErrNo(), "FileWrite() failed for file [%s]", m_szFilename.c_str());
-      }
-      Assert( u64Wrote == sizeof _tc );
-    }
+      _WriteBytes( &_tc, sizeof _tc );
     else
     {
       _tyStdStrPersist strPersist;
       ConvertString(strPersist, &_tc, 1);
-      size_t stWrite = strPersist.length() * sizeof(_tyPersistAsChar);
-      uint64_t u64Wrote;
-      int iWriteResult = FileWrite( m_foFile.HFileGet(), &strPersist[0], stWrite, &u64Wrote );
-      if (!!iWriteResult)
-      {
-        Assert( -1 == iWriteResult );
-        THROWBADJSONSTREAMERRNO(GetLastErrNo(), "FileWrite() failed for file [%s]", m_szFilename.c_str());
-      }
-      Assert( u64Wrote == stWrite );
+      _WriteBytes( &strPersist[0], strPersist.length() * sizeof(_tyPersistAsChar) );
     }
+    if (m_fFlushOnLinefeed && (_tyCharTraits::s_tcNewline == _tc))
+      Flush();
   }
   void WriteRawChars(_tyLPCSTR _psz, ssize_t _sstLen = -1)
   {
@@ -1485,26 +2427,20 @@ public:
     {
       _tyStdStrPersist strPersist;
       ConvertString(strPersist, _psz, _sstLen);
-      size_t stWrite = strPersist.length() * sizeof(_tyPersistAsChar);
-      uint64_t u64Wrote;
-      int iWriteResult = FileWrite( m_foFile.HFileGet(), &strPersist[0], stWrite, &u64Wrote );
-      if (!!iWriteResult)
-      {
-        Assert( -1 == iWriteResult );
-        THROWBADJSONSTREAMERRNO(GetLastErrNo(), "FileWrite() failed for file [%s]", m_szFilename.c_str());
-      }
-      Assert( u64Wrote == stWrite );
+      _WriteBytes( &strPersist[0], strPersist.length() * sizeof(_tyPersistAsChar) );
     }
     else
+      _WriteBytes( _psz, _sstLen * sizeof(_tyChar) );
+    if (m_fFlushOnLinefeed)
     {
-      uint64_t u64Wrote;
-      int iWriteResult = FileWrite( m_foFile.HFileGet(), _psz, _sstLen, &u64Wrote );
-      if (!!iWriteResult)
+      for (_tyLPCSTR pszCur = _psz, pszEnd = _psz + _sstLen; pszEnd != pszCur; ++pszCur)
       {
-        Assert( -1 == iWriteResult );
-        THROWBADJSONSTREAMERRNO(GetLastErrNo(), "FileWrite() failed for file [%s]", m_szFilename.c_str());
+        if (_tyCharTraits::s_tcNewline == *pszCur)
+        {
+          Flush();
+          break;
+        }
       }
-      Assert( u64Wrote == _sstLen );
     }
   }
   // If <_fEscape> then we escape all special characters when writing.
@@ -1513,12 +2449,281 @@ public:
     JsonOutputStream_WriteString( *this, _fEscape, _psz, _sstLen, _pjfs );
   }
 protected:
+  struct _Buffer
+  {
+    std::unique_ptr<uint8_t[]> m_rgby;
+    size_t m_stUsed{0};
+  };
+  typedef std::unique_ptr<_Buffer> _tyBufferPtr;
+  typedef std::chrono::steady_clock _tyClock;
+
+  void _CheckClosed() const
+  {
+    if ( FOpened() )
+      THROWBADJSONSEMANTICUSE("This setting may only be changed while the stream is closed.");
+  }
+  void _CheckWriterError()
+  {
+    if ( m_fWriterFailed.load( std::memory_order_acquire ) )
+    {
+      std::unique_lock< std::mutex > lock( m_mtx );
+      std::rethrow_exception( m_epWriter );
+    }
+  }
+  void _StartWriter()
+  {
+    Assert( !m_pbufCur && m_vecFree.empty() && m_dqWrite.empty() );
+    m_fStop = false;
+    m_fWriting = false;
+    m_epWriter = nullptr;
+    m_fWriterFailed.store( false, std::memory_order_relaxed );
+    m_fDropping = false;
+    m_stDroppedBytes = 0;
+    m_nDroppedRecords = 0;
+    m_stBytesWritten = 0;
+    m_vecFree.reserve( m_nBuffers );
+    for ( size_t nBuffer = 0; nBuffer < m_nBuffers; ++nBuffer )
+      m_vecFree.push_back( _PbufNew() );
+    m_nBuffersAllocated = m_nBuffers;
+    m_thrWriter = ScopedThread( &_tyThis::_WriterThread, this );
+  }
+  void _ReleaseBuffers()
+  {
+    m_pbufCur.reset();
+    m_vecFree.clear();
+    m_dqWrite.clear();
+    m_nBuffersAllocated = 0;
+  }
+  _tyBufferPtr _PbufNew() const
+  {
+    _tyBufferPtr pbuf = std::make_unique< _Buffer >();
+    pbuf->m_rgby = std::make_unique< uint8_t[] >( m_stBufferSize );
+    return pbuf;
+  }
+  void _WriteBytes( const void * _pv, size_t _stBytes )
+  {
+    _CheckWriterError();
+    m_stBytesWritten += _stBytes;
+    const uint8_t * pbyCur = (const uint8_t *)_pv;
+    while ( !!_stBytes )
+    {
+      if ( m_fDropping )
+      {
+        m_stDroppedBytes += _stBytes;
+        return;
+      }
+      if ( ( !m_pbufCur || ( m_stBufferSize == m_pbufCur->m_stUsed ) ) && !_FNextBuffer() )
+        continue; // Now dropping.
+      size_t stCopy = (std::min)( _stBytes, m_stBufferSize - m_pbufCur->m_stUsed );
+      memcpy( m_pbufCur->m_rgby.get() + m_pbufCur->m_stUsed, pbyCur, stCopy );
+      m_pbufCur->m_stUsed += stCopy;
+      pbyCur += stCopy;
+      _stBytes -= stCopy;
+    }
+    if ( !!m_stFlushAtBytes && !!m_pbufCur && ( m_pbufCur->m_stUsed >= m_stFlushAtBytes ) )
+    {
+      std::unique_lock< std::mutex > lock( m_mtx );
+      _SubmitLocked();
+    }
+  }
+  // Get a buffer with room in it, handing the current full buffer (if any) to the writer.
+  // Returns false if we have begun dropping the current record.
+  bool _FNextBuffer()
+  {
+    std::unique_lock< std::mutex > lock( m_mtx );
+    if ( !!m_pbufCur )
+    {
+      Assert( m_stBufferSize == m_pbufCur->m_stUsed );
+      if ( ( ejabDrop == m_ejab ) && m_vecFree.empty() )
+      { // Since Flush() submits the buffer the current buffer contains only the current record - drop it.
+        // A record larger than a buffer may have had its start written already - nothing to be done about that.
+        m_stDroppedBytes += m_pbufCur->m_stUsed;
+        m_pbufCur->m_stUsed = 0;
+        _BeginDropping();
+        return false;
+      }
+      _SubmitLocked();
+      if ( !!m_pbufCur )
+        return true; // Appended to the last queued buffer - can't happen with a full buffer but no matter.
+    }
+    if ( _FAcquireBufferLocked( lock ) )
+      return true;
+    _BeginDropping();
+    return false;
+  }
+  void _BeginDropping()
+  {
+    m_fDropping = true;
+    ++m_nDroppedRecords;
+  }
+  // Obtain a free buffer according to our backpressure policy. m_mtx is locked via _rlock.
+  bool _FAcquireBufferLocked( std::unique_lock< std::mutex > & _rlock )
+  {
+    Assert( !m_pbufCur );
+    for ( ;; )
+    {
+      if ( !!m_epWriter )
+        std::rethrow_exception( m_epWriter );
+      if ( !m_vecFree.empty() )
+      {
+        m_pbufCur = std::move( m_vecFree.back() );
+        m_vecFree.pop_back();
+        m_pbufCur->m_stUsed = 0;
+        return true;
+      }
+      if ( ( ejabGrow == m_ejab ) && ( !m_nMaxBuffers || ( m_nBuffersAllocated < m_nMaxBuffers ) ) )
+      {
+        m_pbufCur = _PbufNew();
+        ++m_nBuffersAllocated;
+        return true;
+      }
+      if ( ejabDrop == m_ejab )
+        return false;
+      m_cvProducer.wait( _rlock );
+    }
+  }
+  // Hand the current buffer to the writer. m_mtx must be locked.
+  void _SubmitLocked()
+  {
+    Assert( !!m_pbufCur && !!m_pbufCur->m_stUsed );
+    if ( !m_dqWrite.empty() && ( ( m_stBufferSize - m_dqWrite.back()->m_stUsed ) >= m_pbufCur->m_stUsed ) )
+    { // The writer hasn't started on the last queued buffer and there is room in it - append to it and keep our buffer.
+      _Buffer & rbufBack = *m_dqWrite.back();
+      memcpy( rbufBack.m_rgby.get() + rbufBack.m_stUsed, m_pbufCur->m_rgby.get(), m_pbufCur->m_stUsed );
+      rbufBack.m_stUsed += m_pbufCur->m_stUsed;
+      m_pbufCur->m_stUsed = 0;
+      return;
+    }
+    m_dqWrite.push_back( std::move( m_pbufCur ) );
+    m_cvWriter.notify_one();
+  }
+  void _WriterThread() noexcept
+  {
+    const bool kfSync = ( ejasNone != m_ejas );
+    const bool kfTimedSync = kfSync && ( m_msSyncInterval.count() > 0 );
+    size_t stUnsynced = 0;
+    _tyClock::time_point tpFirstUnsynced; // Time of the first write since the last sync.
+    std::unique_lock< std::mutex > lock( m_mtx );
+    for ( ;; )
+    {
+      auto lambdaReady = [this]() { return !m_dqWrite.empty() || m_fStop; };
+      if ( kfTimedSync && !!stUnsynced )
+        (void)m_cvWriter.wait_until( lock, tpFirstUnsynced + m_msSyncInterval, lambdaReady );
+      else
+        m_cvWriter.wait( lock, lambdaReady );
+      _tyBufferPtr pbuf;
+      if ( !m_dqWrite.empty() )
+      {
+        pbuf = std::move( m_dqWrite.front() );
+        m_dqWrite.pop_front();
+        m_fWriting = true;
+      }
+      const bool kfStopping = !pbuf && m_fStop;
+      const bool kfFailed = !!m_epWriter;
+      lock.unlock();
+      std::exception_ptr ep;
+      if ( !kfFailed )
+      {
+        try
+        {
+          if ( !!pbuf )
+          {
+            _WriteFile( pbuf->m_rgby.get(), pbuf->m_stUsed );
+            if ( kfSync && !stUnsynced )
+              tpFirstUnsynced = _tyClock::now();
+            stUnsynced += kfSync ? pbuf->m_stUsed : 0;
+          }
+          if ( !!stUnsynced && ( kfStopping || ( !!m_stSyncAtBytes && ( stUnsynced >= m_stSyncAtBytes ) ) ||
+                                 ( kfTimedSync && ( _tyClock::now() >= tpFirstUnsynced + m_msSyncInterval ) ) ) )
+          {
+            stUnsynced = 0;
+            _SyncFile();
+          }
+        }
+        catch ( ... )
+        {
+          ep = std::current_exception();
+        }
+      }
+      lock.lock();
+      if ( !!pbuf )
+      {
+        pbuf->m_stUsed = 0;
+        m_vecFree.push_back( std::move( pbuf ) );
+        m_fWriting = false;
+      }
+      if ( !!ep )
+      {
+        m_epWriter = ep;
+        m_fWriterFailed.store( true, std::memory_order_release );
+      }
+      if ( !!m_epWriter )
+      { // Discard anything queued - the producer will find out about the error on its next call.
+        for ( ; !m_dqWrite.empty(); m_dqWrite.pop_front() )
+        {
+          m_dqWrite.front()->m_stUsed = 0;
+          m_vecFree.push_back( std::move( m_dqWrite.front() ) );
+        }
+      }
+      m_cvProducer.notify_all();
+      if ( kfStopping )
+        break;
+    }
+  }
+  void _WriteFile( const void * _pv, size_t _stBytes )
+  {
+    uint64_t u64Wrote;
+    int iWriteResult = FileWrite( m_foFile.HFileGet(), _pv, _stBytes, &u64Wrote );
+    if (!!iWriteResult)
+    {
+      Assert( -1 == iWriteResult );
+      THROWBADJSONSTREAMERRNO(GetLastErrNo(), "FileWrite() failed for file [%s]", m_szFilename.c_str());
+    }
+    if ( u64Wrote != _stBytes )
+      THROWBADJSONSTREAM("FileWrite() only wrote [%llu] bytes of [%zu] to file [%s].", (unsigned long long)u64Wrote, _stBytes, m_szFilename.c_str());
+  }
+  void _SyncFile()
+  {
+    if ( !!FileSync( m_foFile.HFileGet(), ejasDataSync == m_ejas ) )
+      THROWBADJSONSTREAMERRNO(GetLastErrNo(), "FileSync() failed for file [%s]", m_szFilename.c_str());
+  }
   std::string m_szFilename;
   std::string m_szExceptionString;
   FileObj m_foFile;
+  // Settings - these are only changed while closed:
+  size_t m_stBufferSize{s_kstDefaultBufferSize};
+  size_t m_nBuffers{s_knDefaultBuffers};
+  size_t m_nMaxBuffers{0};
+  EJsonAsyncBackpressure m_ejab{ejabBlock};
+  EJsonAsyncSync m_ejas{ejasNone};
+  size_t m_stSyncAtBytes{0};
+  std::chrono::milliseconds m_msSyncInterval{0};
+  size_t m_stFlushAtBytes{0};
+  bool m_fFlushOnLinefeed{false};
+  // Producer state:
+  _tyBufferPtr m_pbufCur; // The buffer we are currently filling.
+  bool m_fDropping{false}; // Dropping until the next Flush().
+  size_t m_stDroppedBytes{0};
+  size_t m_nDroppedRecords{0};
+  size_t m_stBytesWritten{0};
+  // Shared state - protected by m_mtx:
+  std::mutex m_mtx;
+  std::condition_variable m_cvWriter;   // Signalled when a buffer is queued or upon stop.
+  std::condition_variable m_cvProducer; // Signalled when the writer releases a buffer.
+  std::vector<_tyBufferPtr> m_vecFree;
+  std::deque<_tyBufferPtr> m_dqWrite;
+  size_t m_nBuffersAllocated{0};
+  bool m_fWriting{false};
+  bool m_fStop{false};
+  std::exception_ptr m_epWriter;
+  std::atomic<bool> m_fWriterFailed{false}; // Set along with m_epWriter so the producer can check without locking.
+  ScopedThread m_thrWriter; // Last so that it is joined before anything it uses is destroyed.
 };
 
 // JsonMemMappedOutputStream: A class using open(), read(), etc.
+// The file and its mapping grow geometrically - each growth at least doubles the mapping up to a maximum step, see SetGrowthPolicy().
+// Under Linux the mapping is grown with mremap() so pages already written aren't faulted in again.
+// The file is truncated to exactly what was written upon Close().
 template <class t_tyCharTraits, class t_tyPersistAsChar = typename t_tyCharTraits::_tyPersistAsChar>
 class JsonMemMappedOutputStream : public JsonOutputStreamBase<t_tyCharTraits, size_t>
 {
@@ -1534,6 +2739,7 @@ public:
   typedef JsonReadCursor<_tyThis> _tyJsonReadCursor;
   typedef JsonFormatSpec<_tyCharTraits> _tyJsonFormatSpec;
   static const _tyFilePos s_knGrowFileByBytes = 65536 * 4;
+  static const _tyFilePos s_knMaxGrowFileByBytes = 1ull << 30;
 
   JsonMemMappedOutputStream() = default;
   ~JsonMemMappedOutputStream() noexcept(false)
@@ -1562,6 +2768,9 @@ public:
     std::swap(_r.m_cpxMappedCur, m_cpxMappedCur);
     std::swap(_r.m_cpxMappedEnd, m_cpxMappedEnd);
     std::swap(_r.m_stMapped, m_stMapped);
+    std::swap(_r.m_stMinGrowBytes, m_stMinGrowBytes);
+    std::swap(_r.m_stMaxGrowBytes, m_stMaxGrowBytes);
+    std::swap(_r.m_fPreallocate, m_fPreallocate);
   }
   // This is a manner of indicating that something happened during streaming.
   // Since we use object destruction to finalize writes to a file and cannot throw out of a destructor.
@@ -1578,6 +2787,18 @@ public:
     Assert( m_foFile.FIsOpen() == m_fmoFile.FIsOpen() );
     return m_fmoFile.FIsOpen();
   }
+  // _stMinGrowBytes: The initial size of the file and the least we grow it by. Rounded up to the page size.
+  // _stMaxGrowBytes: Once the mapping is this large we grow by this much at a time rather than doubling.
+  // _fPreallocate: Allocate the storage for each growth up front (posix_fallocate() under Linux) - a full disk then results in an
+  //  exception when growing rather than a SIGBUS when writing to the mapping.
+  // The initial size applies to the next Open().
+  void SetGrowthPolicy( size_t _stMinGrowBytes, size_t _stMaxGrowBytes = s_knMaxGrowFileByBytes, bool _fPreallocate = false )
+  {
+    size_t stPageSize = GetPageSize();
+    m_stMinGrowBytes = (std::max)( ( ( _stMinGrowBytes + stPageSize - 1 ) / stPageSize ) * stPageSize, stPageSize );
+    m_stMaxGrowBytes = (std::max)( _stMaxGrowBytes, m_stMinGrowBytes );
+    m_fPreallocate = _fPreallocate;
+  }
   // Throws on open failure. This object owns the lifetime of the file descriptor.
   void Open(const char *_szFilename)
   {
@@ -1585,13 +2806,13 @@ public:
     FileObj foFile( CreateReadWriteFile( _szFilename ) );
     if ( !foFile.FIsOpen() )
       THROWBADJSONSTREAMERRNO(GetLastErrNo(), "Unable to CreateReadWriteFile() file [%s]", _szFilename);
-    int iResult = FileSetSize( foFile.HFileGet(), s_knGrowFileByBytes ); // Set initial size.
+    int iResult = m_fPreallocate ? FileAllocate( foFile.HFileGet(), 0, m_stMinGrowBytes ) : FileSetSize( foFile.HFileGet(), m_stMinGrowBytes ); // Set initial size.
     if ( !!iResult )
-      THROWBADJSONSTREAMERRNO(GetLastErrNo(), "Unable to FileSetSize() file [%s]", _szFilename);
+      THROWBADJSONSTREAMERRNO(GetLastErrNo(), "Unable to set the initial size of file [%s]", _szFilename);
     FileMappingObj fmoFile( MapReadWriteHandle( foFile.HFileGet() ) );
     if ( !fmoFile.FIsOpen() )
       THROWBADJSONSTREAMERRNO(GetLastErrNo(), "Mapping failed for [%s]", _szFilename);
-    m_stMapped = s_knGrowFileByBytes;
+    m_stMapped = m_stMinGrowBytes;
     m_cpxMappedCur = (_tyPersistAsChar *)fmoFile.Pv();
     m_cpxMappedEnd = m_cpxMappedCur + (m_stMapped / sizeof(_tyPersistAsChar));
     m_szFilename = _szFilename; // For error reporting and general debugging. Of course we don't need to store this.
@@ -1697,21 +2918,39 @@ protected:
   void _GrowMap(size_t _charsByAtLeast)
   {
     VerifyThrow( m_foFile.FIsOpen() && m_fmoFile.FIsOpen() );
-    // unmap, grow file, remap. That was easy!
     _charsByAtLeast *= sizeof(_tyPersistAsChar); // scale from chars to bytes.
-    size_t stGrowBy = (((_charsByAtLeast - 1) / s_knGrowFileByBytes) + 1) * s_knGrowFileByBytes;
+    // Double the mapping up to a step of m_stMaxGrowBytes - but always by at least what is needed.
+    size_t stGrowBy = (std::min)( (std::max)( m_stMapped, m_stMinGrowBytes ), m_stMaxGrowBytes );
+    if ( stGrowBy < _charsByAtLeast )
+      stGrowBy = (((_charsByAtLeast - 1) / m_stMinGrowBytes) + 1) * m_stMinGrowBytes;
+    size_t stNewMapped = m_stMapped + stGrowBy;
     void *pvOldMapping = m_fmoFile.Pv();
+#ifdef __linux__
+    // grow file, mremap.
+    _GrowFile(stNewMapped);
+    vtyMappedMemoryHandle hmmNew = RemapReadWriteHandle( m_fmoFile.HMMFileGet(), stNewMapped );
+    if ( hmmNew.FIsNull() )
+      THROWBADJSONSTREAMERRNO(GetLastErrNo(), "mremap() failed for file [%s].", m_szFilename.c_str());
+    (void)m_fmoFile.PvTransferHandle(); // mremap() has already released the old mapping.
+    m_fmoFile.SetHMMFile( hmmNew );
+#else //!__linux__
+    // unmap, grow file, remap. That was easy!
     (void)m_fmoFile.Close();
-    m_stMapped += stGrowBy;
-    int iFileSetSize = FileSetSize(m_foFile.HFileGet(), m_stMapped);
-    if (-1 == iFileSetSize)
-      THROWBADJSONSTREAMERRNO(GetLastErrNo(), "FileSetSize() failed for file [%s].", m_szFilename.c_str());
+    _GrowFile(stNewMapped);
     m_fmoFile.SetHMMFile( MapReadWriteHandle( m_foFile.HFileGet() ) );
     if ( !m_fmoFile.FIsOpen() )
       THROWBADJSONSTREAMERRNO(GetLastErrNo(), "Remapping the failed for file [%s].", m_szFilename.c_str());
+#endif //!__linux__
+    m_stMapped = stNewMapped;
     m_cpxMappedEnd = (_tyPersistAsChar *)m_fmoFile.Pv() + (m_stMapped / sizeof(_tyPersistAsChar));
     m_cpxMappedCur = (_tyPersistAsChar *)m_fmoFile.Pv() + (m_cpxMappedCur - (_tyPersistAsChar *)pvOldMapping);
   }
+  void _GrowFile(size_t _stNewSize)
+  {
+    int iResult = m_fPreallocate ? FileAllocate(m_foFile.HFileGet(), m_stMapped, _stNewSize - m_stMapped) : FileSetSize(m_foFile.HFileGet(), _stNewSize);
+    if (-1 == iResult)
+      THROWBADJSONSTREAMERRNO(GetLastErrNo(), "Growing file [%s] to [%zu] bytes failed.", m_szFilename.c_str(), _stNewSize);
+  }
   std::string m_szFilename;
   std::string m_szExceptionString;
   FileObj m_foFile; // We must keep the file open for writing to it mapped so we can resize it.
@@ -1719,6 +2958,9 @@ protected:
   _tyPersistAsChar *m_cpxMappedCur{(_tyPersistAsChar*)vkpvNullMapping};
   _tyPersistAsChar *m_cpxMappedEnd{(_tyPersistAsChar*)vkpvNullMapping};
   size_t m_stMapped{};
+  size_t m_stMinGrowBytes{s_knGrowFileByBytes};
+  size_t m_stMaxGrowBytes{s_knMaxGrowFileByBytes};
+  bool m_fPreallocate{false};
 };
 
 // This just writes to an in-memory stream which then can be done anything with.
@@ -2129,6 +3371,21 @@ public:
     if (m_pvValue)
       _DestroyValue();
   }
+  // Release ownership of any dynamically allocated value to the caller, leaving the type as it is - see AdoptValue().
+  // These allow JsonReadCursor to recycle JsonObject, JsonArray and string values rather than allocating them anew.
+  void *PvReleaseValue()
+  {
+    void *pvValue = m_pvValue;
+    m_pvValue = 0;
+    return pvValue;
+  }
+  // Take ownership of a dynamically allocated value of the type corresponding to our current type.
+  void AdoptValue(void *_pvValue)
+  {
+    Assert(!m_pvValue);
+    Assert((ejvtObject == m_jvtType) || (ejvtArray == m_jvtType) || (ejvtNumber == m_jvtType) || (ejvtString == m_jvtType));
+    m_pvValue = _pvValue;
+  }
 
   // Set that this value is at the end of the iteration according to <_fObject>.
   void SetEndOfIteration(bool _fObject)
@@ -2464,6 +3721,9 @@ public:
   bool m_fEscapePrintableWhitespace{true}; // Note that setting this to false violates the JSON standard - but it is useful for reading files sometimes.
   // Should we escape such whitespace when it appears at the end of a value or the whole value is whitespace?
   bool m_fEscapePrintableWhitespaceAtEndOfLine{true};
+  // Write floating point numbers in the shortest form that reads back to the same value, e.g. "1.5" rather than "1.500000".
+  // Setting this to false uses the previous printf() "%f" formatting. Integers are written the same either way.
+  bool m_fShortestRoundTripNumbers{true};
 };
 
 // JsonValueLife:
@@ -2481,6 +3741,9 @@ public:
   typedef typename _tyCharTraits::_tyStdStr _tyStdStr;
   typedef JsonValue<_tyCharTraits> _tyJsonValue;
   typedef JsonFormatSpec<_tyCharTraits> _tyJsonFormatSpec;
+  // Binary output streams (e.g. CborOutputStream in jsoncbor.h) encode the structure themselves and take numbers natively.
+  // No punctuation or formatting is written for them.
+  static constexpr bool s_kfBinaryOutputStream = requires { requires t_tyJsonOutputStream::s_kfBinaryEncoding; };
 
   JsonValueLife() = delete; // Must have a reference to the JsonOutputStream - though we may change this later.
   JsonValueLife(JsonValueLife const &) = delete;
@@ -2492,7 +3755,9 @@ public:
         m_pjvlParent(!_pjvlParent ? _rr.m_pjvlParent : _pjvlParent),
         m_nCurAggrLevel(_rr.m_nCurAggrLevel),
         m_nSubValuesWritten(_rr.m_nSubValuesWritten),
-        m_optJsonFormatSpec(_rr.m_optJsonFormatSpec)
+        m_optJsonFormatSpec(_rr.m_optJsonFormatSpec),
+        m_svRawValue(_rr.m_svRawValue),
+        m_fRawValue(_rr.m_fRawValue)
   {
     _rr.SetDontWritePostAmble(); // We own this things lifetime now.
   }
@@ -2524,18 +3789,26 @@ public:
   }
   void _WritePreamble(EJsonValueType _jvt)
   {
-    if (m_pjvlParent && !!m_pjvlParent->NSubValuesWritten()) // Write a comma if we aren't the first sub value.
-      m_rjos.WriteChar(_tyCharTraits::s_tcComma);
-    if (!!m_optJsonFormatSpec && !!NCurAggrLevel())
+    if constexpr (s_kfBinaryOutputStream)
+    {
+      if ((ejvtObject == _jvt) || (ejvtArray == _jvt))
+        m_rjos.WriteBeginAggregate(_jvt);
+    }
+    else
     {
-      m_optJsonFormatSpec->WriteLinefeed(m_rjos);
-      m_optJsonFormatSpec->WriteWhitespaceIndent(m_rjos, NCurAggrLevel());
+      if (m_pjvlParent && !!m_pjvlParent->NSubValuesWritten()) // Write a comma if we aren't the first sub value.
+        m_rjos.WriteChar(_tyCharTraits::s_tcComma);
+      if (!!m_optJsonFormatSpec && !!NCurAggrLevel())
+      {
+        m_optJsonFormatSpec->WriteLinefeed(m_rjos);
+        m_optJsonFormatSpec->WriteWhitespaceIndent(m_rjos, NCurAggrLevel());
+      }
+      // For aggregate types we will need to write something to the output stream right away.
+      if (ejvtObject == _jvt)
+        m_rjos.WriteChar(_tyCharTraits::s_tcLeftCurlyBr);
+      else if (ejvtArray == _jvt)
+        m_rjos.WriteChar(_tyCharTraits::s_tcLeftSquareBr);
     }
-    // For aggregate types we will need to write something to the output stream right away.
-    if (ejvtObject == _jvt)
-      m_rjos.WriteChar(_tyCharTraits::s_tcLeftCurlyBr);
-    else if (ejvtArray == _jvt)
-      m_rjos.WriteChar(_tyCharTraits::s_tcLeftSquareBr);
   }
   JsonValueLife(JsonValueLife &_jvl, _tyLPCSTR _pszKey, EJsonValueType _jvt)
       : m_rjos(_jvl.m_rjos),
@@ -2557,29 +3830,38 @@ public:
   }
   void _WritePreamble(_tyLPCSTR _pszKey, ssize_t _stLenKey, EJsonValueType _jvt)
   {
-    if (m_pjvlParent && !!m_pjvlParent->NSubValuesWritten()) // Write a comma if we aren't the first sub value.
-      m_rjos.WriteChar(_tyCharTraits::s_tcComma);
-    if (!!m_optJsonFormatSpec)
+    if constexpr (s_kfBinaryOutputStream)
+    {
+      m_rjos.WriteKey(_pszKey, _stLenKey < 0 ? _tyCharTraits::StrLen(_pszKey) : size_t(_stLenKey));
+      if ((ejvtObject == _jvt) || (ejvtArray == _jvt))
+        m_rjos.WriteBeginAggregate(_jvt);
+    }
+    else
     {
-      if (NCurAggrLevel())
+      if (m_pjvlParent && !!m_pjvlParent->NSubValuesWritten()) // Write a comma if we aren't the first sub value.
+        m_rjos.WriteChar(_tyCharTraits::s_tcComma);
+      if (!!m_optJsonFormatSpec)
       {
-        m_optJsonFormatSpec->WriteLinefeed(m_rjos);
-        m_optJsonFormatSpec->WriteWhitespaceIndent(m_rjos, NCurAggrLevel());
+        if (NCurAggrLevel())
+        {
+          m_optJsonFormatSpec->WriteLinefeed(m_rjos);
+          m_optJsonFormatSpec->WriteWhitespaceIndent(m_rjos, NCurAggrLevel());
+        }
       }
+      m_rjos.WriteChar(_tyCharTraits::s_tcDoubleQuote);
+      m_rjos.WriteString(true, _pszKey, _stLenKey);
+      m_rjos.WriteChar(_tyCharTraits::s_tcDoubleQuote);
+      m_rjos.WriteChar(_tyCharTraits::s_tcColon);
+
+      if (!!m_optJsonFormatSpec)
+        m_optJsonFormatSpec->WriteSpace(m_rjos);
+
+      // For aggregate types we will need to write something to the output stream right away.
+      if (ejvtObject == _jvt)
+        m_rjos.WriteChar(_tyCharTraits::s_tcLeftCurlyBr);
+      else if (ejvtArray == _jvt)
+        m_rjos.WriteChar(_tyCharTraits::s_tcLeftSquareBr);
     }
-    m_rjos.WriteChar(_tyCharTraits::s_tcDoubleQuote);
-    m_rjos.WriteString(true, _pszKey, _stLenKey);
-    m_rjos.WriteChar(_tyCharTraits::s_tcDoubleQuote);
-    m_rjos.WriteChar(_tyCharTraits::s_tcColon);
-
-    if (!!m_optJsonFormatSpec)
-      m_optJsonFormatSpec->WriteSpace(m_rjos);
-
-    // For aggregate types we will need to write something to the output stream right away.
-    if (ejvtObject == _jvt)
-      m_rjos.WriteChar(_tyCharTraits::s_tcLeftCurlyBr);
-    else if (ejvtArray == _jvt)
-      m_rjos.WriteChar(_tyCharTraits::s_tcLeftSquareBr);
   }
   ~JsonValueLife() noexcept(false) // We might throw from here.
   {
@@ -2592,28 +3874,58 @@ public:
   }
   void _WritePostamble()
   {
-    if (!!m_nSubValuesWritten && !!m_optJsonFormatSpec)
-    {
-      Assert((ejvtObject == m_jv.JvtGetValueType()) || (ejvtArray == m_jv.JvtGetValueType()));
-      m_optJsonFormatSpec->WriteLinefeed(m_rjos);
-      if (NCurAggrLevel())
-        m_optJsonFormatSpec->WriteWhitespaceIndent(m_rjos, NCurAggrLevel());
-    }
-    if (ejvtObject == m_jv.JvtGetValueType())
-    {
-      m_rjos.WriteChar(_tyCharTraits::s_tcRightCurlyBr);
-    }
-    else if (ejvtArray == m_jv.JvtGetValueType())
+    if constexpr (s_kfBinaryOutputStream)
     {
-      m_rjos.WriteChar(_tyCharTraits::s_tcRightSquareBr);
+      EJsonValueType jvt = m_jv.JvtGetValueType();
+      Assert(!m_fRawValue); // Raw values are JSON text.
+      if ((ejvtObject == jvt) || (ejvtArray == jvt))
+        m_rjos.WriteEndAggregate(jvt);
+      else if ((ejvtString == jvt) || (ejvtNumber == jvt))
+      {
+        const _tyStdStr *pstrValue = m_jv.PGetStringValue();
+        Assert(!!pstrValue);
+        m_rjos.WriteSimpleValue(jvt, !pstrValue ? 0 : pstrValue->c_str(), !pstrValue ? 0 : pstrValue->length());
+      }
+      else
+        m_rjos.WriteSimpleValue(jvt);
+      if (!!m_pjvlParent)
+        m_pjvlParent->IncSubValuesWritten();
     }
     else
     {
-      // Then we will write the simple value in m_jv. There should be a non-empty value there.
-      m_jv.WriteSimpleValue(m_rjos, !m_optJsonFormatSpec ? 0 : &*m_optJsonFormatSpec);
+      if (!!m_nSubValuesWritten && !!m_optJsonFormatSpec)
+      {
+        Assert((ejvtObject == m_jv.JvtGetValueType()) || (ejvtArray == m_jv.JvtGetValueType()));
+        m_optJsonFormatSpec->WriteLinefeed(m_rjos);
+        if (NCurAggrLevel())
+          m_optJsonFormatSpec->WriteWhitespaceIndent(m_rjos, NCurAggrLevel());
+      }
+      if (ejvtObject == m_jv.JvtGetValueType())
+      {
+        m_rjos.WriteChar(_tyCharTraits::s_tcRightCurlyBr);
+      }
+      else if (ejvtArray == m_jv.JvtGetValueType())
+      {
+        m_rjos.WriteChar(_tyCharTraits::s_tcRightSquareBr);
+      }
+      else if (m_fRawValue)
+      {
+        // Pass-through of a string or number token from the input - see SetRawValue().
+        if (ejvtString == m_jv.JvtGetValueType())
+          m_rjos.WriteChar(_tyCharTraits::s_tcDoubleQuote);
+        if (!m_svRawValue.empty())
+          m_rjos.WriteRawChars(m_svRawValue.data(), m_svRawValue.length());
+        if (ejvtString == m_jv.JvtGetValueType())
+          m_rjos.WriteChar(_tyCharTraits::s_tcDoubleQuote);
+      }
+      else
+      {
+        // Then we will write the simple value in m_jv. There should be a non-empty value there.
+        m_jv.WriteSimpleValue(m_rjos, !m_optJsonFormatSpec ? 0 : &*m_optJsonFormatSpec);
+      }
+      if (!!m_pjvlParent)
+        m_pjvlParent->IncSubValuesWritten(); // We have successfully written a subobject.
     }
-    if (!!m_pjvlParent)
-      m_pjvlParent->IncSubValuesWritten(); // We have successfully written a subobject.
   }
 
   // Accessors:
@@ -2639,6 +3951,14 @@ public:
   {
     m_jv.SetValue(std::move(_rrjvValue));
   }
+  // Write _svRaw as is for our string or number value - for a string this is the text between the quotes with any escapes intact.
+  // The caller guarantees that this is a valid JSON token, e.g. from JsonReadCursor::SvGetRawValue(), and that it lives until we are destroyed.
+  void SetRawValue(std::basic_string_view<_tyChar> _svRaw)
+  {
+    Assert((ejvtString == m_jv.JvtGetValueType()) || (ejvtNumber == m_jv.JvtGetValueType()));
+    m_svRawValue = _svRaw;
+    m_fRawValue = true;
+  }
   void IncSubValuesWritten()
   {
     ++m_nSubValuesWritten;
@@ -3073,11 +4393,18 @@ protected:
   template <class t_tyNum>
   void _WriteValue(_tyLPCSTR _pszKey, _tyLPCSTR _pszFmt, t_tyNum _num)
   {
-    const int knNum = 512;
-    _tyChar rgcNum[knNum];
-    int nPrinted = _tyCharTraits::Snprintf(rgcNum, knNum, _pszFmt, _num);
-    Assert(nPrinted < knNum);
-    _WriteValue(ejvtNumber, _pszKey, StrNLen(_pszKey), rgcNum, (std::min)(nPrinted, knNum - 1));
+    if constexpr (s_kfBinaryOutputStream)
+    {
+      Assert(FAtObjectValue());
+      if (!FAtObjectValue())
+        THROWBADJSONSEMANTICUSE("Writing a (key,value) pair to a non-object.");
+      JsonValueLife jvlObjectElement(*this, _pszKey, -1, ejvtNumber);
+      _WriteBinaryNumber(jvlObjectElement, _num);
+      return;
+    }
+    _tyChar rgcNum[s_knMaxFormattedNumber];
+    size_t stLen = _StFormatNumber(rgcNum, _pszFmt, _num);
+    _WriteValue(ejvtNumber, _pszKey, StrNLen(_pszKey), rgcNum, stLen);
   }
   void _WriteValue(EJsonValueType _ejvt, _tyLPCSTR _pszKey, size_t _stLenKey, _tyLPCSTR _pszValue, size_t _stLenValue)
   {
@@ -3091,22 +4418,49 @@ protected:
   }
   void _WriteValue(EJsonValueType _ejvt, _tyLPCSTR _pszKey, size_t _stLenKey, _tyStdStr &&_rrstrVal)
   {
-    Assert(FAtObjectValue());
-    if (!FAtObjectValue())
-      THROWBADJSONSEMANTICUSE("Writing a (key,value) pair to a non-object.");
-    Assert(_tyCharTraits::StrNLen(_pszKey, _stLenKey) == _stLenKey);
-    JsonValueLife jvlObjectElement(*this, _pszKey, _stLenKey, _ejvt);
-    *jvlObjectElement.RJvGet().PCreateStringValue() = std::move(_rrstrVal);
+    Assert(FAtObjectValue());
+    if (!FAtObjectValue())
+      THROWBADJSONSEMANTICUSE("Writing a (key,value) pair to a non-object.");
+    Assert(_tyCharTraits::StrNLen(_pszKey, _stLenKey) == _stLenKey);
+    JsonValueLife jvlObjectElement(*this, _pszKey, _stLenKey, _ejvt);
+    *jvlObjectElement.RJvGet().PCreateStringValue() = std::move(_rrstrVal);
+  }
+
+  template <class t_tyNum>
+  void _WriteValue(_tyLPCSTR _pszFmt, t_tyNum _num)
+  {
+    if constexpr (s_kfBinaryOutputStream)
+    {
+      Assert(FAtArrayValue());
+      if (!FAtArrayValue())
+        THROWBADJSONSEMANTICUSE("Writing a value to a non-array.");
+      JsonValueLife jvlArrayElement(*this, ejvtNumber);
+      _WriteBinaryNumber(jvlArrayElement, _num);
+      return;
+    }
+    _tyChar rgcNum[s_knMaxFormattedNumber];
+    size_t stLen = _StFormatNumber(rgcNum, _pszFmt, _num);
+    _WriteValue(ejvtNumber, rgcNum, stLen);
+  }
+  // The element's preamble has been written - write the number natively in its place.
+  template <class t_tyNum>
+  void _WriteBinaryNumber(JsonValueLife &_rjvlElement, t_tyNum _num)
+  {
+    _rjvlElement.SetDontWritePostAmble();
+    m_rjos.WriteNumber(_num);
+    IncSubValuesWritten();
   }
-
+  // Integers are always written directly - the result is identical to printf().
+  // Floating point is written in shortest round-trip form unless the format spec asks for printf() formatting with _pszFmt.
+  static const int s_knMaxFormattedNumber = 512;
   template <class t_tyNum>
-  void _WriteValue(_tyLPCSTR _pszFmt, t_tyNum _num)
+  size_t _StFormatNumber(_tyChar (&_rgcNum)[s_knMaxFormattedNumber], _tyLPCSTR _pszFmt, t_tyNum _num) const
   {
-    const int knNum = 512;
-    _tyChar rgcNum[knNum];
-    int nPrinted = _tyCharTraits::Snprintf(rgcNum, knNum, _pszFmt, _num);
-    Assert(nPrinted < knNum);
-    _WriteValue(ejvtNumber, rgcNum, (std::min)(nPrinted, knNum - 1));
+    if (std::is_integral_v<t_tyNum> || !m_optJsonFormatSpec || m_optJsonFormatSpec->m_fShortestRoundTripNumbers)
+      return JsonNumber_StFormat<_tyCharTraits>(_num, _rgcNum, s_knMaxFormattedNumber);
+    int nPrinted = _tyCharTraits::Snprintf(_rgcNum, s_knMaxFormattedNumber, _pszFmt, _num);
+    Assert(nPrinted < s_knMaxFormattedNumber);
+    return (std::min)(nPrinted, s_knMaxFormattedNumber - 1);
   }
   void _WriteValue(EJsonValueType _ejvt, _tyLPCSTR _pszValue, size_t _stLen)
   {
@@ -3132,6 +4486,8 @@ protected:
   _tyJsonValue m_jv;
   unsigned int m_nSubValuesWritten{}; // When a sub-value finishes its writing it will cause this number to be increment. This allows us to place commas correctly, etc.
   unsigned int m_nCurAggrLevel{};
+  std::basic_string_view<_tyChar> m_svRawValue; // When m_fRawValue we write this instead of m_jv.
+  bool m_fRawValue{false};
 };
 
 // JsonValueLifeAbstractBase:
@@ -3493,6 +4849,7 @@ public:
   using _tyCharTraits = t_tyCharTraits;
   typedef JsonValue<t_tyCharTraits> _tyJsonValue;
   using _tyStdStr = typename _tyCharTraits::_tyStdStr;
+  typedef std::basic_string_view<typename _tyCharTraits::_tyChar> _tyStringView;
 
   JsonObject(const _tyJsonValue *_pjvParent)
       : _tyBase(_pjvParent)
@@ -3508,26 +4865,51 @@ public:
 
   const _tyStdStr &RStrKey() const
   {
+    Assert(!m_svCurKey.data()); // Use the non-const version to materialize any key view.
+    return m_strCurKey;
+  }
+  const _tyStdStr &RStrKey()
+  {
+    if (!!m_svCurKey.data())
+    {
+      m_strCurKey.assign(m_svCurKey.data(), m_svCurKey.length());
+      m_svCurKey = _tyStringView();
+    }
     return m_strCurKey;
   }
+  // Return a view of the current key - this is valid until the key changes.
+  _tyStringView SvKey() const
+  {
+    return !!m_svCurKey.data() ? m_svCurKey : _tyStringView(m_strCurKey.c_str(), m_strCurKey.length());
+  }
   void GetKey(_tyStdStr &_strCurKey) const
   {
-    _strCurKey = m_strCurKey;
+    if (!!m_svCurKey.data())
+      _strCurKey.assign(m_svCurKey.data(), m_svCurKey.length());
+    else
+      _strCurKey = m_strCurKey;
   }
   void ClearKey()
   {
     m_strCurKey.clear();
+    m_svCurKey = _tyStringView();
   }
   void SwapKey(_tyStdStr &_rstr)
   {
     m_strCurKey.swap(_rstr);
+    m_svCurKey = _tyStringView();
+  }
+  // Set the key to reference characters owned by the input stream - avoids allocation when reading in-memory JSON.
+  void SetKeyView(_tyStringView _svKey)
+  {
+    m_svCurKey = _svKey;
   }
 
   // Set the JsonObject for the end of iteration.
   void SetEndOfIteration()
   {
     _tyBase::SetEndOfIteration(true);
-    m_strCurKey.clear();
+    ClearKey();
   }
   bool FEndOfIteration() const
   {
@@ -3537,6 +4919,7 @@ public:
 protected:
   using _tyBase::m_jvCur;
   _tyStdStr m_strCurKey; // The current label for this object.
+  _tyStringView m_svCurKey; // When non-null this is the current label, referencing the input stream's memory.
 };
 
 // JsonArray:
@@ -3594,6 +4977,7 @@ public:
   typedef JsonArray<_tyCharTraits> _tyJsonArray;
   typedef typename t_tyJsonInputStream::_tyFilePos _tyFilePos;
   using _tyStdStr = typename _tyCharTraits::_tyStdStr;
+  typedef std::basic_string_view<_tyChar> _tyStringView;
 
   JsonReadContext(_tyJsonValue *_pjvCur = nullptr, JsonReadContext *_pjrxPrev = nullptr)
       : m_pjrxPrev(_pjrxPrev),
@@ -3644,10 +5028,25 @@ public:
     Assert(!!m_pjvCur);
     return !m_pjvCur ? 0 : m_pjvCur->PGetStringValue();
   }
+  // The position of the first character of this element's value.
+  _tyFilePos PosStartValue() const
+  {
+    return m_posStartValue;
+  }
+  // If the string value was read as a view then copy it into the JsonValue's string.
+  void MaterializeStringView()
+  {
+    if (!!m_svValue.data())
+    {
+      PGetStringValue()->assign(m_svValue.data(), m_svValue.length());
+      m_svValue = _tyStringView();
+    }
+  }
 
   void SetEndOfIteration(_tyFilePos _pos)
   {
     m_tcFirst = 0;
+    m_svValue = _tyStringView();
     m_posStartValue = m_posEndValue = _pos;
     // The value is set to EndOfIteration separately.
   }
@@ -3678,6 +5077,27 @@ public:
     pjrxOldHead->m_pjrxNext.swap(_pjrxHead);
     _pjrxHead->m_pjrxPrev = 0;
   }
+  // Pop the head of stack and push it onto the singly linked list _pjrxFree for reuse. This may pop the last context.
+  static void PopStack(std::unique_ptr<JsonReadContext> &_pjrxHead, std::unique_ptr<JsonReadContext> &_pjrxFree)
+  {
+    std::unique_ptr<JsonReadContext> pjrxOldHead;
+    _pjrxHead.swap(pjrxOldHead);
+    pjrxOldHead->m_pjrxNext.swap(_pjrxHead);
+    if (!!_pjrxHead)
+      _pjrxHead->m_pjrxPrev = 0;
+    pjrxOldHead->m_pjrxNext.swap(_pjrxFree);
+    _pjrxFree.swap(pjrxOldHead);
+  }
+  // Reinitialize a context obtained from a free list.
+  void Reset(_tyJsonValue *_pjvCur)
+  {
+    Assert(!m_pjrxNext);
+    m_pjvCur = _pjvCur;
+    m_pjrxPrev = nullptr;
+    m_posStartValue = m_posEndValue = _tyFilePos();
+    m_tcFirst = 0;
+    m_svValue = _tyStringView();
+  }
 
 protected:
   _tyJsonValue *m_pjvCur{};                    // We maintain a soft reference to the current JsonValue at this level.
@@ -3686,6 +5106,7 @@ protected:
   _tyFilePos m_posStartValue{};                // The start of the value for this element - after parsing WS.
   _tyFilePos m_posEndValue{};                  // The end of the value for this element - before parsing WS beyond.
   _tyChar m_tcFirst{};                         // Only for the number type does this matter but since it does...
+  _tyStringView m_svValue;                     // A string value read in place by JsonReadCursor::SvGetStringValue() - see MaterializeStringView().
 };
 
 // JsonRestoreContext:
@@ -3759,6 +5180,11 @@ public:
   typedef JsonRestoreContext<t_tyJsonInputStream> _tyJsonRestoreContext;
   using _tyStdStr = typename _tyCharTraits::_tyStdStr;
   using _tyLPCSTR = typename _tyCharTraits::_tyLPCSTR;
+  typedef std::basic_string_view<_tyChar> _tyStringView;
+  // Input streams over in-memory JSON (JsonFixedMemInputStream, JsonMemMappedInputStream) can return strings in place.
+  static constexpr bool s_kfZeroCopyStrings = requires(t_tyJsonInputStream &_ris, _tyStringView &_rsv) { { _ris.FReadStringRun(_rsv) } -> std::same_as<bool>; };
+  // They may also have a structural index (BuildStructuralIndex()) - when present we use it to jump over whole values and elements.
+  static constexpr bool s_kfStructuralIndex = requires(t_tyJsonInputStream &_ris) { { _ris.FHasStructuralIndex() } -> std::same_as<bool>; };
 
   JsonReadCursor() = default;
   JsonReadCursor(JsonReadCursor const &) = delete;
@@ -3828,6 +5254,19 @@ public:
       *_pjvt = m_pjrxCurrent->JvtGetValueType();
     return pjoCur->RStrKey();
   }
+  // As RStrKey() but doesn't copy the key when reading from an in-memory stream.
+  // The view is valid until the cursor moves to the next element.
+  _tyStringView SvKey(EJsonValueType *_pjvt = 0) const
+  {
+    Assert(FAttached());
+    if (FAtEndOfAggregate() || !m_pjrxCurrent || !m_pjrxCurrent->m_pjrxNext || (ejvtObject != m_pjrxCurrent->m_pjrxNext->JvtGetValueType()))
+      THROWBADJSONSEMANTICUSE("No key available.");
+    _tyJsonObject *pjoCur = m_pjrxCurrent->m_pjrxNext->PGetJsonObject();
+    Assert(!pjoCur->FEndOfIteration()); // sanity
+    if (!!_pjvt)
+      *_pjvt = m_pjrxCurrent->JvtGetValueType();
+    return pjoCur->SvKey();
+  }
   // Get the current key if there is a current key.
   bool FGetKeyCurrent(_tyStdStr &_rstrKey, EJsonValueType &_rjvt) const
   {
@@ -3870,6 +5309,7 @@ public:
     // Now check if we haven't read the simple value yet because then we gotta read it.
     if ((ejvtObject != jvt) && (ejvtArray != jvt) && !m_pjrxCurrent->m_posEndValue)
       const_cast<_tyThis *>(this)->_ReadSimpleValue();
+    m_pjrxCurrent->MaterializeStringView();
 
     _tyJsonValue jvLocal(*m_pjrxCurrent->PJvGet()); // copy into local then swap values with passed value - solves all sorts of potential issues with initial conditions.
     _rjvValue.swap(jvLocal);
@@ -3890,6 +5330,7 @@ public:
     // Now check if we haven't read the value yet because then we gotta read it.
     if (!m_pjrxCurrent->m_posEndValue)
       const_cast<_tyThis *>(this)->_ReadSimpleValue();
+    m_pjrxCurrent->MaterializeStringView();
 
     switch (JvtGetValueType())
     {
@@ -3931,7 +5372,7 @@ public:
     }
   }
   template <class t_tyNum>
-  void _GetValue(_tyLPCSTR _pszFmt, t_tyNum &_rNumber) const
+  void _GetValue(t_tyNum &_rNumber) const
   {
     if (ejvtNumber != JvtGetValueType())
       THROWBADJSONSEMANTICUSE("Not at a numeric value type.");
@@ -3940,21 +5381,86 @@ public:
     if (!m_pjrxCurrent->m_posEndValue)
       const_cast<_tyThis *>(this)->_ReadSimpleValue();
 
-    // The presumption is that sscanf won't read past any decimal point if scanning a non-floating point number.
-    int iRet = sscanf(m_pjrxCurrent->PGetStringValue()->c_str(), _pszFmt, &_rNumber);
-    Assert(1 == iRet); // Due to the specification of number we expect this to always succeed.
-  }
-  void GetValue(uint8_t &_rby) const { _GetValue("%hhu", _rby); }
-  void GetValue(int8_t &_rsby) const { _GetValue("%hhd", _rsby); }
-  void GetValue(uint16_t &_rus) const { _GetValue("%hu", _rus); }
-  void GetValue(int16_t &_rss) const { _GetValue("%hd", _rss); }
-  void GetValue(uint32_t &_rui) const { _GetValue("%u", _rui); }
-  void GetValue(int32_t &_rsi) const { _GetValue("%d", _rsi); }
-  void GetValue(uint64_t &_rul) const { _GetValue("%llu", _rul); }
-  void GetValue(int64_t &_rsl) const { _GetValue("%lld", _rsl); }
-  void GetValue(float &_rfl) const { _GetValue("%e", _rfl); }
-  void GetValue(double &_rdbl) const { _GetValue("%e", _rdbl); }
-  void GetValue(long double &_rldbl) const { _GetValue("%Le", _rldbl); }
+    const _tyStdStr &rstrNum = *m_pjrxCurrent->PGetStringValue();
+    JsonParseNumber<_tyCharTraits>(rstrNum.c_str(), rstrNum.c_str() + rstrNum.length(), _rNumber);
+  }
+  // Return the text of the current number value without copying it - the view is valid until the cursor moves.
+  _tyStringView SvGetNumberValue() const
+  {
+    if (ejvtNumber != JvtGetValueType())
+      THROWBADJSONSEMANTICUSE("Not at a numeric value type.");
+    if (!m_pjrxCurrent->m_posEndValue)
+      const_cast<_tyThis *>(this)->_ReadSimpleValue();
+    const _tyStdStr &rstrNum = *m_pjrxCurrent->PGetStringValue();
+    return _tyStringView(rstrNum.c_str(), rstrNum.length());
+  }
+  void GetValue(uint8_t &_rby) const { _GetValue(_rby); }
+  void GetValue(int8_t &_rsby) const { _GetValue(_rsby); }
+  void GetValue(uint16_t &_rus) const { _GetValue(_rus); }
+  void GetValue(int16_t &_rss) const { _GetValue(_rss); }
+  void GetValue(uint32_t &_rui) const { _GetValue(_rui); }
+  void GetValue(int32_t &_rsi) const { _GetValue(_rsi); }
+  void GetValue(uint64_t &_rul) const { _GetValue(_rul); }
+  void GetValue(int64_t &_rsl) const { _GetValue(_rsl); }
+  void GetValue(float &_rfl) const { _GetValue(_rfl); }
+  void GetValue(double &_rdbl) const { _GetValue(_rdbl); }
+  void GetValue(long double &_rldbl) const { _GetValue(_rldbl); }
+
+  // Return a view of the current string value. For in-memory input streams a string without escapes is returned in place
+  //  without copying, otherwise this references the decoded string held by the current context.
+  // The view is valid until the cursor moves to the next element (or the in-memory stream is closed).
+  _tyStringView SvGetStringValue() const
+  {
+    Assert(FAttached());
+    if (ejvtString != JvtGetValueType())
+      THROWBADJSONSEMANTICUSE("Not at a string value type.");
+    if (!m_pjrxCurrent->m_posEndValue)
+    {
+      if constexpr (s_kfZeroCopyStrings)
+      {
+        _tyStringView svRun;
+        if (m_pis->FReadStringRun(svRun))
+          m_pjrxCurrent->m_svValue = svRun;
+        else
+          _ReadStringRest(const_cast<_tyThis *>(this)->_RStrCreateValue(*m_pjrxCurrent), svRun); // Has escapes - decode it.
+        m_pjrxCurrent->m_posEndValue = m_pis->ByPosGet();
+      }
+      else
+        const_cast<_tyThis *>(this)->_ReadSimpleValue();
+    }
+    if (!!m_pjrxCurrent->m_svValue.data())
+      return m_pjrxCurrent->m_svValue;
+    const _tyStdStr &rstr = *m_pjrxCurrent->PGetStringValue();
+    return _tyStringView(rstr.c_str(), rstr.length());
+  }
+  // Return a view of the current string or number value exactly as it appears in the in-memory input stream.
+  // For a string this is the text between the quotes with any escapes intact. If the value hasn't been read yet then it
+  //  is skipped - which validates it - and nothing is copied.
+  // The view is valid as long as the in-memory stream is open.
+  _tyStringView SvGetRawValue() const
+    requires(s_kfZeroCopyStrings)
+  {
+    Assert(FAttached());
+    EJsonValueType jvt = JvtGetValueType();
+    if ((ejvtString != jvt) && (ejvtNumber != jvt))
+      THROWBADJSONSEMANTICUSE("Not at a string or number value type.");
+    if (!m_pjrxCurrent->m_posEndValue)
+    {
+      _SkipSimpleValue(jvt, m_pjrxCurrent->m_tcFirst, !m_pjrxCurrent->m_pjrxNext);
+      m_pjrxCurrent->m_posEndValue = m_pis->ByPosGet();
+    }
+    const _tyChar *pcBegin = m_pis->PcpxBegin() + (m_pjrxCurrent->m_posStartValue / sizeof(_tyChar));
+    const _tyChar *pcEnd = m_pis->PcpxBegin() + (m_pjrxCurrent->m_posEndValue / sizeof(_tyChar));
+    if (ejvtString == jvt)
+    {
+      Assert((pcEnd - pcBegin >= 2) && (_tyCharTraits::s_tcDoubleQuote == *pcBegin) && (_tyCharTraits::s_tcDoubleQuote == pcEnd[-1]));
+      return _tyStringView(pcBegin + 1, (pcEnd - pcBegin) - 2);
+    }
+    // A number may have been ended by whitespace which the stream has consumed.
+    for (; (pcEnd > pcBegin) && _tyCharTraits::FIsWhitespace(pcEnd[-1]); --pcEnd)
+      ;
+    return _tyStringView(pcBegin, pcEnd - pcBegin);
+  }
 
   // Speciality values:
   // Human readable date/time - implemented on ejvtString.
@@ -3962,6 +5468,9 @@ public:
   {
     if (ejvtString != JvtGetValueType())
       THROWBADJSONSEMANTICUSE("Not at a string value type.");
+    if (!m_pjrxCurrent->m_posEndValue)
+      const_cast<_tyThis *>(this)->_ReadSimpleValue();
+    m_pjrxCurrent->MaterializeStringView();
     int iRet = n_TimeUtil::ITimeFromString(m_pjrxCurrent->PGetStringValue()->c_str(), _tt);
     if (!!iRet)
       THROWBADJSONSEMANTICUSE("Failed to parse a date/time, iRet[%d].", iRet);
@@ -3971,6 +5480,9 @@ public:
   {
     if (ejvtString != JvtGetValueType())
       THROWBADJSONSEMANTICUSE("Not at a string value type.");
+    if (!m_pjrxCurrent->m_posEndValue)
+      const_cast<_tyThis *>(this)->_ReadSimpleValue();
+    m_pjrxCurrent->MaterializeStringView();
     if (m_pjrxCurrent->PGetStringValue()->length() < vkstUUIDNChars)
       THROWBADJSONSEMANTICUSE("Not enough characters in the string for a UUID string - 36 chars are required.");
     int iRet = UUIDFromString(m_pjrxCurrent->PGetStringValue()->c_str(), _uuidt);
@@ -3987,10 +5499,10 @@ public:
     switch (jvt)
     {
     case ejvtNumber:
-      _ReadNumber(m_pjrxCurrent->m_tcFirst, !m_pjrxCurrent->m_pjrxNext, *m_pjrxCurrent->PGetStringValue());
+      _ReadNumber(m_pjrxCurrent->m_tcFirst, !m_pjrxCurrent->m_pjrxNext, _RStrCreateValue(*m_pjrxCurrent));
       break;
     case ejvtString:
-      _ReadString(*m_pjrxCurrent->PGetStringValue());
+      _ReadString(_RStrCreateValue(*m_pjrxCurrent));
       break;
     case ejvtTrue:
     case ejvtFalse:
@@ -4106,8 +5618,7 @@ public:
     }
     m_pis->PushBackLastChar(true); // Let caller read this and decide what to do depending on context - we don't expect a specific character.
   Label_DreadedLabel:              // Just way too easy to do it this way.
-    *ptcCur++ = _tyChar(0);
-    _rstrRead = rgtcBuffer; // Copy the number into the return buffer.
+    _rstrRead.assign(rgtcBuffer, ptcCur - rgtcBuffer); // Copy the number into the return buffer.
   }
 
   // Skip a JSON number according to the specifications of such.
@@ -4177,9 +5688,76 @@ public:
     m_pis->PushBackLastChar(true); // Let caller read this and decide what to do depending on context - we don't expect a specific character here.
   }
 
+  // Read and decode the escape sequence following a '\\' within a string - the '\\' has already been read.
+  _tyChar _TchReadEscape() const
+  {
+    _tyChar tchCur = m_pis->ReadChar("EOF finding completion of backslash escape for string."); // throws on EOF.
+    switch (tchCur)
+    {
+    case _tyCharTraits::s_tcDoubleQuote:
+    case _tyCharTraits::s_tcBackSlash:
+    case _tyCharTraits::s_tcForwardSlash:
+      break; // Just use tchCur.
+    case _tyCharTraits::s_tcb:
+      tchCur = _tyCharTraits::s_tcBackSpace;
+      break;
+    case _tyCharTraits::s_tcf:
+      tchCur = _tyCharTraits::s_tcFormFeed;
+      break;
+    case _tyCharTraits::s_tcn:
+      tchCur = _tyCharTraits::s_tcNewline;
+      break;
+    case _tyCharTraits::s_tcr:
+      tchCur = _tyCharTraits::s_tcCarriageReturn;
+      break;
+    case _tyCharTraits::s_tct:
+      tchCur = _tyCharTraits::s_tcTab;
+      break;
+    case _tyCharTraits::s_tcu:
+    {
+      unsigned int uHex = 0; // Accumulate the hex amount.
+      unsigned int uCurrentMultiplier = (1u << 12);
+      // Must find 4 hex digits:
+      for (int n = 0; n < 4; ++n, (uCurrentMultiplier >>= 4))
+      {
+        tchCur = m_pis->ReadChar("EOF found looking for 4 hex digits following \\u."); // throws on EOF.
+        if ((tchCur >= _tyCharTraits::s_tc0) && (tchCur <= _tyCharTraits::s_tc9))
+          uHex += uCurrentMultiplier * (tchCur - _tyCharTraits::s_tc0);
+        else if ((tchCur >= _tyCharTraits::s_tca) && (tchCur <= _tyCharTraits::s_tcf))
+          uHex += uCurrentMultiplier * (10 + (tchCur - _tyCharTraits::s_tca));
+        else if ((tchCur >= _tyCharTraits::s_tcA) && (tchCur <= _tyCharTraits::s_tcF))
+          uHex += uCurrentMultiplier * (10 + (tchCur - _tyCharTraits::s_tcA));
+        else
+          THROWBADJSONSTREAM("Found [%TC] when looking for digit following \\u.", tchCur);
+      }
+      // If we are supposed to throw on overflow then check for it, otherwise just truncate to the character type silently.
+      if (_tyCharTraits::s_fThrowOnUnicodeOverflow && (sizeof(_tyChar) < sizeof(uHex)))
+      {
+        if (uHex >= (1u << (CHAR_BIT * sizeof(_tyChar))))
+          THROWBADJSONSTREAM("Unicode hex overflow [%u].", uHex);
+      }
+      tchCur = (_tyChar)uHex;
+      break;
+    }
+    default:
+      THROWBADJSONSTREAM("Found [%TC] when looking for competetion of backslash when reading string.", tchCur);
+      break;
+    }
+    return tchCur;
+  }
   // Read the string starting at the current position. The '"' has already been read.
   void _ReadString(_tyStdStr &_rstrRead) const
   {
+    if constexpr (s_kfZeroCopyStrings)
+    {
+      // In-memory streams: Copy runs of plain characters a block at a time.
+      _tyStringView svRun;
+      if (m_pis->FReadStringRun(svRun))
+        _rstrRead.assign(svRun.data(), svRun.length());
+      else
+        _ReadStringRest(_rstrRead, svRun);
+      return;
+    }
     const int knLenBuffer = 1023;
     _tyChar rgtcBuffer[knLenBuffer + 1]; // We will append a zero when writing to the string.
     rgtcBuffer[knLenBuffer] = 0;         // preterminate end.
@@ -4195,60 +5773,7 @@ public:
       if (_tyCharTraits::s_tcDoubleQuote == tchCur)
         break; // We have reached EOS.
       if (_tyCharTraits::s_tcBackSlash == tchCur)
-      {
-        tchCur = m_pis->ReadChar("EOF finding completion of backslash escape for string."); // throws on EOF.
-        switch (tchCur)
-        {
-        case _tyCharTraits::s_tcDoubleQuote:
-        case _tyCharTraits::s_tcBackSlash:
-        case _tyCharTraits::s_tcForwardSlash:
-          break; // Just use tchCur.
-        case _tyCharTraits::s_tcb:
-          tchCur = _tyCharTraits::s_tcBackSpace;
-          break;
-        case _tyCharTraits::s_tcf:
-          tchCur = _tyCharTraits::s_tcFormFeed;
-          break;
-        case _tyCharTraits::s_tcn:
-          tchCur = _tyCharTraits::s_tcNewline;
-          break;
-        case _tyCharTraits::s_tcr:
-          tchCur = _tyCharTraits::s_tcCarriageReturn;
-          break;
-        case _tyCharTraits::s_tct:
-          tchCur = _tyCharTraits::s_tcTab;
-          break;
-        case _tyCharTraits::s_tcu:
-        {
-          unsigned int uHex = 0; // Accumulate the hex amount.
-          unsigned int uCurrentMultiplier = (1u << 12);
-          // Must find 4 hex digits:
-          for (int n = 0; n < 4; ++n, (uCurrentMultiplier >>= 4))
-          {
-            tchCur = m_pis->ReadChar("EOF found looking for 4 hex digits following \\u."); // throws on EOF.
-            if ((tchCur >= _tyCharTraits::s_tc0) && (tchCur <= _tyCharTraits::s_tc9))
-              uHex += uCurrentMultiplier * (tchCur - _tyCharTraits::s_tc0);
-            else if ((tchCur >= _tyCharTraits::s_tca) && (tchCur <= _tyCharTraits::s_tcf))
-              uHex += uCurrentMultiplier * (10 + (tchCur - _tyCharTraits::s_tca));
-            else if ((tchCur >= _tyCharTraits::s_tcA) && (tchCur <= _tyCharTraits::s_tcF))
-              uHex += uCurrentMultiplier * (10 + (tchCur - _tyCharTraits::s_tcA));
-            else
-              THROWBADJSONSTREAM("Found [%TC] when looking for digit following \\u.", tchCur);
-          }
-          // If we are supposed to throw on overflow then check for it, otherwise just truncate to the character type silently.
-          if (_tyCharTraits::s_fThrowOnUnicodeOverflow && (sizeof(_tyChar) < sizeof(uHex)))
-          {
-            if (uHex >= (1u << (CHAR_BIT * sizeof(_tyChar))))
-              THROWBADJSONSTREAM("Unicode hex overflow [%u].", uHex);
-          }
-          tchCur = (_tyChar)uHex;
-          break;
-        }
-        default:
-          THROWBADJSONSTREAM("Found [%TC] when looking for competetion of backslash when reading string.", tchCur);
-          break;
-        }
-      }
+        tchCur = _TchReadEscape();
       if (ptchCur == rgtcBuffer + knLenBuffer)
       {
         _rstrRead += rgtcBuffer;
@@ -4260,9 +5785,60 @@ public:
     *ptchCur = 0;
     _rstrRead += rgtcBuffer;
   }
+  // In-memory streams: _svRun is the first run of plain characters of a string, and was terminated by a '\\'.
+  // Read the rest of the string a run at a time, decoding the escapes between runs.
+  void _ReadStringRest(_tyStdStr &_rstrRead, _tyStringView _svRun) const
+  {
+    std::basic_string<_tyChar> strRead(_svRun);
+    for (;;)
+    {
+      _tyChar tchBackSlash = m_pis->ReadChar("EOF found looking for backslash.");
+      Assert(_tyCharTraits::s_tcBackSlash == tchBackSlash);
+      (void)tchBackSlash;
+      strRead.push_back(_TchReadEscape());
+      bool fEnd = m_pis->FReadStringRun(_svRun);
+      strRead.append(_svRun);
+      if (fEnd)
+        break;
+    }
+    _rstrRead.assign(strRead.c_str(), strRead.length());
+  }
+  // Read an object's key into _rjo. The '"' has already been read.
+  // For in-memory streams we reference a key without escapes in place rather than copying it.
+  void _ReadKey(_tyJsonObject &_rjo) const
+  {
+    if constexpr (s_kfZeroCopyStrings)
+    {
+      _tyStringView svRun;
+      if (m_pis->FReadStringRun(svRun))
+      {
+        _rjo.SetKeyView(svRun);
+        return;
+      }
+      _tyStdStr strKey;
+      _ReadStringRest(strKey, svRun);
+      _rjo.SwapKey(strKey);
+    }
+    else
+    {
+      _tyStdStr strKey;
+      _ReadString(strKey);
+      _rjo.SwapKey(strKey);
+    }
+  }
   // Skip the string starting at the current position. The '"' has already been read.
   void _SkipRemainingString() const
   {
+    if constexpr (s_kfZeroCopyStrings)
+    {
+      // In-memory streams: Skip runs of plain characters a block at a time.
+      for (_tyStringView svRun; !m_pis->FReadStringRun(svRun);)
+      {
+        (void)m_pis->ReadChar("EOF found looking for backslash.");
+        _SkipEscape();
+      }
+      return;
+    }
     // We know we will see a '"' at the end. Along the way we may see multiple excape '\' characters.
     // So we move along checking each character, throwing if we hit EOF before the end of the string is found.
 
@@ -4272,37 +5848,41 @@ public:
       if (_tyCharTraits::s_tcDoubleQuote == tchCur)
         break; // We have reached EOS.
       if (_tyCharTraits::s_tcBackSlash == tchCur)
+        _SkipEscape();
+      // Otherwise we just continue reading.
+    }
+  }
+  // Skip and validate the escape sequence following a '\' within a string - the '\' has already been read.
+  void _SkipEscape() const
+  {
+    _tyChar tchCur = m_pis->ReadChar("EOF finding completion of backslash escape for string."); // throws on EOF.
+    switch (tchCur)
+    {
+    case _tyCharTraits::s_tcDoubleQuote:
+    case _tyCharTraits::s_tcBackSlash:
+    case _tyCharTraits::s_tcForwardSlash:
+    case _tyCharTraits::s_tcb:
+    case _tyCharTraits::s_tcf:
+    case _tyCharTraits::s_tcn:
+    case _tyCharTraits::s_tcr:
+    case _tyCharTraits::s_tct:
+      break;
+    case _tyCharTraits::s_tcu:
+    {
+      // Must find 4 hex digits:
+      for (int n = 0; n < 4; ++n)
       {
-        tchCur = m_pis->ReadChar("EOF finding completion of backslash escape for string."); // throws on EOF.
-        switch (tchCur)
-        {
-        case _tyCharTraits::s_tcDoubleQuote:
-        case _tyCharTraits::s_tcBackSlash:
-        case _tyCharTraits::s_tcForwardSlash:
-        case _tyCharTraits::s_tcb:
-        case _tyCharTraits::s_tcf:
-        case _tyCharTraits::s_tcn:
-        case _tyCharTraits::s_tcr:
-        case _tyCharTraits::s_tct:
-          break;
-        case _tyCharTraits::s_tcu:
-        {
-          // Must find 4 hex digits:
-          for (int n = 0; n < 4; ++n)
-          {
-            tchCur = m_pis->ReadChar("EOF found looking for 4 hex digits following \\u."); // throws on EOF.
-            if (!(((tchCur >= _tyCharTraits::s_tc0) && (tchCur <= _tyCharTraits::s_tc9)) ||
-                  ((tchCur >= _tyCharTraits::s_tca) && (tchCur <= _tyCharTraits::s_tcf)) ||
-                  ((tchCur >= _tyCharTraits::s_tcA) && (tchCur <= _tyCharTraits::s_tcF))))
-              THROWBADJSONSTREAM("Found [%TC] when looking for digit following \\u.", tchCur);
-          }
-        }
-        default:
-          THROWBADJSONSTREAM("Found [%TC] when looking for competetion of backslash when reading string.", tchCur);
-          break;
-        }
+        tchCur = m_pis->ReadChar("EOF found looking for 4 hex digits following \\u."); // throws on EOF.
+        if (!(((tchCur >= _tyCharTraits::s_tc0) && (tchCur <= _tyCharTraits::s_tc9)) ||
+              ((tchCur >= _tyCharTraits::s_tca) && (tchCur <= _tyCharTraits::s_tcf)) ||
+              ((tchCur >= _tyCharTraits::s_tcA) && (tchCur <= _tyCharTraits::s_tcF))))
+          THROWBADJSONSTREAM("Found [%TC] when looking for digit following \\u.", tchCur);
       }
-      // Otherwise we just continue reading.
+    }
+    break;
+    default:
+      THROWBADJSONSTREAM("Found [%TC] when looking for competetion of backslash when reading string.", tchCur);
+      break;
     }
   }
 
@@ -4361,9 +5941,24 @@ public:
       _SkipSimpleValue(jvtCur, tchCur, false); // we assume we aren't at the root element here since we shouldn't get here - we would have a context.
   }
 
+  // If the stream has a structural index then skip to just past the close of the aggregate at _posOpen and return true.
+  bool _FSkipAggregateIndexed(_tyFilePos _posOpen)
+  {
+    if constexpr (s_kfStructuralIndex)
+    {
+      if (m_pis->FHasStructuralIndex())
+      {
+        m_pis->SkipToMatchingBracket(_posOpen);
+        return true;
+      }
+    }
+    return false;
+  }
   // We will have read the first '{' of the object.
   void _SkipWholeObject()
   {
+    if (_FSkipAggregateIndexed(m_pis->ByPosGet() - sizeof(_tyChar)))
+      return;
     m_pis->SkipWhitespace();
     _tyChar tchCur = m_pis->ReadChar("EOF after begin bracket."); // throws on EOF.
     while (_tyCharTraits::s_tcDoubleQuote == tchCur)
@@ -4392,6 +5987,8 @@ public:
   // We will have read the first '[' of the array.
   void _SkipWholeArray()
   {
+    if (_FSkipAggregateIndexed(m_pis->ByPosGet() - sizeof(_tyChar)))
+      return;
     m_pis->SkipWhitespace();
     _tyChar tchCur = m_pis->ReadChar("EOF after begin bracket."); // throws on EOF.
     if (_tyCharTraits::s_tcRightSquareBr != tchCur)
@@ -4431,6 +6028,12 @@ public:
 
     // Then we have partially iterated the object. All contexts above us are closed which means we should find
     //  either a comma or end curly bracket.
+    if (_FSkipAggregateIndexed(_rjrx.m_posStartValue))
+    {
+      _rjrx.SetEndOfIteration(m_pis->ByPosGet());
+      _rjrx.PGetJsonObject()->SetEndOfIteration();
+      return;
+    }
     m_pis->SkipWhitespace();
     _tyChar tchCur = m_pis->ReadChar("EOF looking for end object } or comma."); // throws on EOF.
     while (_tyCharTraits::s_tcRightCurlyBr != tchCur)
@@ -4478,6 +6081,12 @@ public:
 
     // Then we have partially iterated the object. All contexts above us are closed which means we should find
     //  either a comma or end square bracket.
+    if (_FSkipAggregateIndexed(_rjrx.m_posStartValue))
+    {
+      _rjrx.SetEndOfIteration(m_pis->ByPosGet());
+      _rjrx.PGetJsonArray()->SetEndOfIteration();
+      return;
+    }
     m_pis->SkipWhitespace();
     _tyChar tchCur = m_pis->ReadChar("EOF looking for end array ] or comma."); // throws on EOF.
     while (_tyCharTraits::s_tcRightSquareBr != tchCur)
@@ -4524,7 +6133,7 @@ public:
     while (&*m_pjrxContextStack != m_pjrxCurrent)
     {
       _SkipContext(*m_pjrxContextStack);
-      _tyJsonReadContext::PopStack(m_pjrxContextStack);
+      _tyJsonReadContext::PopStack(m_pjrxContextStack, m_pjrxFree);
     }
   }
   void SkipTopContext()
@@ -4545,6 +6154,32 @@ public:
 
   // Move the the next element of the object or array. Return false if this brings us to the end of the entity.
   bool FNextElement()
+  {
+    return _FNextElement(0);
+  }
+  // Move forward _nElements elements in the object or array - equivalent to calling FNextElement() _nElements times.
+  // After FMoveDown() into an array, FSkipElements(N) moves to the Nth element.
+  // When the stream has a structural index the intervening elements are jumped over without being read.
+  // Return false if this brings us to the end of the entity.
+  bool FSkipElements(size_t _nElements)
+  {
+    if (!_nElements)
+      return !FAtEndOfAggregate();
+    if constexpr (s_kfStructuralIndex)
+    {
+      if (m_pis->FHasStructuralIndex())
+        return _FNextElement(_nElements - 1);
+    }
+    for (; _nElements; --_nElements)
+    {
+      if (!FNextElement())
+        return false;
+    }
+    return true;
+  }
+protected:
+  // Move to the next element, first skipping _nSkipElements elements using the stream's structural index.
+  bool _FNextElement(size_t _nSkipElements)
   {
     Assert(FAttached());
     // This should only be called when we are inside of an object or array.
@@ -4558,7 +6193,7 @@ public:
     if ((m_pjrxCurrent->JvtGetValueType() == ejvtEndOfObject) ||
         (m_pjrxCurrent->JvtGetValueType() == ejvtEndOfArray))
     {
-      Assert((m_pjrxCurrent->JvtGetValueType() == ejvtEndOfObject) == (ejvtObject != m_pjrxCurrent->m_pjrxNext->JvtGetValueType())); // Would be weird if it didn't match.
+      Assert((m_pjrxCurrent->JvtGetValueType() == ejvtEndOfObject) == (ejvtObject == m_pjrxCurrent->m_pjrxNext->JvtGetValueType())); // Would be weird if it didn't match.
       return false;                                                                                                                  // We are already at the end of the iteration.
     }
     // Perform common tasks:
@@ -4572,7 +6207,15 @@ public:
          !m_pjrxCurrent->FEndOfIteration()))
       SkipTopContext(); // Then skip the value at the current context.
     // Destroy the current object regardless - we are going to the next one.
+    _RecycleValue(*m_pjrxCurrent->PJvGet());
     m_pjrxCurrent->PJvGet()->Destroy();
+    if (!!_nSkipElements)
+    {
+      if constexpr (s_kfStructuralIndex)
+        (void)m_pis->FSkipElements(_nSkipElements, ejvtObject == m_pjrxCurrent->m_pjrxNext->JvtGetValueType()); // If we hit the end we will read the close below.
+      else
+        Assert(false);
+    }
 
     // Now we are going to look for a comma or an right curly/square bracket:
     m_pis->SkipWhitespace();
@@ -4595,9 +6238,7 @@ public:
       tchCur = m_pis->ReadChar("EOF looking for double quote."); // throws on EOF.
       if (_tyCharTraits::s_tcDoubleQuote != tchCur)
         THROWBADJSONSTREAM("Found [%TC] when looking key start double quote.", tchCur);
-      _tyStdStr strNextKey;
-      _ReadString(strNextKey); // Might throw for any number of reasons. This may be the empty string.
-      pjoCur->SwapKey(strNextKey);
+      _ReadKey(*pjoCur); // Might throw for any number of reasons. This may be the empty string.
       m_pis->SkipWhitespace();
       tchCur = m_pis->ReadChar("EOF looking for colon."); // throws on EOF.
       if (_tyCharTraits::s_tcColon != tchCur)
@@ -4619,6 +6260,7 @@ public:
     m_pis->SkipWhitespace();
     m_pjrxCurrent->m_posStartValue = m_pis->ByPosGet();
     m_pjrxCurrent->m_posEndValue = 0; // Reset this to zero because we haven't yet read the value for this next element yet.
+    m_pjrxCurrent->m_svValue = _tyStringView();
     // The first non-whitespace character tells us what the value type is:
     m_pjrxCurrent->m_tcFirst = m_pis->ReadChar("EOF looking for next object/array value.");
     m_pjrxCurrent->SetValueType(_tyJsonValue::GetJvtTypeFromChar(m_pjrxCurrent->m_tcFirst));
@@ -4627,14 +6269,19 @@ public:
     m_pjrxCurrent->m_pjrxNext->m_posEndValue = m_pis->ByPosGet(); // Update this as we iterate though there is no real reason to - might help with debugging.
     return true;
   }
+public:
 
   // Attach to the root of the JSON value tree.
   // We merely figure out the type of the value at this position.
   void AttachRoot(t_tyJsonInputStream &_ris)
   {
     Assert(!FAttached()); // We shouldn't have attached to the stream yet.
-    std::unique_ptr<_tyJsonValue> pjvRootVal = std::make_unique<_tyJsonValue>();
-    std::unique_ptr<_tyJsonReadContext> pjrxRoot = std::make_unique<_tyJsonReadContext>(&*pjvRootVal, (_tyJsonReadContext *)nullptr);
+    std::unique_ptr<_tyJsonValue> pjvRootVal;
+    if (!!m_pjvRootFree)
+      pjvRootVal.swap(m_pjvRootFree);
+    else
+      pjvRootVal = std::make_unique<_tyJsonValue>();
+    std::unique_ptr<_tyJsonReadContext> pjrxRoot = _PjrxNewContext(&*pjvRootVal);
     _ris.SkipWhitespace();
     pjrxRoot->m_posStartValue = _ris.ByPosGet();
     Assert(!pjrxRoot->m_posEndValue); // We should have a 0 now - unset - must be >0 when set (invariant).
@@ -4650,6 +6297,22 @@ public:
     m_pjrxRootVal.swap(pjvRootVal);       // swap in root value for tree.
     m_pis = &_ris;
   }
+  // Detach from the stream, keeping the context stack and values for reuse by the next AttachRoot().
+  // Reading a series of documents with a single cursor in this manner doesn't allocate once the cursor has seen the deepest document.
+  void Detach()
+  {
+    AssertValid();
+    if (!FAttached())
+      return;
+    while (!!m_pjrxContextStack)
+      _tyJsonReadContext::PopStack(m_pjrxContextStack, m_pjrxFree);
+    m_pjrxCurrent = nullptr;
+    _RecycleValue(*m_pjrxRootVal);
+    m_pjrxRootVal->Destroy();
+    m_pjvRootFree.swap(m_pjrxRootVal);
+    m_pjrxRootVal.reset();
+    m_pis = nullptr;
+  }
 
   bool FMoveDown() const
   {
@@ -4692,13 +6355,11 @@ public:
         THROWBADJSONSTREAM("Found [%TC] when looking for first character of object.", tchCur);
 
       // Then first value inside of the object. We must create a JsonObject that will be used to manage the iteration of the set of values within it.
-      _tyJsonObject *pjoNew = m_pjrxCurrent->PJvGet()->PCreateJsonObject();
-      pjrxNewRoot = std::make_unique<_tyJsonReadContext>(&pjoNew->RJvGet(), nullptr);
+      _tyJsonObject *pjoNew = _PCreateJsonObject(*m_pjrxCurrent->PJvGet());
+      pjrxNewRoot = _PjrxNewContext(&pjoNew->RJvGet());
       if (_tyCharTraits::s_tcDoubleQuote == tchCur)
       {
-        _tyStdStr strFirstKey;
-        _ReadString(strFirstKey); // Might throw for any number of reasons. This may be the empty string.
-        pjoNew->SwapKey(strFirstKey);
+        _ReadKey(*pjoNew); // Might throw for any number of reasons. This may be the empty string.
         m_pis->SkipWhitespace();
         tchCur = m_pis->ReadChar("EOF looking for colon on first object pair."); // throws on eof.
         if (_tyCharTraits::s_tcColon != tchCur)
@@ -4731,8 +6392,8 @@ public:
         THROWBADJSONSTREAM("Found [%TC] when looking for first char of array value.", tchCur);
 
       // Then first value inside of the object. We must create a JsonObject that will be used to manage the iteration of the set of values within it.
-      _tyJsonArray *pjaNew = m_pjrxCurrent->PJvGet()->PCreateJsonArray();
-      pjrxNewRoot = std::make_unique<_tyJsonReadContext>(&pjaNew->RJvGet(), nullptr);
+      _tyJsonArray *pjaNew = _PCreateJsonArray(*m_pjrxCurrent->PJvGet());
+      pjrxNewRoot = _PjrxNewContext(&pjaNew->RJvGet());
       if (ejvtJsonValueTypeCount != jvtCur)
       {
         pjrxNewRoot->m_posStartValue = posStartValue;
@@ -4779,12 +6440,104 @@ public:
     std::swap(m_pjrxCurrent, _r.m_pjrxCurrent);
     m_pjrxRootVal.swap(_r.m_pjrxRootVal);
     m_pjrxContextStack.swap(_r.m_pjrxContextStack);
+    m_pjrxFree.swap(_r.m_pjrxFree);
+    m_pjvRootFree.swap(_r.m_pjvRootFree);
+    m_rgpjoFree.swap(_r.m_rgpjoFree);
+    m_rgpjaFree.swap(_r.m_rgpjaFree);
+    m_rgpstrFree.swap(_r.m_rgpstrFree);
   }
 protected:
+  // Recycling of contexts and values:
+  // Contexts popped from the context stack and the JsonObject, JsonArray and string values of elements we move past are kept
+  //  for reuse, so that once we have seen the deepest part of a document we stop allocating.
+  std::unique_ptr<_tyJsonReadContext> _PjrxNewContext(_tyJsonValue *_pjvCur)
+  {
+    if (!m_pjrxFree)
+      return std::make_unique<_tyJsonReadContext>(_pjvCur, (_tyJsonReadContext *)nullptr);
+    std::unique_ptr<_tyJsonReadContext> pjrxNew;
+    pjrxNew.swap(m_pjrxFree);
+    m_pjrxFree.swap(pjrxNew->m_pjrxNext);
+    pjrxNew->Reset(_pjvCur);
+    return pjrxNew;
+  }
+  _tyJsonObject *_PCreateJsonObject(_tyJsonValue &_rjv)
+  {
+    if (m_rgpjoFree.empty())
+      return _rjv.PCreateJsonObject();
+    _tyJsonObject *pjo = m_rgpjoFree.back().release();
+    m_rgpjoFree.pop_back();
+    pjo->RJvGet().SetPjvParent(&_rjv);
+    _rjv.AdoptValue(pjo);
+    return pjo;
+  }
+  _tyJsonArray *_PCreateJsonArray(_tyJsonValue &_rjv)
+  {
+    if (m_rgpjaFree.empty())
+      return _rjv.PCreateJsonArray();
+    _tyJsonArray *pja = m_rgpjaFree.back().release();
+    m_rgpjaFree.pop_back();
+    pja->RJvGet().SetPjvParent(&_rjv);
+    _rjv.AdoptValue(pja);
+    return pja;
+  }
+  // Return the string value of the context, supplying a recycled string if it doesn't have one yet.
+  _tyStdStr &_RStrCreateValue(_tyJsonReadContext &_rjrx)
+  {
+    _tyJsonValue &rjv = *_rjrx.PJvGet();
+    if (rjv.FEmptyValue() && !m_rgpstrFree.empty())
+    {
+      rjv.AdoptValue(m_rgpstrFree.back().release());
+      m_rgpstrFree.pop_back();
+    }
+    return *rjv.PGetStringValue();
+  }
+  // Take any value owned by _rjv, recursively, for reuse.
+  void _RecycleValue(_tyJsonValue &_rjv)
+  {
+    if (_rjv.FEmptyValue())
+      return;
+    switch (_rjv.JvtGetValueType())
+    {
+    case ejvtObject:
+    {
+      std::unique_ptr<_tyJsonObject> pjo((_tyJsonObject *)_rjv.PvReleaseValue());
+      _RecycleValue(pjo->RJvGet());
+      pjo->RJvGet().Destroy();
+      pjo->ClearKey();
+      m_rgpjoFree.push_back(std::move(pjo));
+    }
+    break;
+    case ejvtArray:
+    {
+      std::unique_ptr<_tyJsonArray> pja((_tyJsonArray *)_rjv.PvReleaseValue());
+      _RecycleValue(pja->RJvGet());
+      pja->RJvGet().Destroy();
+      m_rgpjaFree.push_back(std::move(pja));
+    }
+    break;
+    case ejvtNumber:
+    case ejvtString:
+    {
+      std::unique_ptr<_tyStdStr> pstr((_tyStdStr *)_rjv.PvReleaseValue());
+      pstr->clear();
+      m_rgpstrFree.push_back(std::move(pstr));
+    }
+    break;
+    default:
+      _rjv.DestroyValue(); // Shouldn't have a value.
+      break;
+    }
+  }
+
   _tyJsonInputStream *m_pis{};                            // Soft reference to stream from which we read.
   std::unique_ptr<_tyJsonValue> m_pjrxRootVal;            // Hard reference to the root value of the value tree.
   std::unique_ptr<_tyJsonReadContext> m_pjrxContextStack; // Implement a simple doubly linked list.
   _tyJsonReadContext *m_pjrxCurrent{};                    // The current cursor position within context stack.
+  std::unique_ptr<_tyJsonReadContext> m_pjrxFree;         // Contexts for reuse - singly linked through m_pjrxNext.
+  std::unique_ptr<_tyJsonValue> m_pjvRootFree;            // The root value kept by Detach().
+  std::vector<std::unique_ptr<_tyJsonObject>> m_rgpjoFree;
+  std::vector<std::unique_ptr<_tyJsonArray>> m_rgpjaFree;
+  std::vector<std::unique_ptr<_tyStdStr>> m_rgpstrFree;
 };
 
 // Helper/example methods - these are use in jsonpp.cpp:
@@ -4849,6 +6602,44 @@ namespace n_JSONStream
     }
   }
 
+  // As StreamReadWriteJsonValue() but for in-memory input streams: string and number values are copied byte-for-byte from the input
+  //  to the output without being decoded and re-encoded. The structure and every value are still validated as they are read.
+  // Keys are decoded in place and re-escaped on output. Use this for fast reformatting (pretty-printing or minifying) of JSON files.
+  template <class t_tyJsonInputStream, class t_tyJsonOutputStream>
+  void StreamReadWriteJsonValueRaw(JsonReadCursor<t_tyJsonInputStream> &_jrc, JsonValueLife<t_tyJsonOutputStream> &_jvl)
+    requires(JsonReadCursor<t_tyJsonInputStream>::s_kfZeroCopyStrings && !JsonValueLife<t_tyJsonOutputStream>::s_kfBinaryOutputStream)
+  {
+    if (_jrc.FAtAggregateValue())
+    {
+      typename JsonReadCursor<t_tyJsonInputStream>::_tyJsonRestoreContext jrx(_jrc); // Restore to current context on destruct.
+      bool f = _jrc.FMoveDown();
+      Assert(f);
+      for (; !_jrc.FAtEndOfAggregate(); (void)_jrc.FNextElement())
+      {
+        if (ejvtObject == _jvl.JvtGetValueType())
+        {
+          EJsonValueType jvt;
+          typename JsonReadCursor<t_tyJsonInputStream>::_tyStringView svKey = _jrc.SvKey(&jvt);
+          JsonValueLife<t_tyJsonOutputStream> jvlObjectElement(_jvl, svKey.data(), svKey.length(), jvt);
+          StreamReadWriteJsonValueRaw(_jrc, jvlObjectElement);
+        }
+        else // array.
+        {
+          JsonValueLife<t_tyJsonOutputStream> jvlArrayElement(_jvl, _jrc.JvtGetValueType());
+          StreamReadWriteJsonValueRaw(_jrc, jvlArrayElement);
+        }
+      }
+    }
+    else
+    {
+      EJsonValueType jvt = _jrc.JvtGetValueType();
+      if ((ejvtString == jvt) || (ejvtNumber == jvt))
+        _jvl.SetRawValue(_jrc.SvGetRawValue());
+      else
+        _jrc.SkipTopContext(); // true, false or null - validate it, _jvl writes it from its type alone.
+    }
+  }
+
   struct JSONUnitTestContext
   {
     bool m_fSkippedSomething{false};
@@ -5053,6 +6844,22 @@ namespace n_JSONStream
           n_JSONStream::StreamReadWriteJsonValue(jrc, jvl); // Read the value at jrc - more specifically stream in the value.
       }
     }
+    // Reformat _pszInputFile according to _pjfs copying string and number values through unchanged - see StreamReadWriteJsonValueRaw().
+    static void StreamRaw(const char *_pszInputFile, _tyPrFilenameHandle _prfnhOutput, const _tyJsonFormatSpec *_pjfs)
+      requires(_tyJsonReadCursor::s_kfZeroCopyStrings)
+    {
+      _tyJsonInputStream jis;
+      jis.Open(_pszInputFile);
+      _tyJsonReadCursor jrc;
+      jis.AttachReadCursor(jrc);
+      _tyJsonOutputStream jos;
+      if (!!_prfnhOutput.first)
+        jos.Open(_prfnhOutput.first); // Open by default will truncate the file.
+      else
+        jos.AttachFd(_prfnhOutput.second);
+      _tyJsonValueLife jvl(jos, jrc.JvtGetValueType(), _pjfs);
+      n_JSONStream::StreamReadWriteJsonValueRaw(jrc, jvl);
+    }
   };
 
 } // namespace n_JSONStream
@@ -41,7 +41,7 @@ public:
     Assert(!FHasStringObj());
     assign(_r.c_str(), _r.length());
   }
-  StrWRsv(StrWRsv &&_rr)
+  StrWRsv(StrWRsv &&_rr) noexcept
   {
     Assert(!FHasStringObj());
     swap(_rr);
@@ -224,15 +224,15 @@ public:
       size_type stLenCur = length();
       if (stLenCur + stLenAdd < t_kstReserve)
       {
-        memcpy(m_rgtcBuffer + stLenCur, _psz, stLenAdd);
+        memcpy(m_rgtcBuffer + stLenCur, _psz, stLenAdd * sizeof(_tyChar));
         m_rgtcBuffer[stLenCur + stLenAdd] = 0;
       }
       else
       {
         size_type stTotal = stLenCur + stLenAdd;
-        _tyChar* rgInit = (_tyChar*)alloca(stTotal);
-        memcpy(rgInit, m_rgtcBuffer, stLenCur);
-        memcpy(rgInit + stLenCur, _psz, stLenAdd);
+        _tyChar* rgInit = (_tyChar*)alloca(stTotal * sizeof(_tyChar));
+        memcpy(rgInit, m_rgtcBuffer, stLenCur * sizeof(_tyChar));
+        memcpy(rgInit + stLenCur, _psz, stLenAdd * sizeof(_tyChar));
         new ((void *)m_rgtcBuffer) t_tyStrBase(rgInit, stTotal); // may throw.
         SetHasStringObj(); // throw-safe.
       }
@@ -0,0 +1,713 @@
+#pragma once
+
+//          Copyright David Lawrence Bien 1997 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt).
+
+// syslogbin.h
+// Deferred formatting of log messages and the binary per-thread log.
+// LOGSYSLOG_DEFERRED() captures a static _SysLogCallSite (format, file, line, type) once per call site and then only copies the
+//  arguments into the thread's buffer - printf formatting happens later: on the overlord thread when logging asynchronously, or not at
+//  all in process when SYSLOG_BINARYLOG is defined. Then each thread writes a binary log (.log.bin) which DecodeBinarySysLog() - see
+//  syslogdecode.cpp - turns into the JSON log format. Under SYSLOG_BINARYLOG only error records are formatted in process, for syslog().
+// Arguments are captured by type: integers (promoted to 32 or 64 bits), floating point, strings (copied) and pointers.
+
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <type_traits>
+#include "syslogmgr.h"
+#include "_strutil.h"
+#include "jsonobjs.h"
+
+__BIENUTIL_BEGIN_NAMESPACE
+
+// _SysLogCallSite:
+// The static description of a LOGSYSLOG_DEFERRED() call site. Its id is assigned on first use and identifies the call site within binary logs.
+struct _SysLogCallSite
+{
+  const char * m_pszFmt;
+  const char * m_pszFile;
+  unsigned int m_nLine;
+  ESysLogMessageType m_eslmtType;
+  _SysLogLazyId< _SysLogCallSite > m_sliId;
+
+  uint32_t NId() const { return m_sliId.NId(); }
+};
+
+#define LOGSYSLOG_DEFERRED( TYPE, MESG, ... )                                          \
+  do                                                                                   \
+  {                                                                                    \
+    if ( n_SysLog::FSysLogEnabled( TYPE, __FILE__ ) )                                  \
+    {                                                                                  \
+      static const _SysLogCallSite s_slcsLogSysLog{ MESG, __FILE__, __LINE__, TYPE };  \
+      n_SysLog::LogDeferred( s_slcsLogSysLog, ##__VA_ARGS__ );                         \
+    }                                                                                  \
+  } while ( 0 )
+
+// The types of captured arguments:
+enum _ESysLogArgType : uint8_t
+{
+  eslatInt32,
+  eslatUInt32,
+  eslatInt64,
+  eslatUInt64,
+  eslatDouble,
+  eslatLongDouble,
+  eslatString,
+  eslatPointer,
+  eslatSysLogArgTypeCount
+};
+
+// _SysLogArgs:
+// Encode arguments as (type,value) and format them later according to the printf format of the call site.
+struct _SysLogArgs
+{
+  template < class t_ty >
+  static void _AppendRaw( std::string & _rstr, t_ty _t )
+  {
+    _rstr.append( (const char *)&_t, sizeof( _t ) );
+  }
+  static void Append( std::string & _rstr, std::string_view _sv )
+  {
+    _rstr.push_back( char( eslatString ) );
+    _AppendRaw( _rstr, uint32_t( _sv.length() ) );
+    _rstr.append( _sv.data(), _sv.length() );
+  }
+  static void Append( std::string & _rstr, const char * _psz )
+  {
+    Append( _rstr, std::string_view( !_psz ? "(null)" : _psz ) );
+  }
+  static void Append( std::string & _rstr, std::string const & _rstrArg )
+  {
+    Append( _rstr, std::string_view( _rstrArg ) );
+  }
+  template < class t_ty >
+  static void Append( std::string & _rstr, t_ty const & _rt )
+    requires( std::is_arithmetic_v< t_ty > || std::is_enum_v< t_ty > || std::is_pointer_v< t_ty > || std::is_null_pointer_v< t_ty > )
+  {
+    if constexpr ( std::is_enum_v< t_ty > )
+      Append( _rstr, std::underlying_type_t< t_ty >( _rt ) );
+    else if constexpr ( std::is_same_v< t_ty, char * > )
+      Append( _rstr, (const char *)_rt );
+    else if constexpr ( std::is_pointer_v< t_ty > || std::is_null_pointer_v< t_ty > )
+    {
+      _rstr.push_back( char( eslatPointer ) );
+      _AppendRaw( _rstr, uint64_t( uintptr_t( _rt ) ) );
+    }
+    else if constexpr ( std::is_same_v< t_ty, long double > )
+    {
+      _rstr.push_back( char( eslatLongDouble ) );
+      _AppendRaw( _rstr, _rt );
+    }
+    else if constexpr ( std::is_floating_point_v< t_ty > )
+    {
+      _rstr.push_back( char( eslatDouble ) );
+      _AppendRaw( _rstr, double( _rt ) );
+    }
+    else if constexpr ( std::is_signed_v< t_ty > )
+    {
+      if constexpr ( sizeof( t_ty ) <= sizeof( int32_t ) )
+      {
+        _rstr.push_back( char( eslatInt32 ) );
+        _AppendRaw( _rstr, int32_t( _rt ) );
+      }
+      else
+      {
+        _rstr.push_back( char( eslatInt64 ) );
+        _AppendRaw( _rstr, int64_t( _rt ) );
+      }
+    }
+    else
+    {
+      if constexpr ( sizeof( t_ty ) <= sizeof( uint32_t ) )
+      {
+        _rstr.push_back( char( eslatUInt32 ) );
+        _AppendRaw( _rstr, uint32_t( _rt ) );
+      }
+      else
+      {
+        _rstr.push_back( char( eslatUInt64 ) );
+        _AppendRaw( _rstr, uint64_t( _rt ) );
+      }
+    }
+  }
+  template < class... t_tysArgs >
+  static void AppendAll( std::string & _rstr, t_tysArgs const &... _rargs )
+  {
+    ( Append( _rstr, _rargs ), ... );
+  }
+
+  // Format the captured arguments according to _pszFmt, appending to _rstrOut.
+  // A conversion that doesn't match the type of its argument formats the argument in the default manner for its type.
+  static void Format( const char * _pszFmt, const char * _pcArgs, size_t _stArgs, std::string & _rstrOut )
+  {
+    const char * pcArgEnd = _pcArgs + _stArgs;
+    for ( const char * pcCur = _pszFmt; !!*pcCur; )
+    {
+      const char * pcPercent = strchr( pcCur, '%' );
+      if ( !pcPercent )
+      {
+        _rstrOut += pcCur;
+        break;
+      }
+      _rstrOut.append( pcCur, pcPercent - pcCur );
+      pcCur = pcPercent + 1;
+      if ( '%' == *pcCur )
+      {
+        _rstrOut.push_back( '%' );
+        ++pcCur;
+        continue;
+      }
+      // Gather the flags, width and precision - substituting any '*' by its argument. Length modifiers are replaced by those for the captured type.
+      std::string strSpec( "%" );
+      for ( ; !!*pcCur && !!strchr( "-+ #0'", *pcCur ); ++pcCur )
+        strSpec.push_back( *pcCur );
+      auto lambdaWidth = [&]()
+      {
+        if ( '*' == *pcCur )
+        {
+          ++pcCur;
+          int64_t iWidth = 0;
+          if ( ( pcArgEnd != _pcArgs ) && ( ( eslatInt32 == *_pcArgs ) || ( eslatUInt32 == *_pcArgs ) ) && ( size_t( pcArgEnd - _pcArgs ) >= 1 + sizeof( int32_t ) ) )
+          {
+            int32_t i;
+            memcpy( &i, _pcArgs + 1, sizeof( i ) );
+            iWidth = i;
+            _pcArgs += 1 + sizeof( int32_t );
+          }
+          strSpec += std::to_string( iWidth );
+        }
+        else
+        {
+          for ( ; ( *pcCur >= '0' ) && ( *pcCur <= '9' ); ++pcCur )
+            strSpec.push_back( *pcCur );
+        }
+      };
+      lambdaWidth();
+      if ( '.' == *pcCur )
+      {
+        strSpec.push_back( *pcCur++ );
+        lambdaWidth();
+      }
+      for ( ; !!*pcCur && !!strchr( "hlLqjzt", *pcCur ); ++pcCur )
+        ;
+      if ( !*pcCur )
+        break;
+      char cConversion = *pcCur++;
+      if ( pcArgEnd == _pcArgs )
+      {
+        _rstrOut += "<missing>";
+        continue;
+      }
+      if ( !_FFormatArg( strSpec, cConversion, _pcArgs, pcArgEnd, _rstrOut ) )
+      {
+        _rstrOut += "<truncated>";
+        break;
+      }
+    }
+  }
+
+protected:
+  template < class t_ty >
+  static bool _FReadRaw( const char *& _rpcArgs, const char * _pcArgEnd, t_ty & _rt )
+  {
+    if ( size_t( _pcArgEnd - _rpcArgs ) < sizeof( t_ty ) )
+      return false;
+    memcpy( &_rt, _rpcArgs, sizeof( t_ty ) );
+    _rpcArgs += sizeof( t_ty );
+    return true;
+  }
+  template < class t_ty >
+  static void _AppendPrintf( std::string & _rstrOut, std::string const & _rstrSpec, t_ty _t )
+  {
+    char rgcBuf[ 256 ];
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+    int nLen = snprintf( rgcBuf, sizeof( rgcBuf ), _rstrSpec.c_str(), _t );
+    if ( nLen < 0 )
+      return;
+    if ( size_t( nLen ) < sizeof( rgcBuf ) )
+      _rstrOut.append( rgcBuf, nLen );
+    else
+    {
+      size_t stOut = _rstrOut.length();
+      _rstrOut.resize( stOut + nLen + 1 );
+      (void)snprintf( &_rstrOut[ stOut ], nLen + 1, _rstrSpec.c_str(), _t );
+      _rstrOut.resize( stOut + nLen );
+    }
+#pragma GCC diagnostic pop
+  }
+  static bool _FFormatArg( std::string & _rstrSpec, char _cConversion, const char *& _rpcArgs, const char * _pcArgEnd, std::string & _rstrOut )
+  {
+    uint8_t byType = uint8_t( *_rpcArgs++ );
+    bool fIntConversion = !!strchr( "diouxXc", _cConversion );
+    switch ( byType )
+    {
+    case eslatInt32:
+    case eslatUInt32:
+    {
+      int32_t i;
+      if ( !_FReadRaw( _rpcArgs, _pcArgEnd, i ) )
+        return false;
+      _rstrSpec.push_back( fIntConversion ? _cConversion : ( eslatInt32 == byType ? 'd' : 'u' ) );
+      _AppendPrintf( _rstrOut, _rstrSpec, i );
+    }
+    break;
+    case eslatInt64:
+    case eslatUInt64:
+    case eslatPointer:
+    {
+      int64_t i;
+      if ( !_FReadRaw( _rpcArgs, _pcArgEnd, i ) )
+        return false;
+      if ( ( eslatPointer == byType ) && !fIntConversion )
+      {
+        _rstrSpec.push_back( 'p' );
+        _AppendPrintf( _rstrOut, _rstrSpec, (const void *)uintptr_t( i ) );
+      }
+      else
+      {
+        _rstrSpec += "ll";
+        _rstrSpec.push_back( ( fIntConversion && ( 'c' != _cConversion ) ) ? _cConversion : ( eslatInt64 == byType ? 'd' : 'u' ) );
+        _AppendPrintf( _rstrOut, _rstrSpec, (long long)i );
+      }
+    }
+    break;
+    case eslatDouble:
+    case eslatLongDouble:
+    {
+      bool fFloatConversion = !!strchr( "fFeEgGaA", _cConversion );
+      if ( eslatDouble == byType )
+      {
+        double dbl;
+        if ( !_FReadRaw( _rpcArgs, _pcArgEnd, dbl ) )
+          return false;
+        _rstrSpec.push_back( fFloatConversion ? _cConversion : 'g' );
+        _AppendPrintf( _rstrOut, _rstrSpec, dbl );
+      }
+      else
+      {
+        long double ldbl;
+        if ( !_FReadRaw( _rpcArgs, _pcArgEnd, ldbl ) )
+          return false;
+        _rstrSpec.push_back( 'L' );
+        _rstrSpec.push_back( fFloatConversion ? _cConversion : 'g' );
+        _AppendPrintf( _rstrOut, _rstrSpec, ldbl );
+      }
+    }
+    break;
+    case eslatString:
+    {
+      uint32_t nLen;
+      if ( !_FReadRaw( _rpcArgs, _pcArgEnd, nLen ) || ( size_t( _pcArgEnd - _rpcArgs ) < nLen ) )
+        return false;
+      std::string str( _rpcArgs, nLen );
+      _rpcArgs += nLen;
+      _rstrSpec.push_back( 's' );
+      _AppendPrintf( _rstrOut, _rstrSpec, str.c_str() );
+    }
+    break;
+    default:
+      return false;
+    }
+    return true;
+  }
+};
+
+// The binary log:
+// "BSYSLOG1" followed by records of (uint8_t tag, uint32_t length of payload, payload). Values are written in the byte order of the host.
+// Strings are (uint32_t length, characters). A call site is written before the first record that refers to it.
+enum _ESysLogBinaryRecord : uint8_t
+{
+  eslbrThreadHeader = 1, // msSinceProgramStart(u64), TimeStarted(i64), ThreadId(u64), IsMainThread(u8), uuid, ProgName(str), ThreadSpecificData JSON(str)
+  eslbrCallSite,         // id(u32), Type(u8), Line(u32), Format(str), File(str)
+  eslbrDeferred,         // call site id(u32), msec(u64), Time(i64), captured arguments
+  eslbrContext,          // Type(u8), msec(u64), Time(i64), Line(i32), errno(i32), Mesg(str), File(str), Detail JSON(str)
+  eslbrSysLogBinaryRecordCount
+};
+inline constexpr char s_kszSysLogBinaryMagic[] = "BSYSLOG1";
+
+// _SysLogBinaryFile:
+// A thread's binary log. Records are accumulated in a buffer which is written when it fills and on Flush().
+class _SysLogBinaryFile
+{
+  typedef _SysLogBinaryFile _tyThis;
+
+public:
+  static constexpr size_t s_kstFlushBytes = 64 * 1024;
+
+  _SysLogBinaryFile() = default;
+  _SysLogBinaryFile( _SysLogBinaryFile const & ) = delete;
+  _SysLogBinaryFile & operator=( _SysLogBinaryFile const & ) = delete;
+  ~_SysLogBinaryFile() { Close(); }
+
+  void Open( const char * _pszFileName )
+  {
+    Assert( !FOpened() );
+    m_hFile = CreateWriteOnlyFile( _pszFileName, FileSharing::ShareRead );
+    if ( vkhInvalidFileHandle == m_hFile )
+      THROWNAMEDEXCEPTIONERRNO( GetLastErrNo(), "Unable to CreateWriteOnlyFile() file [%s]", _pszFileName );
+    m_strBuf.assign( s_kszSysLogBinaryMagic, sizeof( s_kszSysLogBinaryMagic ) - 1 );
+    m_nbyFlushed = 0;
+  }
+  bool FOpened() const { return vkhInvalidFileHandle != m_hFile; }
+  void Close() noexcept( true )
+  {
+    if ( FOpened() )
+    {
+      try
+      {
+        Flush();
+      }
+      catch ( std::exception const & rexc )
+      {
+        fprintf( stderr, "_SysLogBinaryFile::Close(): Caught exception [%s].\n", rexc.what() );
+      }
+      (void)FileClose( m_hFile );
+      m_hFile = vkhInvalidFileHandle;
+    }
+    m_strBuf.clear();
+    m_rgfCallSiteWritten.clear();
+    m_nbyFlushed = 0;
+  }
+  void Flush()
+  {
+    if ( !m_strBuf.empty() )
+    {
+      FileWriteOrThrow( m_hFile, m_strBuf.data(), m_strBuf.length() );
+      m_nbyFlushed += m_strBuf.length();
+      m_strBuf.clear();
+    }
+  }
+  bool FShouldFlush() const { return m_strBuf.length() >= s_kstFlushBytes; }
+  // The number of bytes written since open - including those still buffered.
+  uint64_t StGetBytesWritten() const { return m_nbyFlushed + m_strBuf.length(); }
+
+  void WriteThreadHeader( _SysLogThreadHeader const & _rslth, const n_SysLog::vtyJsoValueSysLog * _pjvThreadSpecificJson )
+  {
+    size_t posRecord = _PosBeginRecord( eslbrThreadHeader );
+    _SysLogArgs::_AppendRaw( m_strBuf, uint64_t( _rslth.m_nmsSinceProgramStart ) );
+    _SysLogArgs::_AppendRaw( m_strBuf, int64_t( _rslth.m_timeStart ) );
+    _SysLogArgs::_AppendRaw( m_strBuf, uint64_t( _rslth.m_tidThreadId ) );
+    m_strBuf.push_back( char( _rslth.m_fIsMainThread ) );
+    m_strBuf.append( (const char *)&_rslth.m_uuid, sizeof( _rslth.m_uuid ) );
+    _AppendString( _rslth.m_szProgramName );
+    std::string strJson;
+    if ( !!_pjvThreadSpecificJson )
+      _pjvThreadSpecificJson->ToString( strJson );
+    _AppendString( strJson );
+    _EndRecord( posRecord );
+  }
+  void WriteContext( _SysLogContext const & _rslc )
+  {
+    size_t posRecord = _PosBeginRecord( eslbrContext );
+    m_strBuf.push_back( char( _rslc.m_eslmtType ) );
+    _SysLogArgs::_AppendRaw( m_strBuf, uint64_t( _rslc.m_nmsSinceProgramStart ) );
+    _SysLogArgs::_AppendRaw( m_strBuf, int64_t( _rslc.m_time ) );
+    _SysLogArgs::_AppendRaw( m_strBuf, int32_t( _rslc.m_nLine ) );
+    _SysLogArgs::_AppendRaw( m_strBuf, int32_t( _rslc.m_errno ) );
+    _AppendString( _rslc.m_szFullMesg );
+    _AppendString( _rslc.m_szFile );
+    std::string strJson;
+    if ( !!_rslc.m_pjvLog )
+      _rslc.m_pjvLog->ToString( strJson );
+    _AppendString( strJson );
+    _EndRecord( posRecord );
+  }
+  // Write a deferred record - _rfEncodeArgs( std::string & ) appends the captured arguments.
+  template < class t_tyFEncodeArgs >
+  void WriteDeferred( _SysLogCallSite const & _rslcs, uint64_t _nmsSinceProgramStart, time_t _time, t_tyFEncodeArgs && _rrfEncodeArgs )
+  {
+    uint32_t nId = _rslcs.NId();
+    if ( ( m_rgfCallSiteWritten.size() <= nId ) || !m_rgfCallSiteWritten[ nId ] )
+      _WriteCallSite( nId, _rslcs );
+    size_t posRecord = _PosBeginRecord( eslbrDeferred );
+    _SysLogArgs::_AppendRaw( m_strBuf, nId );
+    _SysLogArgs::_AppendRaw( m_strBuf, _nmsSinceProgramStart );
+    _SysLogArgs::_AppendRaw( m_strBuf, int64_t( _time ) );
+    std::forward< t_tyFEncodeArgs >( _rrfEncodeArgs )( m_strBuf );
+    _EndRecord( posRecord );
+  }
+
+protected:
+  size_t _PosBeginRecord( _ESysLogBinaryRecord _eslbr )
+  {
+    m_strBuf.push_back( char( _eslbr ) );
+    size_t posRecord = m_strBuf.length();
+    _SysLogArgs::_AppendRaw( m_strBuf, uint32_t( 0 ) );
+    return posRecord;
+  }
+  void _EndRecord( size_t _posRecord )
+  {
+    uint32_t nLen = uint32_t( m_strBuf.length() - _posRecord - sizeof( uint32_t ) );
+    memcpy( &m_strBuf[ _posRecord ], &nLen, sizeof( nLen ) );
+  }
+  void _AppendString( std::string_view _sv )
+  {
+    _SysLogArgs::_AppendRaw( m_strBuf, uint32_t( _sv.length() ) );
+    m_strBuf.append( _sv.data(), _sv.length() );
+  }
+  void _WriteCallSite( uint32_t _nId, _SysLogCallSite const & _rslcs )
+  {
+    size_t posRecord = _PosBeginRecord( eslbrCallSite );
+    _SysLogArgs::_AppendRaw( m_strBuf, _nId );
+    m_strBuf.push_back( char( _rslcs.m_eslmtType ) );
+    _SysLogArgs::_AppendRaw( m_strBuf, uint32_t( _rslcs.m_nLine ) );
+    _AppendString( _rslcs.m_pszFmt );
+    _AppendString( _rslcs.m_pszFile );
+    _EndRecord( posRecord );
+    if ( m_rgfCallSiteWritten.size() <= _nId )
+      m_rgfCallSiteWritten.resize( _nId + 1 );
+    m_rgfCallSiteWritten[ _nId ] = true;
+  }
+
+  vtyFileHandle m_hFile{ vkhInvalidFileHandle };
+  std::string m_strBuf;
+  uint64_t m_nbyFlushed{ 0 };
+  std::vector< bool > m_rgfCallSiteWritten; // Indexed by call site id.
+};
+
+namespace n_SysLog
+{
+template < class... t_tysArgs >
+void
+LogDeferred( const _SysLogCallSite & _rslcs, t_tysArgs const &... _rargs )
+{
+  SysLogMgr::StaticLogDeferred( _rslcs, _rargs... );
+}
+// Format a deferred record as LOGSYSLOG() would have: "<Type>:file:line: message".
+inline void
+FormatDeferred( ESysLogMessageType _eslmtType, const char * _pszFmt, const char * _pszFile, unsigned int _nLine, const char * _pcArgs, size_t _stArgs,
+                std::string & _rstrOut )
+{
+  PrintfStdStr( _rstrOut, "<%s>:%s:%u: ", SysLogMgr::SzMessageType( _eslmtType ), _pszFile, _nLine );
+  _SysLogArgs::Format( _pszFmt, _pcArgs, _stArgs, _rstrOut );
+}
+
+// Convert the binary log _pszBinaryLog written under SYSLOG_BINARYLOG into the JSON log format in _pszJsonLog.
+// A truncated final record - e.g. from a crash - ends the log.
+inline void
+DecodeBinarySysLog( const char * _pszBinaryLog, const char * _pszJsonLog )
+{
+  std::string strLog;
+  { // B
+    FileObj foBinaryLog( OpenReadOnlyFile( _pszBinaryLog ) ); // Closes the file should we throw.
+    if ( !foBinaryLog.FIsOpen() )
+      THROWNAMEDEXCEPTIONERRNO( GetLastErrNo(), "Unable to open file [%s].", _pszBinaryLog );
+    char rgcBuf[ 65536 ];
+    for ( ;; )
+    {
+      uint64_t nbyRead;
+      if ( !!FileRead( foBinaryLog.HFileGet(), rgcBuf, sizeof( rgcBuf ), &nbyRead ) )
+        THROWNAMEDEXCEPTIONERRNO( GetLastErrNo(), "FileRead() failed for file [%s].", _pszBinaryLog );
+      if ( !nbyRead )
+        break;
+      strLog.append( rgcBuf, nbyRead );
+    }
+  } // EB
+  VerifyThrowSz( ( strLog.length() >= sizeof( s_kszSysLogBinaryMagic ) - 1 ) && !memcmp( strLog.data(), s_kszSysLogBinaryMagic, sizeof( s_kszSysLogBinaryMagic ) - 1 ),
+                 "File [%s] is not a binary syslog.", _pszBinaryLog );
+
+  typedef JsonCharTraits< char > _tyCharTraits;
+  typedef JsonFileOutputStream< _tyCharTraits, char > _tyJsonOutputStream;
+  typedef JsonValueLife< _tyJsonOutputStream > _tyJsonValueLife;
+  _tyJsonOutputStream jos;
+  jos.Open( _pszJsonLog );
+  JsonFormatSpec< _tyCharTraits > jfs;
+  jfs.m_nWhitespacePerIndent = 2;
+  jfs.m_fEscapePrintableWhitespace = true;
+  _tyJsonValueLife jvlRoot( jos, ejvtObject, &jfs );
+  std::optional< _tyJsonValueLife > optjvlSysLog;
+
+  struct _CallSite
+  {
+    std::string m_strFmt;
+    std::string m_strFile;
+    unsigned int m_nLine;
+    ESysLogMessageType m_eslmtType;
+  };
+  std::map< uint32_t, _CallSite > mapCallSites;
+  const char * pcCur = strLog.data() + sizeof( s_kszSysLogBinaryMagic ) - 1;
+  const char * const pcEnd = strLog.data() + strLog.length();
+  for ( ;; )
+  {
+    uint32_t nLen;
+    if ( ( size_t( pcEnd - pcCur ) < 1 + sizeof( nLen ) ) )
+      break;
+    _ESysLogBinaryRecord eslbr = _ESysLogBinaryRecord( *pcCur );
+    memcpy( &nLen, pcCur + 1, sizeof( nLen ) );
+    if ( size_t( pcEnd - pcCur ) < 1 + sizeof( nLen ) + nLen )
+      break;
+    const char * pcRec = pcCur + 1 + sizeof( nLen );
+    const char * const pcRecEnd = pcRec + nLen;
+    pcCur = pcRecEnd;
+    auto lambdaRead = [&pcRec, pcRecEnd]( auto & _rt )
+    {
+      VerifyThrowSz( size_t( pcRecEnd - pcRec ) >= sizeof( _rt ), "Corrupt binary syslog record." );
+      memcpy( &_rt, pcRec, sizeof( _rt ) );
+      pcRec += sizeof( _rt );
+    };
+    auto lambdaReadString = [&lambdaRead, &pcRec, pcRecEnd]( std::string & _rstr )
+    {
+      uint32_t nLenStr;
+      lambdaRead( nLenStr );
+      VerifyThrowSz( size_t( pcRecEnd - pcRec ) >= nLenStr, "Corrupt binary syslog record." );
+      _rstr.assign( pcRec, nLenStr );
+      pcRec += nLenStr;
+    };
+    auto lambdaWriteContext = [&]( _SysLogContext const & _rslc )
+    {
+      VerifyThrowSz( !!optjvlSysLog, "Binary syslog has no thread header." );
+      _tyJsonValueLife jvlContext( *optjvlSysLog, ejvtObject );
+      _rslc.ToJSONStream( jvlContext );
+    };
+    switch ( eslbr )
+    {
+    case eslbrThreadHeader:
+    {
+      VerifyThrowSz( !optjvlSysLog, "Binary syslog has more than one thread header." );
+      _SysLogThreadHeader slth;
+      uint64_t u64;
+      int64_t i64;
+      uint8_t by;
+      lambdaRead( u64 );
+      slth.m_nmsSinceProgramStart = u64;
+      lambdaRead( i64 );
+      slth.m_timeStart = time_t( i64 );
+      lambdaRead( u64 );
+      slth.m_tidThreadId = vtyProcThreadId( u64 );
+      lambdaRead( by );
+      slth.m_fIsMainThread = !!by;
+      lambdaRead( slth.m_uuid );
+      lambdaReadString( slth.m_szProgramName );
+      std::string strJson;
+      lambdaReadString( strJson );
+      _tyJsonValueLife jvlSysLogThreadHeader( jvlRoot, "SysLogThreadHeader", ejvtObject );
+      slth.ToJSONStream( jvlSysLogThreadHeader );
+      if ( !strJson.empty() )
+      {
+        vtyJsoValueSysLog jvThreadSpecific;
+        jvThreadSpecific.FromString( strJson );
+        _tyJsonValueLife jvlThreadSpec( jvlSysLogThreadHeader, "ThreadSpecificData", jvThreadSpecific.JvtGetValueType() );
+        jvThreadSpecific.ToJSONStream( jvlThreadSpec );
+      }
+    }
+      optjvlSysLog.emplace( jvlRoot, "SysLog", ejvtArray );
+      break;
+    case eslbrCallSite:
+    {
+      uint32_t nId, nLine;
+      uint8_t byType;
+      lambdaRead( nId );
+      lambdaRead( byType );
+      lambdaRead( nLine );
+      _CallSite & rcs = mapCallSites[ nId ];
+      rcs.m_eslmtType = ESysLogMessageType( byType );
+      rcs.m_nLine = nLine;
+      lambdaReadString( rcs.m_strFmt );
+      lambdaReadString( rcs.m_strFile );
+    }
+    break;
+    case eslbrDeferred:
+    {
+      uint32_t nId;
+      uint64_t u64;
+      int64_t i64;
+      lambdaRead( nId );
+      typename std::map< uint32_t, _CallSite >::const_iterator itCallSite = mapCallSites.find( nId );
+      VerifyThrowSz( mapCallSites.end() != itCallSite, "Binary syslog refers to unknown call site [%u].", nId );
+      _CallSite const & rcs = itCallSite->second;
+      _SysLogContext slc;
+      lambdaRead( u64 );
+      slc.m_nmsSinceProgramStart = u64;
+      lambdaRead( i64 );
+      slc.m_time = time_t( i64 );
+      slc.m_eslmtType = rcs.m_eslmtType;
+      slc.m_szFile = rcs.m_strFile;
+      slc.m_nLine = int( rcs.m_nLine );
+      FormatDeferred( rcs.m_eslmtType, rcs.m_strFmt.c_str(), rcs.m_strFile.c_str(), rcs.m_nLine, pcRec, pcRecEnd - pcRec, slc.m_szFullMesg );
+      lambdaWriteContext( slc );
+    }
+    break;
+    case eslbrContext:
+    {
+      _SysLogContext slc;
+      uint8_t byType;
+      uint64_t u64;
+      int64_t i64;
+      int32_t i32;
+      lambdaRead( byType );
+      slc.m_eslmtType = ESysLogMessageType( byType );
+      lambdaRead( u64 );
+      slc.m_nmsSinceProgramStart = u64;
+      lambdaRead( i64 );
+      slc.m_time = time_t( i64 );
+      lambdaRead( i32 );
+      slc.m_nLine = i32;
+      lambdaRead( i32 );
+      slc.m_errno = i32;
+      lambdaReadString( slc.m_szFullMesg );
+      lambdaReadString( slc.m_szFile );
+      std::string strJson;
+      lambdaReadString( strJson );
+      vtyJsoValueSysLog jvDetail;
+      if ( !strJson.empty() )
+      {
+        jvDetail.FromString( strJson );
+        slc.m_pjvLog = &jvDetail;
+      }
+      lambdaWriteContext( slc );
+    }
+    break;
+    default: // Skip records we don't know about.
+      break;
+    }
+  }
+}
+} // namespace n_SysLog
+
+// Log a deferred record: capture the arguments and leave the formatting to the overlord thread or to DecodeBinarySysLog().
+template < const int t_kiInstance >
+template < class... t_tysArgs >
+void
+_SysLogMgr< t_kiInstance >::StaticLogDeferred( const _SysLogCallSite & _rslcs, t_tysArgs const &... _rargs )
+{
+  _SysLogMgr & rslm = RGetThreadSysLogMgr();
+  uint64_t nmsSinceProgramStart = _GetMsSinceProgramStart();
+  time_t timeNow = time( 0 );
+  auto lambdaEncodeArgs = [&_rargs...]( std::string & _rstr ) { _SysLogArgs::AppendAll( _rstr, _rargs... ); };
+  if ( !!s_pslmOverlord.load( std::memory_order_acquire ) &&
+       rslm._FPushAsync(
+           [&]( _SysLogRecord & _rslr )
+           {
+             _rslr.m_eslmt = _rslcs.m_eslmtType;
+             _rslr.m_pslcs = &_rslcs;
+             _rslr.m_fHasContext = false;
+             _rslr.m_slc.m_nmsSinceProgramStart = nmsSinceProgramStart;
+             _rslr.m_slc.m_time = timeNow;
+             _rslr.m_strLog.clear(); // The capacity of the record's string is reused for the arguments.
+             lambdaEncodeArgs( _rslr.m_strLog );
+           } ) )
+    return;
+#ifdef SYSLOG_BINARYLOG
+  if ( !!rslm.m_upsbfThreadLog && rslm.m_upsbfThreadLog->FOpened() && ( eslmtError != _rslcs.m_eslmtType ) )
+  {
+    rslm.m_upsbfThreadLog->WriteDeferred( _rslcs, nmsSinceProgramStart, timeNow, lambdaEncodeArgs );
+    if ( rslm.m_upsbfThreadLog->FShouldFlush() )
+      rslm._FlushThreadLog();
+    else
+      rslm._CheckRotate();
+    return;
+  }
+#endif //SYSLOG_BINARYLOG
+  rslm.m_strDeferredArgs.clear();
+  lambdaEncodeArgs( rslm.m_strDeferredArgs );
+  if ( rslm._FLogDeferred( _rslcs, rslm.m_strDeferredArgs, nmsSinceProgramStart, timeNow ) )
+    rslm._FlushThreadLog();
+}
+
+__BIENUTIL_END_NAMESPACE
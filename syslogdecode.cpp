@@ -0,0 +1,62 @@
+//          Copyright David Lawrence Bien 1997 - 2021.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt).
+
+// syslogdecode.cpp
+// This decodes a binary per-thread log - written when SYSLOG_BINARYLOG is defined - into the JSON log format.
+// Include this in your project after your DBG_NEW/_compat.inl prelude, as for obj_opt.cpp - main() is defined in this module.
+
+#include "syslogmgr.h"
+#include "syslogmgr.inl"
+#include "syslogbin.h"
+
+__BIENUTIL_USING_NAMESPACE
+
+std::string g_strProgramName;
+
+int _TryMain( int _argc, char ** _argv );
+
+int main( int _argc, char ** _argv )
+{
+#define USAGE "Usage: %s <binary log file> <output JSON log file>"
+  g_strProgramName = _argv[0];
+  n_SysLog::SetSysLogGenerateThreadLogFiles( false ); // Our only output is the JSON log we are asked for.
+  n_SysLog::InitSysLog( g_strProgramName.c_str(), LOG_PERROR, LOG_USER );
+
+  if ( 3 != _argc )
+  {
+    LOGSYSLOG( eslmtError, USAGE, g_strProgramName.c_str() );
+    return EXIT_FAILURE;
+  }
+
+  try
+  {
+    return _TryMain( _argc - 1, _argv + 1 );
+  }
+  catch ( std::exception const & _rexc )
+  {
+    LOGEXCEPTION( _rexc, "Caught exception attempting to decode binary log file." );
+    return EXIT_FAILURE;
+  }
+  catch ( ... )
+  {
+    LOGSYSLOG( eslmtError, "Unknown exception caught." );
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+int _TryMain( int _argc, char ** _argv )
+{
+  try
+  {
+    n_SysLog::DecodeBinarySysLog( _argv[0], _argv[1] );
+  }
+  catch ( std::exception const & _rexc )
+  {
+    LOGEXCEPTION( _rexc, "Caught exception attempting to decode binary log file [%s] into [%s].", _argv[0], _argv[1] );
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -19,12 +19,30 @@
 //      functionality to the overriding "syslog manager thread" which can produce a "merged log" and may even
 //      be the thing that calls the syslog method to avoid a context switch for the calling thread.
 // 5) No apparent globals - the impl hides the presence of singleton-per-thread globals.
+// 6) Asynchronous mode (n_SysLog::StartAsyncSysLog()): Each thread pushes its log records into its own bounded single producer/single consumer
+//      ring and the overlord thread drains all the rings, calling syslog() and writing each thread's JSON log file. The calling thread then
+//      only formats the message. CloseThreadSysLog(), thread exit and StopAsyncSysLog() (which is also called at exit) flush the records in flight.
+// 7) Levels: Each message type has an ESysLogLevel. Call sites below SYSLOG_COMPILEMINLEVEL are compiled out and the rest are checked against the
+//      runtime threshold - and any per-file/per-module overrides - before the arguments are evaluated. See _SysLogLevelFilter.
+// 8) Rate limiting (LOGSYSLOG_RATELIMITED()): Each call site has a token bucket per thread - held by the thread's _SysLogMgr - so the check
+//      doesn't contend. Suppressed messages are summarized by count, see _SysLogMgr::_FRateAllow().
+// 9) Rotation (n_SysLog::SetSysLogRotation()): A thread's log file is closed - with its footer - when it reaches a size or age and logging continues in
+//      a new file that repeats the SysLogThreadHeader. Files aren't renamed and old files are removed on a background thread.
+// 10) Deferred formatting (LOGSYSLOG_DEFERRED(), see syslogbin.h): The call site's format, file, line and type are captured statically and the calling
+//      thread only copies the arguments - they are formatted on the overlord thread or, with SYSLOG_BINARYLOG, offline by DecodeBinarySysLog().
 
 #include <mutex>
 #include <thread>
 #include <memory>
 #include <optional>
 #include <chrono>
+#include <atomic>
+#include <condition_variable>
+#include <vector>
+#include <bit>
+#include <algorithm>
+#include <unordered_map>
+#include <deque>
 #include <assert.h>
 #ifndef WIN32
 #include <syslog.h>
@@ -51,17 +69,209 @@ template < class t_tyJsonInputStream > class JsonReadCursor;
 template < class t_tyJsonOutputStream > class JsonValueLife;
 template < class t_tyCharTraits > class JsonFormatSpec;
 template < class t_tyCharTraits, class t_tyPersistAsChar > class JsonFileOutputStream;
-template < class t_tyChar > class JsoValue;
+template < class t_tyCharTraits, class t_tyPersistAsChar > class JsonAsyncFileOutputStream;
+template < class t_tyCharTraits, class t_tyByteOutputStream > class CborOutputStream;
+struct JsoObjectStorageMap;
+struct _SysLogCallSite;
+class _SysLogBinaryFile;
+template < class t_tyChar, class t_tyObjectStorage, class t_tyAllocator > class JsoValue;
 
+// The values of the message types are persisted in the JSON logs - add new types at the end.
 enum _ESysLogMessageType : uint8_t
 {
   eslmtInfo,
   eslmtWarning,
   eslmtError,
+  eslmtDebug,
+  eslmtTrace,
   eslmtSysLogMessageTypeCount
 };
 typedef _ESysLogMessageType ESysLogMessageType;
 
+// Verbosity levels from least to most severe. A message is logged when its level is at least the threshold.
+enum _ESysLogLevel : uint8_t
+{
+  esllTrace,
+  esllDebug,
+  esllInfo,
+  esllWarning,
+  esllError,
+  esllOff, // As a threshold: log nothing.
+  esllSysLogLevelCount
+};
+typedef _ESysLogLevel ESysLogLevel;
+
+// SYSLOG_COMPILEMINLEVEL: Call sites whose level is below this ESysLogLevel value are compiled out. Their arguments are never evaluated.
+// The LOGSYSLOG_TRACE() and LOGSYSLOG_DEBUG() macros are removed by the preprocessor, other call sites with a constant type are removed by the optimizer.
+#ifndef SYSLOG_COMPILEMINLEVEL
+#define SYSLOG_COMPILEMINLEVEL 0 // esllTrace
+#endif
+
+constexpr ESysLogLevel
+EsllFromMessageType( ESysLogMessageType _eslmt )
+{
+  switch ( _eslmt )
+  {
+  case eslmtTrace:
+    return esllTrace;
+  case eslmtDebug:
+    return esllDebug;
+  case eslmtInfo:
+    return esllInfo;
+  case eslmtWarning:
+    return esllWarning;
+  default:
+    return esllError;
+  }
+}
+
+// _SysLogLevelFilter:
+// The runtime threshold and the per-file/per-module overrides of it. The common case costs a single relaxed atomic load: s_nLevelRange holds the
+//  lowest and highest thresholds in effect - levels outside of that range are decided without looking at the file.
+// An override key matches a file whose path ends with the key at a path separator ("net/socket.cpp", "socket.cpp"), or, if the key ends with a
+//  separator, a file within a directory of that name - a module ("net/"). The longest matching key wins.
+// The setters may be called at any time, from any thread - but not from within a signal handler: upon SIGHUP set a flag, or use a thread in
+//  sigwait(), and call n_SysLog::SetSysLogLevels() from there.
+class _SysLogLevelFilter
+{
+public:
+  static bool FEnabled( ESysLogLevel _esll, const char * _pszFile )
+  {
+    uint16_t nLevelRange = s_nLevelRange.load( std::memory_order_relaxed );
+    if ( _esll < ESysLogLevel( nLevelRange & 0xff ) )
+      return false;
+    if ( _esll >= ESysLogLevel( nLevelRange >> 8 ) )
+      return true;
+    return _esll >= _EsllThreshold( _pszFile );
+  }
+  static ESysLogLevel EsllGetThreshold();
+  static void SetThreshold( ESysLogLevel _esll );
+  static void SetOverride( const char * _pszFileOrModule, ESysLogLevel _esll );
+  static void RemoveOverride( const char * _pszFileOrModule );
+  static void ClearOverrides();
+  static void SetLevels( const char * _pszLevels );
+  static ESysLogLevel EsllFromName( const char * _pcName, size_t _stLen );
+
+protected:
+  static ESysLogLevel _EsllThreshold( const char * _pszFile );
+  static ESysLogLevel _EsllMatchOverrides( const char * _pszFile );
+  static void _UpdateLevelRange();
+  static bool _FIsSeparator( char _c ) { return ( '/' == _c ) || ( '\\' == _c ); }
+
+  typedef std::vector< std::pair< std::string, ESysLogLevel > > _tyRgOverrides;
+  // Each thread caches the threshold it found for each file - __FILE__ has static storage. s_nGeneration invalidates the cache.
+  struct _ThreadCache
+  {
+    uint32_t m_nGeneration{ 0 };
+    std::unordered_map< const char *, ESysLogLevel > m_mapThresholds;
+  };
+  inline static std::atomic< uint16_t > s_nLevelRange{ uint16_t( esllInfo | ( esllInfo << 8 ) ) };
+  inline static std::atomic< uint32_t > s_nGeneration{ 1 };
+  inline static std::mutex s_mtxOverrides; // Guards the members below.
+  inline static ESysLogLevel s_esllThreshold = esllInfo;
+  inline static _tyRgOverrides s_rgOverrides;
+  static thread_local _ThreadCache s_tls_tcThresholds;
+};
+inline thread_local _SysLogLevelFilter::_ThreadCache _SysLogLevelFilter::s_tls_tcThresholds;
+
+// _SysLogLazyId:
+// An id assigned on first use to a static call site descriptor - ids are dense from 1 within each t_tyOwner so they may index per-thread state.
+template < class t_tyOwner >
+struct _SysLogLazyId
+{
+  mutable std::atomic< uint32_t > m_nId{ 0 };
+
+  uint32_t NId() const
+  {
+    uint32_t nId = m_nId.load( std::memory_order_relaxed );
+    if ( !nId )
+    {
+      uint32_t nIdNew = ++s_nIdLast;
+      nId = m_nId.compare_exchange_strong( nId, nIdNew ) ? nIdNew : nId;
+    }
+    return nId;
+  }
+  inline static std::atomic< uint32_t > s_nIdLast{ 0 };
+};
+
+// _SysLogRateLimit:
+// The static description of a LOGSYSLOG_RATELIMITED() call site: at most m_nBurst messages at once, refilled at m_dblPerSecond. Its id, assigned on
+//  first use, indexes the token bucket for this call site within each thread's _SysLogMgr.
+struct _SysLogRateLimit
+{
+  const char * m_pszFile;
+  unsigned int m_nLine;
+  ESysLogMessageType m_eslmtType;
+  double m_dblPerSecond;
+  uint32_t m_nBurst;
+  _SysLogLazyId< _SysLogRateLimit > m_sliId;
+
+  uint32_t NId() const { return m_sliId.NId(); }
+};
+
+// _SysLogFileRemover:
+// Deletes files on a thread of its own so that the logging thread never waits on the filesystem for it. Files queued at exit are still deleted.
+class _SysLogFileRemover
+{
+public:
+  _SysLogFileRemover() = default;
+  _SysLogFileRemover( _SysLogFileRemover const & ) = delete;
+  _SysLogFileRemover & operator=( _SysLogFileRemover const & ) = delete;
+  ~_SysLogFileRemover()
+  {
+    { // B
+      std::lock_guard< std::mutex > lock( m_mtx );
+      m_fStop = true;
+    } // EB
+    m_cv.notify_one();
+    if ( m_thr.joinable() )
+      m_thr.join();
+  }
+  void Remove( std::string && _rrstrFile )
+  {
+    std::lock_guard< std::mutex > lock( m_mtx );
+    m_dqFiles.push_back( std::move( _rrstrFile ) );
+    if ( !m_thr.joinable() )
+      m_thr = std::thread( &_SysLogFileRemover::_RemoverThread, this );
+    m_cv.notify_one();
+  }
+
+protected:
+  void _RemoverThread()
+  {
+    std::unique_lock< std::mutex > lock( m_mtx );
+    for ( ;; )
+    {
+      m_cv.wait( lock, [this]() { return m_fStop || !m_dqFiles.empty(); } );
+      while ( !m_dqFiles.empty() )
+      {
+        std::string strFile = std::move( m_dqFiles.front() );
+        m_dqFiles.pop_front();
+        lock.unlock();
+        if ( !!FileDelete( strFile.c_str() ) )
+          fprintf( stderr, "_SysLogFileRemover: Unable to delete [%s], errno[%d].\n", strFile.c_str(), GetLastErrNo() );
+        lock.lock();
+      }
+      if ( m_fStop )
+        break;
+    }
+  }
+  std::mutex m_mtx;
+  std::condition_variable m_cv;
+  std::deque< std::string > m_dqFiles;
+  std::thread m_thr;
+  bool m_fStop{ false };
+};
+
+// What a thread does when its asynchronous logging ring is full:
+enum _ESysLogOverflowPolicy : uint8_t
+{
+  eslopBlock, // Wait for the overlord thread to make room - no records are lost.
+  eslopDrop,  // Drop the record - the number of records dropped is logged once there is room.
+  eslopSysLogOverflowPolicyCount
+};
+typedef _ESysLogOverflowPolicy ESysLogOverflowPolicy;
+
 // Predeclare:
 namespace n_SysLog
 {
@@ -78,7 +288,7 @@ struct GetProgramStart
   }
   _tyTimePoint m_tpProgramStart;
 };
-typedef JsoValue< char > vtyJsoValueSysLog;
+typedef JsoValue< char, JsoObjectStorageMap, std::allocator< char > > vtyJsoValueSysLog;
 // If <_fIsMainThread> is true, then we are the main thread - before having created other threads - this allows us to set some
 //  globals that will inform the creation of logging objects on other threads.
 void
@@ -88,6 +298,20 @@ InitSysLog( const char * _pszProgramName, int _grfOption, int _grfFacility, cons
 void
 InitSysLog( const char * _pszProgramName, int _grfOption, int _grfFacility, const char * _pszLogDir, const vtyJsoValueSysLog * _pjvThreadSpecificJson = nullptr,
             bool _fIsMainThread = true );
+// Return whether a message of type _eslmt from _pszFile would be logged - the LOGSYSLOG macros check this before evaluating their arguments.
+inline bool
+FSysLogEnabled( ESysLogMessageType _eslmt, const char * _pszFile )
+{
+  ESysLogLevel esll = EsllFromMessageType( _eslmt );
+#if SYSLOG_COMPILEMINLEVEL > 0 // Otherwise every level passes - and the comparison would always be true.
+  if ( esll < SYSLOG_COMPILEMINLEVEL )
+    return false;
+#endif
+  return _SysLogLevelFilter::FEnabled( esll, _pszFile );
+}
+// Return whether a message from the rate limited call site _rsrl may be logged now - this counts the message if not.
+bool
+FSysLogRateAllow( _SysLogRateLimit const & _rsrl );
 // Used for when we are about to abort(), etc. We can only quickly and easily close the current thread's syslog file if there is one.
 void
 CloseThreadSysLog() noexcept( true );
@@ -112,10 +336,40 @@ void
 Log( ESysLogMessageType _eslmtType, vtyJsoValueSysLog const & _rjvLog, int _errno, const char * _pcFile, unsigned int _nLine, const char * _pcFmt, ... );
 } // namespace n_SysLog
 
-#define LOGSYSLOG( TYPE, MESG, ... ) n_SysLog::Log( TYPE, __FILE__, __LINE__, MESG, ##__VA_ARGS__ )
-#define LOGSYSLOGERRNO( TYPE, ERRNO, MESG, ... ) n_SysLog::Log( TYPE, ERRNO, __FILE__, __LINE__, MESG, ##__VA_ARGS__ )
-#define LOGSYSLOG_JSON( TYPE, JSONVALUE, MESG, ... ) n_SysLog::Log( TYPE, JSONVALUE, __FILE__, __LINE__, MESG, ##__VA_ARGS__ )
-#define LOGSYSLOGERRNO_JSON( TYPE, JSONVALUE, ERRNO, MESG, ... ) n_SysLog::Log( TYPE, JSONVALUE, ERRNO, __FILE__, __LINE__, MESG, ##__VA_ARGS__ )
+#define LOGSYSLOG( TYPE, MESG, ... )                                                                                                                   \
+  ( n_SysLog::FSysLogEnabled( TYPE, __FILE__ ) ? n_SysLog::Log( TYPE, __FILE__, __LINE__, MESG, ##__VA_ARGS__ ) : (void)0 )
+#define LOGSYSLOGERRNO( TYPE, ERRNO, MESG, ... )                                                                                                       \
+  ( n_SysLog::FSysLogEnabled( TYPE, __FILE__ ) ? n_SysLog::Log( TYPE, ERRNO, __FILE__, __LINE__, MESG, ##__VA_ARGS__ ) : (void)0 )
+#define LOGSYSLOG_JSON( TYPE, JSONVALUE, MESG, ... )                                                                                                   \
+  ( n_SysLog::FSysLogEnabled( TYPE, __FILE__ ) ? n_SysLog::Log( TYPE, JSONVALUE, __FILE__, __LINE__, MESG, ##__VA_ARGS__ ) : (void)0 )
+#define LOGSYSLOGERRNO_JSON( TYPE, JSONVALUE, ERRNO, MESG, ... )                                                                                       \
+  ( n_SysLog::FSysLogEnabled( TYPE, __FILE__ ) ? n_SysLog::Log( TYPE, JSONVALUE, ERRNO, __FILE__, __LINE__, MESG, ##__VA_ARGS__ ) : (void)0 )
+// Rate limited logging - at most NBURST messages at once from this call site and thread, refilled at NPERSECOND messages per second.
+// The number of messages suppressed is logged with the next message allowed, every so often while suppressing, and when the thread log closes.
+#define _LOGSYSLOG_RATELIMIT( TYPE, NPERSECOND, NBURST )                                                                                               \
+  n_SysLog::FSysLogRateAllow(                                                                                                                          \
+      []( ESysLogMessageType _eslmt, double _dblPerSecond, uint32_t _nBurst ) -> _SysLogRateLimit const & {                                          \
+        static const _SysLogRateLimit s_srlLogSysLog{ __FILE__, __LINE__, _eslmt, _dblPerSecond, _nBurst }; /* Set by the first call. */              \
+        return s_srlLogSysLog;                                                                                                                         \
+      }( TYPE, NPERSECOND, NBURST ) )
+#define LOGSYSLOG_RATELIMITED( TYPE, NPERSECOND, NBURST, MESG, ... )                                                                                  \
+  ( ( n_SysLog::FSysLogEnabled( TYPE, __FILE__ ) && _LOGSYSLOG_RATELIMIT( TYPE, NPERSECOND, NBURST ) )                                                  \
+        ? n_SysLog::Log( TYPE, __FILE__, __LINE__, MESG, ##__VA_ARGS__ )                                                                               \
+        : (void)0 )
+#define LOGSYSLOGERRNO_RATELIMITED( TYPE, NPERSECOND, NBURST, ERRNO, MESG, ... )                                                                      \
+  ( ( n_SysLog::FSysLogEnabled( TYPE, __FILE__ ) && _LOGSYSLOG_RATELIMIT( TYPE, NPERSECOND, NBURST ) )                                                  \
+        ? n_SysLog::Log( TYPE, ERRNO, __FILE__, __LINE__, MESG, ##__VA_ARGS__ )                                                                        \
+        : (void)0 )
+#if SYSLOG_COMPILEMINLEVEL <= 0 // esllTrace
+#define LOGSYSLOG_TRACE( MESG, ... ) LOGSYSLOG( eslmtTrace, MESG, ##__VA_ARGS__ )
+#else
+#define LOGSYSLOG_TRACE( MESG, ... ) ( (void)0 )
+#endif
+#if SYSLOG_COMPILEMINLEVEL <= 1 // esllDebug
+#define LOGSYSLOG_DEBUG( MESG, ... ) LOGSYSLOG( eslmtDebug, MESG, ##__VA_ARGS__ )
+#else
+#define LOGSYSLOG_DEBUG( MESG, ... ) ( (void)0 )
+#endif
 #define LOGEXCEPTION( EXC, MESG, ... ) n_SysLog::LogException( EXC, __FILE__, __LINE__, MESG, ##__VA_ARGS__ )
 
 // _SysLogThreadHeader:
@@ -154,7 +408,7 @@ struct _SysLogThreadHeader
 struct _SysLogContext
 {
   uint64_t m_nmsSinceProgramStart{ 0 };         // easiest way to do this.
-  const JsoValue< char > * m_pjvLog{ nullptr }; // additional JSON to log to the entry.
+  const n_SysLog::vtyJsoValueSysLog * m_pjvLog{ nullptr }; // additional JSON to log to the entry.
   time_t m_time{ 0 };
   std::string m_szFullMesg; // The full annotated message.
   std::string m_szFile;
@@ -186,11 +440,92 @@ template < const int t_kiInstance = 0 > class _SysLogMgr
   typedef _SysLogMgr _tyThis;
 
 protected: // These methods aren't for general consumption. Use the s_SysLog namespace methods.
-  typedef JsonFileOutputStream< JsonCharTraits< char >, char > _tyJsonOutputStream;
+#ifdef SYSLOG_ASYNCJSONLOG // Write the JSON log file on a background thread - log records still in flight are lost on a crash.
+  typedef JsonAsyncFileOutputStream< JsonCharTraits< char >, char > _tyJsonFileOutputStream;
+#else
+  typedef JsonFileOutputStream< JsonCharTraits< char >, char > _tyJsonFileOutputStream;
+#endif
+#if defined( SYSLOG_CBORLOG ) && defined( SYSLOG_BINARYLOG )
+#error SYSLOG_CBORLOG and SYSLOG_BINARYLOG are mutually exclusive.
+#endif
+#ifdef SYSLOG_CBORLOG // Write the log file as CBOR - see jsoncbor.h for reading it and converting it to JSON.
+  typedef CborOutputStream< JsonCharTraits< char >, _tyJsonFileOutputStream > _tyJsonOutputStream;
+#else
+  typedef _tyJsonFileOutputStream _tyJsonOutputStream;
+#endif
   typedef JsonFormatSpec< JsonCharTraits< char > > _tyJsonFormatSpec;
   typedef JsonValueLife< _tyJsonOutputStream > _tyJsonValueLife;
 
+  // A log record in flight to the overlord thread. The additional JSON is copied since the caller's goes away when Log() returns.
+  struct _SysLogRecord
+  {
+    std::string m_strLog;
+    _SysLogContext m_slc;
+    std::unique_ptr< n_SysLog::vtyJsoValueSysLog > m_upjvLog;
+    const _SysLogCallSite * m_pslcs{ nullptr }; // Set for deferred records - m_strLog then holds the captured arguments, m_slc the time.
+    ESysLogMessageType m_eslmt{ eslmtSysLogMessageTypeCount };
+    bool m_fHasContext{ false };
+  };
+  // _SysLogRing:
+  // Bounded single producer/single consumer ring of records. The producer is the logging thread, the consumer the overlord thread -
+  //  or the logging thread itself while holding s_mtxOverlord once the ring has been removed from the overlord or closed by it.
+  class _SysLogRing
+  {
+  public:
+    explicit _SysLogRing( size_t _nRecords )
+        : m_nMask( std::bit_ceil( (std::max)( _nRecords, size_t( 2 ) ) ) - 1 ),
+          m_rgslr( std::make_unique< _SysLogRecord[] >( m_nMask + 1 ) )
+    {
+    }
+    // Return the slot to fill or null if the ring is full.
+    _SysLogRecord * PslrBeginPush()
+    {
+      size_t nTail = m_nTail.load( std::memory_order_relaxed );
+      if ( ( nTail - m_nHead.load( std::memory_order_acquire ) ) > m_nMask )
+        return nullptr;
+      return &m_rgslr[ nTail & m_nMask ];
+    }
+    void EndPush() { m_nTail.store( m_nTail.load( std::memory_order_relaxed ) + 1 ); }
+    // Return the oldest record or null if the ring is empty.
+    _SysLogRecord * PslrFront()
+    {
+      size_t nHead = m_nHead.load( std::memory_order_relaxed );
+      if ( nHead == m_nTail.load() )
+        return nullptr;
+      return &m_rgslr[ nHead & m_nMask ];
+    }
+    void PopFront() { m_nHead.store( m_nHead.load( std::memory_order_relaxed ) + 1, std::memory_order_release ); }
+    bool FEmpty() const { return m_nHead.load( std::memory_order_acquire ) == m_nTail.load(); }
+
+    std::atomic< size_t > m_nDropped{ 0 }; // Records dropped under eslopDrop since the overlord last drained the ring.
+    std::atomic< bool > m_fClosed{ false }; // Set by the overlord when it stops - the producer must then drain the ring itself.
+
+  protected:
+    size_t m_nMask;
+    std::unique_ptr< _SysLogRecord[] > m_rgslr;
+    alignas( 64 ) std::atomic< size_t > m_nHead{ 0 }; // Written by the consumer.
+    alignas( 64 ) std::atomic< size_t > m_nTail{ 0 }; // Written by the producer.
+  };
+
   void Log( ESysLogMessageType _eslmt, std::string && _rrStrLog, const _SysLogContext * _pslc );
+  void _LogSysLog( ESysLogMessageType _eslmt, std::string const & _rstrLog );
+  bool _FLogJSON( const _SysLogContext * _pslc );
+  void _FlushThreadLog();
+  // Rotation:
+  void _OpenThreadLogFile();
+  uint64_t _NbyThreadLogFile() const;
+  void _CheckRotate();
+  void _RotateThreadLogFile( uint64_t _nbyFile );
+  void _CloseThreadLogFile() noexcept( true );
+  bool _FLogDeferred( const _SysLogCallSite & _rslcs, std::string const & _rstrArgs, uint64_t _nmsSinceProgramStart, time_t _time );
+  // Asynchronous logging:
+  bool _FLogAsync( ESysLogMessageType _eslmt, std::string && _rrStrLog, const _SysLogContext * _pslc );
+  template < class t_tyFFillRecord > bool _FPushAsync( t_tyFFillRecord && _rrfFillRecord );
+  bool _FRegisterAsync();
+  void _UnregisterAsync() noexcept( true );
+  size_t _NDrainRing() noexcept( true );
+  static void _OverlordThread();
+  static bool _FAnyRecordsPending();
 
   bool FHasJSONLogFile() const;
   bool FCreateUniqueJSONLogFile( const char * _pszProgramName, const n_SysLog::vtyJsoValueSysLog * _pjvThreadSpecificJson, bool _fIsMainThread,
@@ -276,10 +611,19 @@ public:
     // We don't actually close the SysLogMgr for this thread because we may want to log again and then we would just recreate it.
     // Just close any JSON logfile for this thread so that it is complete as of this call.
     // Also need to ensure that another logfile is not created for this thread.
-    if ( !!s_tls_pThis && s_fGenerateUniqueJSONLogFile )
+    if ( !!s_tls_pThis )
     {
       _SysLogMgr & rslm = _SysLogMgr::RGetThreadSysLogMgr();
-      rslm.CloseSysLogFile();
+      rslm._LogRateLimitSummaries();
+      if ( !!rslm.m_upRing )
+      { // Write any records still in flight - and close the file under the lock so the overlord isn't writing to it.
+        std::lock_guard< std::mutex > lock( s_mtxOverlord );
+        (void)rslm._NDrainRing();
+        if ( s_fGenerateUniqueJSONLogFile )
+          rslm.CloseSysLogFile();
+      }
+      else if ( s_fGenerateUniqueJSONLogFile )
+        rslm.CloseSysLogFile();
     }
   }
   void CloseSysLogFile() noexcept( true );
@@ -287,8 +631,17 @@ public:
   {
     // So the caller has given us some stuff to log and even gave us a string that we get to own.
     _SysLogMgr & rslm = RGetThreadSysLogMgr();
+    if ( !!s_pslmOverlord.load( std::memory_order_acquire ) && rslm._FLogAsync( _eslmt, std::move( _rrStrLog ), _pslc ) )
+      return;
     rslm.Log( _eslmt, std::move( _rrStrLog ), _pslc );
   }
+  // Log with deferred formatting - use LOGSYSLOG_DEFERRED(). Defined in syslogbin.h.
+  template < class... t_tysArgs > static void StaticLogDeferred( const _SysLogCallSite & _rslcs, t_tysArgs const &... _rargs );
+  // Start logging asynchronously - see architecture note (6) above. Call after InitSysLog() on the main thread.
+  // Each thread's ring holds _nRecordsPerThread records (rounded up to a power of two).
+  static void StartAsync( size_t _nRecordsPerThread, ESysLogOverflowPolicy _eslop );
+  // Stop the overlord thread after it has written all records in flight. Threads then log synchronously again.
+  static void StopAsync() noexcept( true );
   static const char * SzMessageType( ESysLogMessageType _eslmt )
   {
     switch ( _eslmt )
@@ -299,6 +652,10 @@ public:
       return "Warning";
     case eslmtError:
       return "Error";
+    case eslmtDebug:
+      return "Debug";
+    case eslmtTrace:
+      return "Trace";
     default:
       return "UknownMesgType";
     }
@@ -312,12 +669,39 @@ public:
     return fCur;
   }
 
+  static bool StaticFRateAllow( _SysLogRateLimit const & _rsrl ) { return RGetThreadSysLogMgr()._FRateAllow( _rsrl ); }
+  // Set how often the count of suppressed messages is logged while a call site is being rate limited.
+  static void SetRateLimitSummaryPeriod( std::chrono::milliseconds _msPeriod ) { s_nmsRateLimitSummary = uint32_t( _msPeriod.count() ); }
+  // See n_SysLog::SetSysLogRotation().
+  static void SetRotation( uint64_t _nbyMaxFile, std::chrono::milliseconds _msMaxAge, size_t _nMaxFiles, uint64_t _nbyMaxTotal )
+  {
+    s_nbyRotateFile = _nbyMaxFile;
+    s_nmsRotateAge = uint64_t( _msMaxAge.count() );
+    s_nRetainFiles = _nMaxFiles;
+    s_nbyRetainTotal = _nbyMaxTotal;
+  }
+  // See n_SysLog::SetSysLogGenerateThreadLogFiles().
+  static void SetGenerateUniqueJSONLogFile( bool _fGenerate ) { s_fGenerateUniqueJSONLogFile = _fGenerate; }
+
   _SysLogMgr( _SysLogMgr * _pslmOverlord );
   ~_SysLogMgr();
 
   static uint64_t _GetMsSinceProgramStart() { return s_psProgramStart.NMillisecondsSinceStart(); }
 
 protected:
+  // The per-thread state of a rate limited call site:
+  struct _SysLogRateBucket
+  {
+    const _SysLogRateLimit * m_psrl{ nullptr }; // Null until first used.
+    double m_dblTokens{ 0 };
+    uint64_t m_nSuppressed{ 0 };
+    std::chrono::steady_clock::time_point m_tpRefill;
+    std::chrono::steady_clock::time_point m_tpSummary; // When the suppressed count was last logged - or the first message.
+  };
+  bool _FRateAllow( _SysLogRateLimit const & _rsrl );
+  void _LogRateSummary( _SysLogRateBucket & _rsrb, std::chrono::steady_clock::time_point _tpNow );
+  void _LogRateLimitSummaries() noexcept( true );
+
   void _SetOptionFacility( int _grfOption, int _grfFacility )
   {
     m_grfOption = _grfOption;
@@ -325,17 +709,47 @@ protected:
   }
   // non-static members:
   _SysLogMgr * m_pslmOverlord; // If this is zero then we are the overlord or there is no overlord.
+  std::unique_ptr< _SysLogRing > m_upRing; // Present while this thread is logging asynchronously.
   std::unique_ptr< _tyJsonOutputStream > m_pjosThreadLog;
   std::unique_ptr< _tyJsonValueLife > m_pjvlRootThreadLog; // The root of the thread log - we may add a footer at end of execution.
   std::unique_ptr< _tyJsonValueLife > m_pjvlSysLogArray;   // The current position within the SysLog diagnostic log message array.
+  std::unique_ptr< _SysLogBinaryFile > m_upsbfThreadLog;  // The thread log under SYSLOG_BINARYLOG - the JSON members above are then unused.
+  std::string m_strDeferredArgs;                           // Scratch for the arguments of synchronous deferred records.
+  std::vector< _SysLogRateBucket > m_rgsrbRateLimits;      // Indexed by _SysLogRateLimit::NId().
+  // The thread log file - kept to open the next file upon rotation:
+  _SysLogThreadHeader m_slthThreadLog;
+  std::unique_ptr< n_SysLog::vtyJsoValueSysLog > m_upjvThreadSpecific;
+  std::string m_strThreadLogBase; // <dir>/<program>.<uuid> - the rotated files append .<n>.
+  std::string m_strThreadLogFile;
+  size_t m_nThreadLogSeq{ 0 };
+  std::chrono::steady_clock::time_point m_tpThreadLogOpened;
+  std::atomic< bool > m_fThreadLogOpen{ false }; // Set while the thread log is open - read by FHasJSONLogFile() on this thread while the overlord rotates.
+  std::deque< std::pair< std::string, uint64_t > > m_dqRotatedFiles; // Closed files of this thread and their sizes, oldest first.
+  uint64_t m_nbyRotatedFiles{ 0 };
   int m_grfOption{ 0 };                                    // Save these here for Windows.
   int m_grfFacility{ 0 };
   bool m_fInAssertOrVerify{
       false }; // We don't want to re-enter Assert() code while processing an assert. As assertions are intimately tied to the SysLogMgr we implement that here.
   // static members:
-  static _SysLogMgr * s_pslmOverlord; // A pointer to the "overlord" _SysLogMgr that is running on its own thread. The lifetime for this is managed by
-                                      // s_tls_pThis for the overlord thread.
-  static std::mutex s_mtxOverlord;    // This used by overlord to guard access.
+  static std::atomic< _SysLogMgr * > s_pslmOverlord; // A pointer to the "overlord" _SysLogMgr that is running on its own thread. The lifetime for this is managed by
+                                                    // s_upOverlord, the overlord thread points its s_tls_pThis at it.
+  static std::mutex s_mtxOverlord; // This used by overlord to guard access - to s_rgpslmAsync and to the rings and JSON files of the threads within it.
+  inline static std::unique_ptr< _SysLogMgr > s_upOverlord;
+  inline static std::thread s_thrOverlord;
+  inline static std::vector< _SysLogMgr * > s_rgpslmAsync; // The threads logging asynchronously.
+  inline static size_t s_nRecordsPerThread = 1024;
+  inline static ESysLogOverflowPolicy s_eslop = eslopBlock;
+  inline static std::atomic< bool > s_fStopOverlord{ false };
+  inline static std::mutex s_mtxWake; // Guards the overlord going to sleep so that a producer's wakeup isn't lost.
+  inline static std::condition_variable s_cvWake;
+  inline static std::atomic< bool > s_fOverlordSleeping{ false };
+  inline static bool s_fStopAsyncAtExit = false;
+  inline static std::atomic< uint32_t > s_nmsRateLimitSummary{ 10000 };
+  inline static std::atomic< uint64_t > s_nbyRotateFile{ 0 };
+  inline static std::atomic< uint64_t > s_nmsRotateAge{ 0 };
+  inline static std::atomic< size_t > s_nRetainFiles{ 0 };
+  inline static std::atomic< uint64_t > s_nbyRetainTotal{ 0 };
+  inline static _SysLogFileRemover s_sfrRemover;
   static thread_local std::unique_ptr< _SysLogMgr > s_tls_upThis; // This object will be created in all threads the first time something logs in that thread.
                                                                   // However the "overlord thread" will create this on purpose when it is created.
   static THREAD_DECL _SysLogMgr * s_tls_pThis;
@@ -349,7 +763,7 @@ protected:
   inline static int s_grfFacility = 0;
 };
 
-template < const int t_kiInstance > _SysLogMgr< t_kiInstance > * _SysLogMgr< t_kiInstance >::s_pslmOverlord = nullptr;
+template < const int t_kiInstance > std::atomic< _SysLogMgr< t_kiInstance > * > _SysLogMgr< t_kiInstance >::s_pslmOverlord{ nullptr };
 template < const int t_kiInstance > std::mutex _SysLogMgr< t_kiInstance >::s_mtxOverlord;
 template < const int t_kiInstance > thread_local std::unique_ptr< _SysLogMgr< t_kiInstance > > _SysLogMgr< t_kiInstance >::s_tls_upThis;
 template < const int t_kiInstance > THREAD_DECL _SysLogMgr< t_kiInstance > * _SysLogMgr< t_kiInstance >::s_tls_pThis = 0;
@@ -383,6 +797,70 @@ FSetInAssertOrVerify( bool _fInAssertOrVerify )
 {
   return SysLogMgr::FStaticSetInAssertOrVerify( _fInAssertOrVerify );
 }
+// Log asynchronously from here on - see _SysLogMgr::StartAsync().
+inline void
+StartAsyncSysLog( size_t _nRecordsPerThread = 1024, ESysLogOverflowPolicy _eslop = eslopBlock )
+{
+  SysLogMgr::StartAsync( _nRecordsPerThread, _eslop );
+}
+inline void
+StopAsyncSysLog() noexcept( true )
+{
+  SysLogMgr::StopAsync();
+}
+inline bool
+FSysLogRateAllow( _SysLogRateLimit const & _rsrl )
+{
+  return SysLogMgr::StaticFRateAllow( _rsrl );
+}
+inline void
+SetSysLogRateLimitSummaryPeriod( std::chrono::milliseconds _msPeriod )
+{
+  SysLogMgr::SetRateLimitSummaryPeriod( _msPeriod );
+}
+// Rotate each thread's log file once it reaches _nbyMaxFile bytes or has been open for _msMaxAge - zero disables either. Logging continues in
+//  <program>.<uuid>.<n>.log.json which begins with the same SysLogThreadHeader. Of each thread's files at most _nMaxFiles - counting the current
+//  file - and _nbyMaxTotal bytes of closed files are kept, zero being no limit. Older files are deleted on a background thread.
+// Asynchronously the overlord thread rotates the files, otherwise the logging thread does when it logs.
+inline void
+SetSysLogRotation( uint64_t _nbyMaxFile, std::chrono::milliseconds _msMaxAge, size_t _nMaxFiles = 0, uint64_t _nbyMaxTotal = 0 )
+{
+  SysLogMgr::SetRotation( _nbyMaxFile, _msMaxAge, _nMaxFiles, _nbyMaxTotal );
+}
+// Whether each thread creates its own JSON log file - true by default. Call before InitSysLog() - e.g. with false for a tool whose only log is the syslog.
+inline void
+SetSysLogGenerateThreadLogFiles( bool _fGenerate )
+{
+  SysLogMgr::SetGenerateUniqueJSONLogFile( _fGenerate );
+}
+// Levels - see _SysLogLevelFilter. The threshold is esllInfo until set.
+inline ESysLogLevel
+EsllGetSysLogLevel()
+{
+  return _SysLogLevelFilter::EsllGetThreshold();
+}
+inline void
+SetSysLogLevel( ESysLogLevel _esll )
+{
+  _SysLogLevelFilter::SetThreshold( _esll );
+}
+inline void
+SetSysLogLevelOverride( const char * _pszFileOrModule, ESysLogLevel _esll )
+{
+  _SysLogLevelFilter::SetOverride( _pszFileOrModule, _esll );
+}
+inline void
+RemoveSysLogLevelOverride( const char * _pszFileOrModule )
+{
+  _SysLogLevelFilter::RemoveOverride( _pszFileOrModule );
+}
+// Set the threshold and replace all overrides from a specification such as "warning,net/=debug,socket.cpp=trace" - e.g. read from the
+//  environment or a configuration file upon SIGHUP. Level names are trace, debug, info, warning, error and off.
+inline void
+SetSysLogLevels( const char * _pszLevels )
+{
+  _SysLogLevelFilter::SetLevels( _pszLevels );
+}
 void
 Log( ESysLogMessageType _eslmtType, const char * _pcFmt, ... );
 void
@@ -12,6 +12,10 @@
 #include "syslogmgr.h"
 #include "_strutil.h"
 #include "jsonobjs.h"
+#include "syslogbin.h"
+#ifdef SYSLOG_CBORLOG
+#include "jsoncbor.h"
+#endif
 #include "_heapchk.h"
 
 __BIENUTIL_BEGIN_NAMESPACE
@@ -615,7 +619,12 @@ _SysLogMgr< t_kiInstance >::_SysLogMgr( _SysLogMgr * _pslmOverlord )
   : m_pslmOverlord( _pslmOverlord ) // if !m_pslmOverlord then we are the overlord!!! - or there is no overlord.
 {
 }
-template < const int t_kiInstance > _SysLogMgr< t_kiInstance >::~_SysLogMgr() { CloseSysLogFile(); }
+template < const int t_kiInstance > _SysLogMgr< t_kiInstance >::~_SysLogMgr()
+{
+  _LogRateLimitSummaries();
+  _UnregisterAsync();
+  CloseSysLogFile();
+}
 
 template < const int t_kiInstance >
 bool
@@ -670,8 +679,50 @@ _SysLogMgr< t_kiInstance >::_FTryCreateUniqueJSONLogFile( const char * _pszProgr
   UUIDToString( slth.m_uuid, uusUuid, sizeof uusUuid );
   strLogFile += ".";
   strLogFile += uusUuid;
+
+  m_slthThreadLog = slth;
+  m_upjvThreadSpecific.reset();
+  if ( _pjvThreadSpecificJson )
+    m_upjvThreadSpecific = std::make_unique< n_SysLog::vtyJsoValueSysLog >( *_pjvThreadSpecificJson );
+  m_strThreadLogBase.swap( strLogFile );
+  m_nThreadLogSeq = 0;
+  _OpenThreadLogFile();
+#ifdef SYSLOG_BINARYLOG
+  n_SysLog::Log( eslmtInfo, "SysLogMgr: Created thread-specific binary log file at [%s].", m_strThreadLogFile.c_str() );
+#else
+  n_SysLog::Log( eslmtInfo, "SysLogMgr: Created thread-specific JSON log file at [%s].", m_strThreadLogFile.c_str() );
+#endif
+  return true;
+}
+
+// Open the thread log file m_nThreadLogSeq and write its header.
+template < const int t_kiInstance >
+void
+_SysLogMgr< t_kiInstance >::_OpenThreadLogFile()
+{
+  std::string strLogFile = m_strThreadLogBase;
+  if ( !!m_nThreadLogSeq )
+  {
+    strLogFile += ".";
+    strLogFile += std::to_string( m_nThreadLogSeq );
+  }
+#ifdef SYSLOG_CBORLOG
+  strLogFile += ".log.cbor";
+#elif defined( SYSLOG_BINARYLOG )
+  strLogFile += ".log.bin";
+#else
   strLogFile += ".log.json";
+#endif
 
+#ifdef SYSLOG_BINARYLOG
+  { // B
+    std::unique_ptr< _SysLogBinaryFile > upsbfThreadLog = std::make_unique< _SysLogBinaryFile >();
+    upsbfThreadLog->Open( strLogFile.c_str() );
+    upsbfThreadLog->WriteThreadHeader( m_slthThreadLog, m_upjvThreadSpecific.get() );
+    upsbfThreadLog->Flush();
+    m_upsbfThreadLog.swap( upsbfThreadLog );
+  } // EB
+#else  //!SYSLOG_BINARYLOG
   // We must make sure we can initialize the file before we declare that it is opened.
   std::unique_ptr< _tyJsonOutputStream > pjosThreadLog;
   pjosThreadLog = std::make_unique< _tyJsonOutputStream >();
@@ -683,11 +734,11 @@ _SysLogMgr< t_kiInstance >::_FTryCreateUniqueJSONLogFile( const char * _pszProgr
   { // B
     // Create the SysLogThreadHeader object as the first object within the log file.
     _tyJsonValueLife jvlSysLogThreadHeader( *pjvlRoot, "SysLogThreadHeader", ejvtObject );
-    slth.ToJSONStream( jvlSysLogThreadHeader );
-    if ( _pjvThreadSpecificJson ) // write any thread-specific JSON data to the log header.
+    m_slthThreadLog.ToJSONStream( jvlSysLogThreadHeader );
+    if ( !!m_upjvThreadSpecific ) // write any thread-specific JSON data to the log header.
     {
-      _tyJsonValueLife jvlThreadSpec( jvlSysLogThreadHeader, "ThreadSpecificData", _pjvThreadSpecificJson->JvtGetValueType() );
-      _pjvThreadSpecificJson->ToJSONStream( jvlThreadSpec );
+      _tyJsonValueLife jvlThreadSpec( jvlSysLogThreadHeader, "ThreadSpecificData", m_upjvThreadSpecific->JvtGetValueType() );
+      m_upjvThreadSpecific->ToJSONStream( jvlThreadSpec );
     }
   } // EB
   // Now open up an array to contain the set of log message details.
@@ -696,13 +747,91 @@ _SysLogMgr< t_kiInstance >::_FTryCreateUniqueJSONLogFile( const char * _pszProgr
   m_pjosThreadLog.swap( pjosThreadLog );
   m_pjvlRootThreadLog.swap( pjvlRoot );
   m_pjvlSysLogArray.swap( pjvlSysLogArray );
-  n_SysLog::Log( eslmtInfo, "SysLogMgr: Created thread-specific JSON log file at [%s].", strLogFile.c_str() );
-  return true;
+#endif //!SYSLOG_BINARYLOG
+  m_strThreadLogFile.swap( strLogFile );
+  m_tpThreadLogOpened = std::chrono::steady_clock::now();
+  m_fThreadLogOpen.store( true, std::memory_order_release );
+}
+
+template < const int t_kiInstance >
+uint64_t
+_SysLogMgr< t_kiInstance >::_NbyThreadLogFile() const
+{
+  if ( !!m_upsbfThreadLog )
+    return m_upsbfThreadLog->StGetBytesWritten();
+  return m_pjosThreadLog->StGetBytesWritten();
+}
+
+// Rotate the thread log file if it has reached the size or age set by SetRotation(). Call only between records.
+template < const int t_kiInstance >
+void
+_SysLogMgr< t_kiInstance >::_CheckRotate()
+{
+  uint64_t nbyRotateFile = s_nbyRotateFile.load( std::memory_order_relaxed );
+  uint64_t nmsRotateAge = s_nmsRotateAge.load( std::memory_order_relaxed );
+  if ( ( !nbyRotateFile && !nmsRotateAge ) || !FHasJSONLogFile() )
+    return;
+  uint64_t nbyFile = _NbyThreadLogFile();
+  if ( ( !nbyRotateFile || ( nbyFile < nbyRotateFile ) ) &&
+       ( !nmsRotateAge || ( ( std::chrono::steady_clock::now() - m_tpThreadLogOpened ) < std::chrono::milliseconds( nmsRotateAge ) ) ) )
+    return;
+  _RotateThreadLogFile( nbyFile );
+}
+
+// Close the current file - writing its footer - and continue in the next. Then hand the files beyond those retained to the remover thread.
+template < const int t_kiInstance >
+void
+_SysLogMgr< t_kiInstance >::_RotateThreadLogFile( uint64_t _nbyFile )
+{
+  std::string strPrevFile = m_strThreadLogFile;
+  _CloseThreadLogFile(); // Leave m_fThreadLogOpen set so that records logged meanwhile keep their context.
+  m_dqRotatedFiles.emplace_back( strPrevFile, _nbyFile );
+  m_nbyRotatedFiles += _nbyFile;
+  try
+  {
+    ++m_nThreadLogSeq;
+    _OpenThreadLogFile();
+  }
+  catch ( std::exception const & rexc )
+  { // Continue logging to the syslog only - as when the first file cannot be created.
+    m_fThreadLogOpen.store( false, std::memory_order_release );
+    std::string strLog;
+    PrintfStdStr( strLog, "<%s>: SysLogMgr: Unable to rotate thread log file [%s]: %s", SzMessageType( eslmtError ), strPrevFile.c_str(), rexc.what() );
+    _LogSysLog( eslmtError, strLog );
+  }
+  size_t nRetainFiles = s_nRetainFiles.load( std::memory_order_relaxed );
+  uint64_t nbyRetainTotal = s_nbyRetainTotal.load( std::memory_order_relaxed );
+  while ( !m_dqRotatedFiles.empty() && ( ( !!nRetainFiles && ( m_dqRotatedFiles.size() + 1 > nRetainFiles ) ) ||
+                                         ( !!nbyRetainTotal && ( m_nbyRotatedFiles > nbyRetainTotal ) ) ) )
+  {
+    m_nbyRotatedFiles -= m_dqRotatedFiles.front().second;
+    s_sfrRemover.Remove( std::move( m_dqRotatedFiles.front().first ) );
+    m_dqRotatedFiles.pop_front();
+  }
+  if ( FHasJSONLogFile() )
+  { // Note where this file continues from - this isn't sent to the syslog.
+    _SysLogContext slc;
+    PrintfStdStr( slc.m_szFullMesg, "<%s>: SysLogMgr: Rotated thread log file, continuing from [%s].", SzMessageType( eslmtInfo ), strPrevFile.c_str() );
+    slc.m_eslmtType = eslmtInfo;
+    slc.m_time = time( 0 );
+    slc.m_nmsSinceProgramStart = _GetMsSinceProgramStart();
+    (void)_FLogJSON( &slc );
+  }
 }
 
 template < const int t_kiInstance >
 void
 _SysLogMgr< t_kiInstance >::Log( ESysLogMessageType _eslmt, std::string && _rrStrLog, const _SysLogContext * _pslc )
+{
+  _LogSysLog( _eslmt, _rrStrLog );
+  // The stream coalesces the many small writes for the record - flush once per record so that the log is current should we crash.
+  if ( _FLogJSON( _pslc ) )
+    _FlushThreadLog();
+}
+
+template < const int t_kiInstance >
+void
+_SysLogMgr< t_kiInstance >::_LogSysLog( ESysLogMessageType _eslmt, std::string const & _rstrLog )
 {
 #ifndef WIN32
   int iPriority;
@@ -719,6 +848,10 @@ _SysLogMgr< t_kiInstance >::Log( ESysLogMessageType _eslmt, std::string && _rrSt
   case eslmtWarning:
     iPriority = LOG_WARNING;
     break;
+  case eslmtDebug:
+  case eslmtTrace:
+    iPriority = LOG_DEBUG;
+    break;
   default:
     Assert( 0 );
   case eslmtError:
@@ -728,37 +861,333 @@ _SysLogMgr< t_kiInstance >::Log( ESysLogMessageType _eslmt, std::string && _rrSt
   iPriority |= LOG_USER;
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wformat-security"
-  // First log.
-  syslog( iPriority, _rrStrLog.c_str() );
+  syslog( iPriority, _rstrLog.c_str() );
 #pragma GCC diagnostic pop
 #else  // WIN32
   if ( m_grfOption & LOG_PERROR )
   {
-    fprintf( stderr, "%s\n", _rrStrLog.c_str() );
+    fprintf( stderr, "%s\n", _rstrLog.c_str() );
   }
 #endif // WIN32
+}
 
-  // Then log the context to thread logging file.
+// Log the context to thread logging file. Return true if the record was written - the caller is responsible for flushing.
+template < const int t_kiInstance >
+bool
+_SysLogMgr< t_kiInstance >::_FLogJSON( const _SysLogContext * _pslc )
+{
   if ( !!_pslc && !!m_pjosThreadLog && m_pjosThreadLog->FOpened() && !!m_pjvlRootThreadLog && !!m_pjvlSysLogArray )
   {
     // Create an object for this log message:
     _tyJsonValueLife jvlSysLogContext( *m_pjvlSysLogArray, ejvtObject );
     _pslc->ToJSONStream( jvlSysLogContext );
+    return true;
+  }
+  if ( !!_pslc && !!m_upsbfThreadLog && m_upsbfThreadLog->FOpened() )
+  {
+    m_upsbfThreadLog->WriteContext( *_pslc );
+    return true;
+  }
+  return false;
+}
+
+template < const int t_kiInstance >
+void
+_SysLogMgr< t_kiInstance >::_FlushThreadLog()
+{
+  if ( !!m_upsbfThreadLog )
+    m_upsbfThreadLog->Flush();
+  else
+    m_pjosThreadLog->Flush();
+  _CheckRotate();
+}
+
+// Log a deferred record synchronously - the arguments were captured by _SysLogArgs. Return true if the thread log should be flushed.
+// Under SYSLOG_BINARYLOG the record is written as is and only errors are formatted - for the syslog.
+template < const int t_kiInstance >
+bool
+_SysLogMgr< t_kiInstance >::_FLogDeferred( const _SysLogCallSite & _rslcs, std::string const & _rstrArgs, uint64_t _nmsSinceProgramStart, time_t _time )
+{
+  if ( !!m_upsbfThreadLog && m_upsbfThreadLog->FOpened() )
+  {
+    m_upsbfThreadLog->WriteDeferred( _rslcs, _nmsSinceProgramStart, _time, [&_rstrArgs]( std::string & _rstr ) { _rstr += _rstrArgs; } );
+    if ( eslmtError != _rslcs.m_eslmtType )
+      return m_upsbfThreadLog->FShouldFlush();
+    std::string strLog;
+    n_SysLog::FormatDeferred( _rslcs.m_eslmtType, _rslcs.m_pszFmt, _rslcs.m_pszFile, _rslcs.m_nLine, _rstrArgs.data(), _rstrArgs.length(), strLog );
+    _LogSysLog( eslmtError, strLog );
+    return true;
   }
+  _SysLogContext slc;
+  n_SysLog::FormatDeferred( _rslcs.m_eslmtType, _rslcs.m_pszFmt, _rslcs.m_pszFile, _rslcs.m_nLine, _rstrArgs.data(), _rstrArgs.length(), slc.m_szFullMesg );
+  _LogSysLog( _rslcs.m_eslmtType, slc.m_szFullMesg );
+  if ( !FHasJSONLogFile() )
+    return false;
+  slc.m_eslmtType = _rslcs.m_eslmtType;
+  slc.m_time = _time;
+  slc.m_nmsSinceProgramStart = _nmsSinceProgramStart;
+  slc.m_szFile = _rslcs.m_pszFile;
+  slc.m_nLine = int( _rslcs.m_nLine );
+  return _FLogJSON( &slc );
+}
+
+// Push the record onto this thread's ring. Return false if the record must be logged synchronously.
+template < const int t_kiInstance >
+bool
+_SysLogMgr< t_kiInstance >::_FLogAsync( ESysLogMessageType _eslmt, std::string && _rrStrLog, const _SysLogContext * _pslc )
+{
+  return _FPushAsync(
+      [&]( _SysLogRecord & _rslr )
+      {
+        _rslr.m_eslmt = _eslmt;
+        _rslr.m_pslcs = nullptr;
+        _rslr.m_strLog = std::move( _rrStrLog );
+        _rslr.m_fHasContext = !!_pslc;
+        if ( !!_pslc )
+        {
+          _rslr.m_slc = *_pslc;
+          if ( !!_pslc->m_pjvLog )
+          {
+            _rslr.m_upjvLog = std::make_unique< n_SysLog::vtyJsoValueSysLog >( *_pslc->m_pjvLog );
+            _rslr.m_slc.m_pjvLog = &*_rslr.m_upjvLog;
+          }
+        }
+      } );
+}
+
+// Push a record filled in by _rrfFillRecord( _SysLogRecord & ) onto this thread's ring. Return false if the record must be logged synchronously.
+template < const int t_kiInstance >
+template < class t_tyFFillRecord >
+bool
+_SysLogMgr< t_kiInstance >::_FPushAsync( t_tyFFillRecord && _rrfFillRecord )
+{
+  if ( this == s_pslmOverlord.load( std::memory_order_relaxed ) )
+    return false; // The overlord logs synchronously - it would otherwise wait on itself.
+  if ( !m_upRing && !_FRegisterAsync() )
+    return false;
+  _SysLogRecord * pslr;
+  while ( !( pslr = m_upRing->PslrBeginPush() ) )
+  {
+    if ( m_upRing->m_fClosed.load() )
+      break;
+    if ( eslopDrop == s_eslop )
+    {
+      ++m_upRing->m_nDropped;
+      return true;
+    }
+    if ( s_fOverlordSleeping.load() )
+    {
+      std::lock_guard< std::mutex > lock( s_mtxWake );
+      s_cvWake.notify_one();
+    }
+    std::this_thread::yield();
+  }
+  if ( !!pslr )
+  {
+    std::forward< t_tyFFillRecord >( _rrfFillRecord )( *pslr );
+    m_upRing->EndPush();
+    if ( s_fOverlordSleeping.load() )
+    {
+      std::lock_guard< std::mutex > lock( s_mtxWake );
+      s_cvWake.notify_one();
+    }
+  }
+  if ( m_upRing->m_fClosed.load() )
+  { // The overlord has stopped - it may not have seen our record. Write what remains ourselves and log synchronously from here on.
+    std::lock_guard< std::mutex > lock( s_mtxOverlord );
+    (void)_NDrainRing();
+    m_upRing.reset();
+    if ( !pslr )
+      return false;
+  }
+  return true;
+}
+
+template < const int t_kiInstance >
+bool
+_SysLogMgr< t_kiInstance >::_FRegisterAsync()
+{
+  std::lock_guard< std::mutex > lock( s_mtxOverlord );
+  if ( !s_pslmOverlord.load() || s_fStopOverlord.load() )
+    return false;
+  m_upRing = std::make_unique< _SysLogRing >( s_nRecordsPerThread );
+  s_rgpslmAsync.push_back( this );
+  return true;
+}
+
+// Remove this thread from the overlord and write the records that remain in its ring.
+template < const int t_kiInstance >
+void
+_SysLogMgr< t_kiInstance >::_UnregisterAsync() noexcept( true )
+{
+  if ( !m_upRing )
+    return;
+  std::lock_guard< std::mutex > lock( s_mtxOverlord );
+  typename std::vector< _SysLogMgr * >::iterator it = std::find( s_rgpslmAsync.begin(), s_rgpslmAsync.end(), this );
+  if ( s_rgpslmAsync.end() != it )
+    s_rgpslmAsync.erase( it );
+  (void)_NDrainRing();
+  m_upRing.reset();
+}
+
+// Write all records in this thread's ring. The caller must hold s_mtxOverlord. Returns the number of records written.
+template < const int t_kiInstance >
+size_t
+_SysLogMgr< t_kiInstance >::_NDrainRing() noexcept( true )
+{
+  size_t nRecords = 0;
+  bool fWroteJSON = false;
+  // The size limit is checked after each record - else a full ring would overshoot it. Age is checked when we flush below.
+  uint64_t nbyRotateFile = s_nbyRotateFile.load( std::memory_order_relaxed );
+  try
+  {
+    for ( _SysLogRecord * pslr; !!( pslr = m_upRing->PslrFront() ); ++nRecords )
+    {
+      if ( !!nbyRotateFile && FHasJSONLogFile() && ( _NbyThreadLogFile() >= nbyRotateFile ) )
+      {
+        _FlushThreadLog(); // This rotates.
+        fWroteJSON = false;
+      }
+      if ( !!pslr->m_pslcs )
+        fWroteJSON = _FLogDeferred( *pslr->m_pslcs, pslr->m_strLog, pslr->m_slc.m_nmsSinceProgramStart, pslr->m_slc.m_time ) || fWroteJSON;
+      else
+      {
+        _LogSysLog( pslr->m_eslmt, pslr->m_strLog );
+        fWroteJSON = _FLogJSON( pslr->m_fHasContext ? &pslr->m_slc : nullptr ) || fWroteJSON;
+      }
+      pslr->m_upjvLog.reset();
+      m_upRing->PopFront();
+    }
+    size_t nDropped = m_upRing->m_nDropped.exchange( 0 );
+    if ( !!nDropped )
+    {
+      _SysLogContext slc;
+      PrintfStdStr( slc.m_szFullMesg, "<%s>: SysLogMgr: Dropped [%zu] log records - the asynchronous logging ring was full.", SzMessageType( eslmtWarning ), nDropped );
+      slc.m_eslmtType = eslmtWarning;
+      slc.m_time = time( 0 );
+      slc.m_nmsSinceProgramStart = _GetMsSinceProgramStart();
+      _LogSysLog( eslmtWarning, slc.m_szFullMesg );
+      fWroteJSON = _FLogJSON( &slc ) || fWroteJSON;
+    }
+    if ( fWroteJSON )
+      _FlushThreadLog();
+  }
+  catch ( std::exception const & rexc )
+  {
+    fprintf( stderr, "_SysLogMgr::_NDrainRing(): Caught exception [%s].\n", rexc.what() );
+  }
+  return nRecords;
+}
+
+template < const int t_kiInstance >
+bool
+_SysLogMgr< t_kiInstance >::_FAnyRecordsPending()
+{
+  std::lock_guard< std::mutex > lock( s_mtxOverlord );
+  for ( _SysLogMgr * pslm : s_rgpslmAsync )
+  {
+    if ( !pslm->m_upRing->FEmpty() || !!pslm->m_upRing->m_nDropped.load() )
+      return true;
+  }
+  return false;
+}
+
+template < const int t_kiInstance >
+void
+_SysLogMgr< t_kiInstance >::_OverlordThread()
+{
+  // Logging by the overlord itself is synchronous and goes only to the syslog.
+  s_tls_pThis = s_pslmOverlord.load();
+  (void)ThreadGetId( s_tls_tidThreadId );
+  for ( ;; )
+  {
+    bool fStop = s_fStopOverlord.load(); // Read before draining so that the final pass sees everything pushed before StopAsync().
+    size_t nRecords = 0;
+    { // B
+      std::lock_guard< std::mutex > lock( s_mtxOverlord );
+      for ( _SysLogMgr * pslm : s_rgpslmAsync )
+        nRecords += pslm->_NDrainRing();
+    } // EB
+    if ( fStop )
+      break;
+    if ( !nRecords )
+    {
+      std::unique_lock< std::mutex > lockWake( s_mtxWake );
+      s_fOverlordSleeping = true;
+      // A producer either sees that we are sleeping and wakes us or we see its record here. The timeout covers dropped record counts.
+      if ( !s_fStopOverlord.load() && !_FAnyRecordsPending() )
+        s_cvWake.wait_for( lockWake, std::chrono::milliseconds( 100 ) );
+      s_fOverlordSleeping = false;
+    }
+  }
+  // Close the rings - the producers write anything they push after this themselves.
+  std::lock_guard< std::mutex > lock( s_mtxOverlord );
+  for ( _SysLogMgr * pslm : s_rgpslmAsync )
+  {
+    pslm->m_upRing->m_fClosed = true;
+    (void)pslm->_NDrainRing();
+  }
+  s_rgpslmAsync.clear();
+  s_tls_pThis = nullptr;
+}
+
+template < const int t_kiInstance >
+void
+_SysLogMgr< t_kiInstance >::StartAsync( size_t _nRecordsPerThread, ESysLogOverflowPolicy _eslop )
+{
+  VerifyThrowSz( _eslop < eslopSysLogOverflowPolicyCount, "Invalid ESysLogOverflowPolicy[%d].", int( _eslop ) );
+  if ( !!s_pslmOverlord.load() )
+    return;
+  s_nRecordsPerThread = _nRecordsPerThread;
+  s_eslop = _eslop;
+  s_fStopOverlord = false;
+  s_upOverlord = std::make_unique< _SysLogMgr >( nullptr );
+  s_upOverlord->_SetOptionFacility( s_grfOption, s_grfFacility );
+  s_pslmOverlord = &*s_upOverlord;
+  s_thrOverlord = std::thread( &_SysLogMgr::_OverlordThread );
+  if ( !s_fStopAsyncAtExit )
+  {
+    s_fStopAsyncAtExit = true;
+    atexit( []() { StopAsync(); } ); // Runs before our statics are destroyed since it is registered after they are constructed.
+  }
+}
+
+template < const int t_kiInstance >
+void
+_SysLogMgr< t_kiInstance >::StopAsync() noexcept( true )
+{
+  if ( !s_pslmOverlord.load() )
+    return;
+  s_fStopOverlord = true;
+  { // B
+    std::lock_guard< std::mutex > lock( s_mtxWake );
+    s_cvWake.notify_one();
+  } // EB
+  if ( s_thrOverlord.joinable() )
+    s_thrOverlord.join();
+  s_pslmOverlord = nullptr;
+  s_upOverlord.reset();
 }
 
 template < const int t_kiInstance >
 bool
 _SysLogMgr< t_kiInstance >::FHasJSONLogFile() const
 {
-  Assert( ( !!m_pjosThreadLog && m_pjosThreadLog->FOpened() ) == !!m_pjvlRootThreadLog );
-  Assert( ( !!m_pjosThreadLog && m_pjosThreadLog->FOpened() ) == !!m_pjvlSysLogArray );
-  return !!m_pjosThreadLog && m_pjosThreadLog->FOpened();
+  // Read the flag rather than the streams - the overlord may be rotating them while this thread logs asynchronously.
+  return m_fThreadLogOpen.load( std::memory_order_acquire );
 }
 
 template < const int t_kiInstance >
 void
 _SysLogMgr< t_kiInstance >::CloseSysLogFile() noexcept( true )
+{
+  m_fThreadLogOpen.store( false, std::memory_order_release );
+  _CloseThreadLogFile();
+}
+
+template < const int t_kiInstance >
+void
+_SysLogMgr< t_kiInstance >::_CloseThreadLogFile() noexcept( true )
 {
   // To close merely release each unique_ptr in the same order the object would be destructed:
   try
@@ -782,6 +1211,245 @@ _SysLogMgr< t_kiInstance >::CloseSysLogFile() noexcept( true )
   catch ( ... )
   {
   }
+  m_upsbfThreadLog.reset(); // noexcept.
+}
+
+// Take a token from this thread's bucket for the call site. Without a token the message is counted instead - and the count is logged when a
+//  message is next allowed or s_nmsRateLimitSummary after it was last logged.
+template < const int t_kiInstance >
+bool
+_SysLogMgr< t_kiInstance >::_FRateAllow( _SysLogRateLimit const & _rsrl )
+{
+  uint32_t nId = _rsrl.NId();
+  if ( m_rgsrbRateLimits.size() <= nId )
+    m_rgsrbRateLimits.resize( nId + 1 );
+  _SysLogRateBucket & rsrb = m_rgsrbRateLimits[ nId ];
+  std::chrono::steady_clock::time_point tpNow = std::chrono::steady_clock::now();
+  if ( !rsrb.m_psrl )
+  {
+    rsrb.m_psrl = &_rsrl;
+    rsrb.m_dblTokens = _rsrl.m_nBurst;
+    rsrb.m_tpSummary = tpNow;
+  }
+  else
+  {
+    double dblSeconds = std::chrono::duration< double >( tpNow - rsrb.m_tpRefill ).count();
+    rsrb.m_dblTokens = (std::min)( double( _rsrl.m_nBurst ), rsrb.m_dblTokens + dblSeconds * _rsrl.m_dblPerSecond );
+  }
+  rsrb.m_tpRefill = tpNow;
+  if ( rsrb.m_dblTokens >= 1.0 )
+  {
+    rsrb.m_dblTokens -= 1.0;
+    if ( !!rsrb.m_nSuppressed )
+      _LogRateSummary( rsrb, tpNow );
+    return true;
+  }
+  ++rsrb.m_nSuppressed;
+  if ( ( tpNow - rsrb.m_tpSummary ) >= std::chrono::milliseconds( s_nmsRateLimitSummary.load( std::memory_order_relaxed ) ) )
+    _LogRateSummary( rsrb, tpNow );
+  return false;
+}
+
+template < const int t_kiInstance >
+void
+_SysLogMgr< t_kiInstance >::_LogRateSummary( _SysLogRateBucket & _rsrb, std::chrono::steady_clock::time_point _tpNow )
+{
+  uint64_t nSuppressed = _rsrb.m_nSuppressed;
+  uint64_t nmsSince = std::chrono::duration_cast< std::chrono::milliseconds >( _tpNow - _rsrb.m_tpSummary ).count();
+  _rsrb.m_nSuppressed = 0;
+  _rsrb.m_tpSummary = _tpNow;
+  const _SysLogRateLimit & rsrl = *_rsrb.m_psrl;
+  n_SysLog::Log( rsrl.m_eslmtType, rsrl.m_pszFile, rsrl.m_nLine, "SysLogMgr: Suppressed [%llu] similar messages in the last [%llu] ms.",
+                 (unsigned long long)nSuppressed, (unsigned long long)nmsSince );
+}
+
+// Log the counts still pending for this thread - before its log file closes.
+template < const int t_kiInstance >
+void
+_SysLogMgr< t_kiInstance >::_LogRateLimitSummaries() noexcept( true )
+{
+  try
+  {
+    std::chrono::steady_clock::time_point tpNow = std::chrono::steady_clock::now();
+    for ( _SysLogRateBucket & rsrb : m_rgsrbRateLimits )
+    {
+      if ( !!rsrb.m_nSuppressed )
+        _LogRateSummary( rsrb, tpNow );
+    }
+  }
+  catch ( std::exception const & rexc )
+  {
+    fprintf( stderr, "_SysLogMgr::_LogRateLimitSummaries(): Caught exception [%s].\n", rexc.what() );
+  }
+}
+
+inline ESysLogLevel
+_SysLogLevelFilter::EsllGetThreshold()
+{
+  std::lock_guard< std::mutex > lock( s_mtxOverrides );
+  return s_esllThreshold;
+}
+inline void
+_SysLogLevelFilter::SetThreshold( ESysLogLevel _esll )
+{
+  VerifyThrowSz( _esll < esllSysLogLevelCount, "Invalid ESysLogLevel[%d].", int( _esll ) );
+  std::lock_guard< std::mutex > lock( s_mtxOverrides );
+  s_esllThreshold = _esll;
+  _UpdateLevelRange();
+}
+inline void
+_SysLogLevelFilter::SetOverride( const char * _pszFileOrModule, ESysLogLevel _esll )
+{
+  VerifyThrowSz( !!_pszFileOrModule && !!*_pszFileOrModule, "Empty file or module name." );
+  VerifyThrowSz( _esll < esllSysLogLevelCount, "Invalid ESysLogLevel[%d].", int( _esll ) );
+  std::lock_guard< std::mutex > lock( s_mtxOverrides );
+  _tyRgOverrides::iterator it = std::find_if( s_rgOverrides.begin(), s_rgOverrides.end(), [_pszFileOrModule]( auto const & _rpr ) { return _rpr.first == _pszFileOrModule; } );
+  if ( s_rgOverrides.end() == it )
+    s_rgOverrides.emplace_back( _pszFileOrModule, _esll );
+  else
+    it->second = _esll;
+  _UpdateLevelRange();
+}
+inline void
+_SysLogLevelFilter::RemoveOverride( const char * _pszFileOrModule )
+{
+  std::lock_guard< std::mutex > lock( s_mtxOverrides );
+  _tyRgOverrides::iterator it = std::find_if( s_rgOverrides.begin(), s_rgOverrides.end(), [_pszFileOrModule]( auto const & _rpr ) { return _rpr.first == _pszFileOrModule; } );
+  if ( s_rgOverrides.end() != it )
+  {
+    s_rgOverrides.erase( it );
+    _UpdateLevelRange();
+  }
+}
+inline void
+_SysLogLevelFilter::ClearOverrides()
+{
+  std::lock_guard< std::mutex > lock( s_mtxOverrides );
+  s_rgOverrides.clear();
+  _UpdateLevelRange();
+}
+inline ESysLogLevel
+_SysLogLevelFilter::EsllFromName( const char * _pcName, size_t _stLen )
+{
+  static constexpr const char * s_krgpszNames[] = { "trace", "debug", "info", "warning", "error", "off" };
+  static_assert( std::size( s_krgpszNames ) == esllSysLogLevelCount );
+  size_t nLevel = 0;
+  for ( ; nLevel < esllSysLogLevelCount; ++nLevel )
+  {
+    const char * pszName = s_krgpszNames[ nLevel ];
+    if ( ( strlen( pszName ) == _stLen ) && std::equal( _pcName, _pcName + _stLen, pszName, []( char _c, char _cName ) { return tolower( (unsigned char)_c ) == _cName; } ) )
+      break;
+  }
+  VerifyThrowSz( nLevel < esllSysLogLevelCount, "Unknown log level [%.*s].", int( _stLen ), _pcName );
+  return ESysLogLevel( nLevel );
+}
+// Parse the entire specification before changing anything so that a bad specification leaves the levels as they were.
+inline void
+_SysLogLevelFilter::SetLevels( const char * _pszLevels )
+{
+  ESysLogLevel esllThreshold = esllInfo;
+  _tyRgOverrides rgOverrides;
+  for ( const char * pcCur = _pszLevels; !!pcCur && !!*pcCur; )
+  {
+    const char * pcEnd = strchr( pcCur, ',' );
+    if ( !pcEnd )
+      pcEnd = pcCur + strlen( pcCur );
+    std::string_view svItem( pcCur, pcEnd - pcCur );
+    pcCur = *pcEnd ? pcEnd + 1 : pcEnd;
+    auto lambdaTrim = []( std::string_view _sv )
+    {
+      while ( !_sv.empty() && isspace( (unsigned char)_sv.front() ) )
+        _sv.remove_prefix( 1 );
+      while ( !_sv.empty() && isspace( (unsigned char)_sv.back() ) )
+        _sv.remove_suffix( 1 );
+      return _sv;
+    };
+    svItem = lambdaTrim( svItem );
+    if ( svItem.empty() )
+      continue;
+    size_t posEquals = svItem.find( '=' );
+    if ( std::string_view::npos == posEquals )
+      esllThreshold = EsllFromName( svItem.data(), svItem.length() );
+    else
+    {
+      std::string_view svKey = lambdaTrim( svItem.substr( 0, posEquals ) );
+      std::string_view svLevel = lambdaTrim( svItem.substr( posEquals + 1 ) );
+      VerifyThrowSz( !svKey.empty(), "Empty file or module name in log levels [%s].", _pszLevels );
+      rgOverrides.emplace_back( std::string( svKey ), EsllFromName( svLevel.data(), svLevel.length() ) );
+    }
+  }
+  std::lock_guard< std::mutex > lock( s_mtxOverrides );
+  s_esllThreshold = esllThreshold;
+  s_rgOverrides.swap( rgOverrides );
+  _UpdateLevelRange();
+}
+// The caller holds s_mtxOverrides.
+inline void
+_SysLogLevelFilter::_UpdateLevelRange()
+{
+  ESysLogLevel esllMin = s_esllThreshold, esllMax = s_esllThreshold;
+  for ( auto const & rpr : s_rgOverrides )
+  {
+    esllMin = (std::min)( esllMin, rpr.second );
+    esllMax = (std::max)( esllMax, rpr.second );
+  }
+  ++s_nGeneration;
+  s_nLevelRange.store( uint16_t( esllMin | ( esllMax << 8 ) ), std::memory_order_relaxed );
+}
+inline ESysLogLevel
+_SysLogLevelFilter::_EsllThreshold( const char * _pszFile )
+{
+  _ThreadCache & rtc = s_tls_tcThresholds;
+  uint32_t nGeneration = s_nGeneration.load( std::memory_order_acquire );
+  if ( rtc.m_nGeneration != nGeneration )
+  {
+    rtc.m_mapThresholds.clear();
+    rtc.m_nGeneration = nGeneration;
+  }
+  std::unordered_map< const char *, ESysLogLevel >::const_iterator it = rtc.m_mapThresholds.find( _pszFile );
+  if ( rtc.m_mapThresholds.end() != it )
+    return it->second;
+  ESysLogLevel esll;
+  { // B
+    std::lock_guard< std::mutex > lock( s_mtxOverrides );
+    esll = _EsllMatchOverrides( _pszFile );
+    nGeneration = s_nGeneration.load( std::memory_order_relaxed );
+  } // EB
+  if ( rtc.m_nGeneration == nGeneration ) // Don't cache a result from a newer generation under an older one.
+    rtc.m_mapThresholds.emplace( _pszFile, esll );
+  return esll;
+}
+// The caller holds s_mtxOverrides.
+inline ESysLogLevel
+_SysLogLevelFilter::_EsllMatchOverrides( const char * _pszFile )
+{
+  std::string_view svFile( _pszFile );
+  ESysLogLevel esll = s_esllThreshold;
+  size_t stLenMatch = 0;
+  for ( auto const & rpr : s_rgOverrides )
+  {
+    std::string const & rstrKey = rpr.first;
+    if ( rstrKey.length() <= stLenMatch || rstrKey.length() > svFile.length() )
+      continue;
+    bool fMatch;
+    if ( _FIsSeparator( rstrKey.back() ) )
+    { // Module: the key must appear at the start of the path or after a separator.
+      fMatch = false;
+      for ( size_t pos = svFile.find( rstrKey ); !fMatch && ( std::string_view::npos != pos ); pos = svFile.find( rstrKey, pos + 1 ) )
+        fMatch = !pos || _FIsSeparator( svFile[ pos - 1 ] );
+    }
+    else
+    { // File: the path must end with the key at a separator.
+      size_t pos = svFile.length() - rstrKey.length();
+      fMatch = ( svFile.substr( pos ) == rstrKey ) && ( !pos || _FIsSeparator( svFile[ pos - 1 ] ) );
+    }
+    if ( fMatch )
+    {
+      esll = rpr.second;
+      stLenMatch = rstrKey.length();
+    }
+  }
+  return esll;
 }
 
 // This failure mimicks the ANSI standard failure: Print a message (in our case to the syslog and potentially as well to the screen) and then flush the log file